@@ -0,0 +1,127 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Scanner.h"
+#include "../Server/BigInt.h"
+
+/**
+ * @file BigIntBenchmark.c
+ * @brief Microbenchmark of the products and the decimal conversions of BigInt.c.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Multiplies factors of growing size with the schoolbook method alone and with
+ * one step of Karatsuba's over schoolbook halves: BIGINT_KARATSUBA is the size
+ * from which the step pays. Then times the decimal conversions of a number as
+ * large as a request can hold. Both products must be equal, and the text of every number
+ * must read back to the same number.
+ */
+
+#define TIME_PER_SIZE 0.2       // Seconds spent on each measurement
+
+static const int sizes[] = { 8, 16, 24, 32, 40, 48, 64, 96, 128 };
+
+static double elapsedSeconds(const struct timespec *start);
+static void randomBigInt(struct BigInt *number, int limbs);
+static double timeProducts(const struct BigInt *a, const struct BigInt *b, struct BigInt *product);
+
+/**
+ * @brief Main function of the benchmark.
+ *
+ * @return 0 if every result is right, 1 otherwise.
+ */
+int main(void) {
+    static char text[4 * BUFFERSIZE];
+    struct BigInt a, b, schoolbook, karatsuba, parsed;
+    int failures = 0;
+    struct timespec start;
+
+    srand(1);
+    printf("%-7s %14s %14s %8s\n", "limbs", "schoolbook ns", "one step ns", "speedup");
+    for (int i = 0; i < (int) (sizeof(sizes) / sizeof(sizes[0])); i++) {
+        randomBigInt(&a, sizes[i]);
+        randomBigInt(&b, sizes[i]);
+        setKaratsubaThreshold(BIGINT_LIMBS + 1);
+        double slow = timeProducts(&a, &b, &schoolbook);
+        setKaratsubaThreshold(sizes[i]);
+        double fast = timeProducts(&a, &b, &karatsuba);
+        printf("%-7d %14.0f %14.0f %7.2fx\n", sizes[i], slow * 1e9, fast * 1e9, slow / fast);
+        if (schoolbook.length != karatsuba.length
+            || memcmp(schoolbook.limbs, karatsuba.limbs, schoolbook.length * sizeof(uint32_t)) != 0) {
+            printf("The products of %d limbs differ\n", sizes[i]);
+            failures++;
+        }
+    }
+
+    // Decimal conversions of a number of BUFFERSIZE digits
+    randomBigInt(&a, BUFFERSIZE * 10 / 3 / 32);
+    int length = formatBigInt(&a, text, sizeof(text));
+    long rounds = 0;
+    timespec_get(&start, TIME_UTC);
+    do {
+        for (int j = 0; j < 100; j++, rounds++) {
+            length = formatBigInt(&a, text, sizeof(text));
+        }
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    printf("format %d digits: %.0f ns\n", length, elapsedSeconds(&start) * 1e9 / (double) rounds);
+    rounds = 0;
+    timespec_get(&start, TIME_UTC);
+    do {
+        for (int j = 0; j < 100; j++, rounds++) {
+            parseBigInt(text, length, &parsed);
+        }
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    printf("parse  %d digits: %.0f ns\n", length, elapsedSeconds(&start) * 1e9 / (double) rounds);
+    if (parsed.length != a.length || memcmp(parsed.limbs, a.limbs, a.length * sizeof(uint32_t)) != 0) {
+        printf("%s does not read back to the same number\n", text);
+        failures++;
+    }
+    return failures > 0;
+}
+
+/**
+ * @brief Multiplies two numbers again and again for TIME_PER_SIZE seconds.
+ *
+ * @param a The first factor.
+ * @param b The second factor.
+ * @param product Receives the product.
+ * @return The time of one product in seconds.
+ */
+static double timeProducts(const struct BigInt *a, const struct BigInt *b, struct BigInt *product) {
+    struct timespec start;
+    long rounds = 0;
+
+    timespec_get(&start, TIME_UTC);
+    do {
+        for (int i = 0; i < 100; i++, rounds++) {
+            multBigInt(a, b, product);
+        }
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    return elapsedSeconds(&start) / (double) rounds;
+}
+
+/**
+ * @brief Fills a number with random limbs.
+ *
+ * @param number The number.
+ * @param limbs The limbs of the number.
+ */
+static void randomBigInt(struct BigInt *number, int limbs) {
+    number->negative = 0;
+    number->length = limbs;
+    for (int i = 0; i < limbs; i++) {
+        number->limbs[i] = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+    }
+    number->limbs[limbs - 1] |= 1; // The top limb is never zero
+}
+
+/**
+ * @brief Measures the time elapsed since a start time.
+ *
+ * @param start The start time.
+ * @return The elapsed time in seconds.
+ */
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -0,0 +1,317 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Vector.h"
+#include "../Server/Matrix.h"
+
+#include <float.h>      // DBL_EPSILON
+#include <math.h>       // fabs(), fabsl(), sqrtl()
+
+/**
+ * @file MatrixBenchmark.c
+ * @brief Microbenchmark of the linear algebra of Matrix.c.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Multiplies square matrices from the L1 cache up to main memory, with the plain
+ * triple loop as the baseline, then with the kernels of every instruction set in
+ * one thread and with the best one split among threads, and prints the GFLOP/s
+ * (two floating point operations per multiply-add). The dot product, axpy and the
+ * norm are measured the same way on arrays. Every kernel must match the plain
+ * loops within the roundings the order of the operations can change, on the
+ * timed sizes and on shapes that leave partial tiles and blocks on every edge.
+ */
+
+#define TIME_PER_SIZE 0.2       // Seconds spent on each measurement
+
+static const int matrixSizes[] = { 64, 128, 256, 512, 1024 };
+static const int vectorSizes[] = { 1024, 65536, 1 << 20 };
+static const int shapes[][3] = {    // Rows, depth and columns of the shapes only checked
+    { 1, 1, 1 }, { 5, 3, 7 }, { 7, 300, 17 }, { 97, 257, 1031 }, { 100, 75, 130 }, { 200, 600, 9 }
+};
+
+static double *a, *b, *c, *expected;
+static double *x, *y;
+
+static double elapsedSeconds(const struct timespec *start);
+static double timeProduct(int rows, int depth, int columns, int plain);
+static double timeVector(char operation, int count, int plain, double *result);
+static void multiplyPlain(int rows, int depth, int columns, double *product);
+static int checkProduct(const char *name, int rows, int depth, int columns);
+static int checkVector(const char *name, char operation, int count, double result);
+static void fillRandom(double *values, int count);
+
+/**
+ * @brief Main function of the benchmark.
+ *
+ * @return 0 if every kernel matches the plain loops, 1 otherwise.
+ */
+int main(void) {
+    int largestMatrix = matrixSizes[sizeof(matrixSizes) / sizeof(matrixSizes[0]) - 1];
+    int largestVector = vectorSizes[sizeof(vectorSizes) / sizeof(vectorSizes[0]) - 1];
+    int best = setVectorLevel(VECTOR_AVX512);
+    int failures = 0;
+
+    // The shapes only checked are smaller than the largest matrix
+    a = malloc(sizeof(double) * largestMatrix * largestMatrix);
+    b = malloc(sizeof(double) * largestMatrix * largestMatrix);
+    c = malloc(sizeof(double) * largestMatrix * largestMatrix);
+    expected = malloc(sizeof(double) * largestMatrix * largestMatrix);
+    x = malloc(sizeof(double) * largestVector);
+    y = malloc(sizeof(double) * largestVector);
+    if (a == NULL || b == NULL || c == NULL || expected == NULL || x == NULL || y == NULL) {
+        printf("Not enough memory for %d x %d matrices\n", largestMatrix, largestMatrix);
+        return 1;
+    }
+    srand(1);
+    fillRandom(a, largestMatrix * largestMatrix);
+    fillRandom(b, largestMatrix * largestMatrix);
+    fillRandom(x, largestVector);
+    fillRandom(y, largestVector);
+
+    setMatrixThreads(1);
+    for (int s = 0; s < (int) (sizeof(shapes) / sizeof(shapes[0])); s++) {
+        multiplyPlain(shapes[s][0], shapes[s][1], shapes[s][2], expected);
+        for (int level = VECTOR_SCALAR; level <= best; level++) {
+            setVectorLevel(level);
+            multMatrices(a, b, c, shapes[s][0], shapes[s][1], shapes[s][2]);
+            failures += checkProduct(getVectorLevelName(level), shapes[s][0], shapes[s][1], shapes[s][2]);
+        }
+    }
+
+    printf("%-9s %-8s %-8s %10s\n", "matrix", "kernel", "threads", "GFLOP/s");
+    for (int s = 0; s < (int) (sizeof(matrixSizes) / sizeof(matrixSizes[0])); s++) {
+        int size = matrixSizes[s];
+        double flops = 2.0 * size * size * size;
+
+        double plain = timeProduct(size, size, size, 1);
+        printf("%-9d %-8s %-8d %10.2f\n", size, "plain", 1, flops / plain / 1e9);
+
+        setMatrixThreads(1);
+        for (int level = VECTOR_SCALAR; level <= best; level++) {
+            setVectorLevel(level);
+            double seconds = timeProduct(size, size, size, 0);
+            failures += checkProduct(getVectorLevelName(level), size, size, size);
+            printf("%-9d %-8s %-8d %10.2f\n", size, getVectorLevelName(level), 1, flops / seconds / 1e9);
+        }
+
+        setMatrixThreads(0);
+        if ((long long) size * size * size >= 2LL * MATRIX_PARALLEL) {
+            double seconds = timeProduct(size, size, size, 0);
+            failures += checkProduct("threads", size, size, size);
+            printf("%-9d %-8s %-8s %10.2f\n", size, getVectorLevelName(best), "all", flops / seconds / 1e9);
+        }
+    }
+
+    static const char operations[] = { 'D', 'A', 'N' };
+    static const char *names[] = { "dot", "axpy", "norm" };
+    printf("\n%-9s %-8s %-8s %10s\n", "vector", "kernel", "op", "GFLOP/s");
+    for (int s = 0; s < (int) (sizeof(vectorSizes) / sizeof(vectorSizes[0])); s++) {
+        int count = vectorSizes[s];
+        for (int o = 0; o < (int) sizeof(operations); o++) {
+            double result;
+            double plain = timeVector(operations[o], count, 1, &result);
+            printf("%-9d %-8s %-8s %10.2f\n", count, "plain", names[o], 2.0 * count / plain / 1e9);
+            for (int level = VECTOR_SCALAR; level <= best; level++) {
+                setVectorLevel(level);
+                double seconds = timeVector(operations[o], count, 0, &result);
+                failures += checkVector(getVectorLevelName(level), operations[o], count, result);
+                printf("%-9d %-8s %-8s %10.2f\n", count, getVectorLevelName(level), names[o],
+                       2.0 * count / seconds / 1e9);
+            }
+        }
+    }
+    return failures > 0;
+}
+
+/**
+ * @brief Multiplies the first factors again and again for TIME_PER_SIZE seconds.
+ *
+ * The plain loops leave their product in expected, multMatrices() in c.
+ *
+ * @param rows The rows of the product.
+ * @param depth The columns of the first factor.
+ * @param columns The columns of the product.
+ * @param plain 1 for the plain loops, 0 for multMatrices().
+ * @return The time of one product in seconds.
+ */
+static double timeProduct(int rows, int depth, int columns, int plain) {
+    struct timespec start;
+    long rounds = 0;
+
+    timespec_get(&start, TIME_UTC);
+    do {
+        if (plain) {
+            multiplyPlain(rows, depth, columns, expected);
+        } else {
+            multMatrices(a, b, c, rows, depth, columns);
+        }
+        rounds++;
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    return elapsedSeconds(&start) / (double) rounds;
+}
+
+/**
+ * @brief Runs an operation on the first elements of x and y for TIME_PER_SIZE seconds.
+ *
+ * axpy adds a tiny multiple of x to y at every round, so y barely changes and the
+ * result is the first element of y after one round.
+ *
+ * @param operation 'D' for the dot product, 'A' for axpy, 'N' for the norm.
+ * @param count The number of elements.
+ * @param plain 1 for a plain loop, 0 for the functions of Matrix.h.
+ * @param result Receives the result, or what checkVector() compares for axpy.
+ * @return The time of one operation in seconds.
+ */
+static double timeVector(char operation, int count, int plain, double *result) {
+    const double multiplier = 1e-12;
+    struct timespec start;
+    long rounds = 0;
+    double before = y[0];
+
+    timespec_get(&start, TIME_UTC);
+    do {
+        double sum = 0;
+        switch (operation) {
+            case 'D':
+                if (plain) {
+                    for (int i = 0; i < count; i++) {
+                        sum += x[i] * y[i];
+                    }
+                } else {
+                    sum = dotVectors(x, y, count);
+                }
+                break;
+            case 'A':
+                if (plain) {
+                    for (int i = 0; i < count; i++) {
+                        y[i] += multiplier * x[i];
+                    }
+                } else {
+                    axpyVectors(multiplier, x, y, count);
+                }
+                sum = rounds == 0 ? y[0] - before : 0;
+                break;
+            default:
+                if (plain) {
+                    for (int i = 0; i < count; i++) {
+                        sum += x[i] * x[i];
+                    }
+                    sum = sqrt(sum);
+                } else {
+                    sum = normVector(x, count);
+                }
+                break;
+        }
+        if (rounds == 0) {
+            *result = sum;
+        }
+        rounds++;
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    return elapsedSeconds(&start) / (double) rounds;
+}
+
+/**
+ * @brief Multiplies the first factors with the plain triple loop.
+ *
+ * @param rows The rows of the product.
+ * @param depth The columns of the first factor.
+ * @param columns The columns of the product.
+ * @param product Receives the product.
+ */
+static void multiplyPlain(int rows, int depth, int columns, double *product) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < columns; j++) {
+            product[i * columns + j] = 0;
+        }
+        for (int p = 0; p < depth; p++) {
+            double factor = a[i * depth + p];
+            for (int j = 0; j < columns; j++) {
+                product[i * columns + j] += factor * b[p * columns + j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compares the product of multMatrices() with the one of the plain loops.
+ *
+ * The elements of the factors are within [-1, 1], so every sum may differ by
+ * depth roundings of at most depth.
+ *
+ * @param name The name of the kernel, for the messages.
+ * @param rows The rows of the product.
+ * @param depth The columns of the first factor.
+ * @param columns The columns of the product.
+ * @return 0 if they match, 1 otherwise.
+ */
+static int checkProduct(const char *name, int rows, int depth, int columns) {
+    double tolerance = 2.0 * depth * depth * DBL_EPSILON;
+
+    for (int i = 0; i < rows * columns; i++) {
+        if (fabs(c[i] - expected[i]) > tolerance) {
+            printf("%s: element %d of the %d x %d x %d product is %.17g instead of %.17g\n", name, i, rows, depth,
+                   columns, c[i], expected[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Compares the result of an operation with a reference computed in long double.
+ *
+ * @param name The name of the kernel, for the messages.
+ * @param operation 'D' for the dot product, 'A' for axpy, 'N' for the norm.
+ * @param count The number of elements.
+ * @param result The result of the operation.
+ * @return 0 if they match, 1 otherwise.
+ */
+static int checkVector(const char *name, char operation, int count, double result) {
+    long double reference = 0, magnitude = 0, tolerance;
+
+    if (operation == 'A') {
+        // The change of the first element is the multiple of x[0], rounded in y[0]
+        reference = 1e-12L * x[0];
+        tolerance = 2 * DBL_EPSILON * fabs(y[0]);
+    } else {
+        for (int i = 0; i < count; i++) {
+            long double factor = operation == 'D' ? y[i] : x[i];
+            reference += (long double) x[i] * factor;
+            magnitude += fabsl((long double) x[i] * factor);
+        }
+        tolerance = count * DBL_EPSILON * magnitude;
+        if (operation == 'N') {
+            reference = sqrtl(reference);
+            tolerance = count * DBL_EPSILON * reference;
+        }
+    }
+    if (fabsl(result - reference) > tolerance) {
+        printf("%s: the %c of %d elements is %.17g instead of %.17Lg\n", name, operation, count, result, reference);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Fills an array with values uniform within [-1, 1].
+ *
+ * @param values The array.
+ * @param count The number of elements.
+ */
+static void fillRandom(double *values, int count) {
+    for (int i = 0; i < count; i++) {
+        values[i] = 2.0 * rand() / RAND_MAX - 1.0;
+    }
+}
+
+/**
+ * @brief Measures the time elapsed since a start time.
+ *
+ * @param start The start time.
+ * @return The elapsed time in seconds.
+ */
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
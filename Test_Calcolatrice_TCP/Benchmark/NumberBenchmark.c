@@ -0,0 +1,174 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Scanner.h"
+#include "../Server/Number.h"
+
+/**
+ * @file NumberBenchmark.c
+ * @brief Microbenchmark of the number conversions against the C library.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Reads the same operands with strtod() and scanNumber(), writes the same results
+ * with snprintf("%.2f") and formatFixed(), and with snprintf("%.17g") and
+ * formatShortest(), and integer results with snprintf("%.2f") and formatInteger(),
+ * then prints the time per number. The outputs are compared too: the parsed
+ * doubles and the fixed and integer texts must be identical, the shortest texts
+ * must read back to the same doubles.
+ */
+
+#define ROUNDS 2000000          // Numbers converted by each implementation
+
+static const char *operands[] = {
+    "1", "2500", "-7", "123456", "0.5", "3.14", "-1234.5678", "99999.99",
+    "3.141592653589793", "6.02214076e23", "1.7976931348623157e308", "2.2250738585072014e-308"
+};
+
+static const double results[] = {
+    3, -1500, 408, 12, 777777, -4, 9999800001.0, 0.3333333333333333,
+    2.675, 1.005, -0.125, 1234567.891
+};
+
+static const int64_t integers[] = {
+    3, -1500, 408, 12, 777777, -4, 9999800001LL, 0, 100, -65536, 4294967296LL, 9007199254740992LL
+};
+
+static double elapsedSeconds(const struct timespec *start);
+static void report(const char *name, const double *seconds);
+
+/**
+ * @brief Main function of the benchmark.
+ *
+ * @return 0 if every conversion matches the C library, 1 otherwise.
+ */
+int main(void) {
+    int countOperands = (int) (sizeof(operands) / sizeof(operands[0]));
+    int countResults = (int) (sizeof(results) / sizeof(results[0]));
+    int countIntegers = (int) (sizeof(integers) / sizeof(integers[0]));
+    int lengths[sizeof(operands) / sizeof(operands[0])];
+    char texts[2][NUMBER_SIZE];
+    double sums[2] = { 0, 0 };
+    double seconds[2];
+    int failures = 0;
+    struct timespec start;
+
+    for (int i = 0; i < countOperands; i++) {
+        lengths[i] = (int) strlen(operands[i]);
+    }
+
+    // Parsing
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        sums[0] += strtod(operands[round % countOperands], NULL);
+    }
+    seconds[0] = elapsedSeconds(&start);
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        double value;
+        scanNumber(operands[round % countOperands], lengths[round % countOperands], &value);
+        sums[1] += value;
+    }
+    seconds[1] = elapsedSeconds(&start);
+    report("parse  strtod / scanNumber", seconds);
+    for (int i = 0; i < countOperands; i++) {
+        double value;
+        scanNumber(operands[i], lengths[i], &value);
+        if (value != strtod(operands[i], NULL)) {
+            printf("Different value for %s\n", operands[i]);
+            failures++;
+        }
+    }
+
+    // Fixed precision
+    int lengthSums[2] = { 0, 0 };
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        lengthSums[0] += snprintf(texts[0], NUMBER_SIZE, "%.2f", results[round % countResults]);
+    }
+    seconds[0] = elapsedSeconds(&start);
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        lengthSums[1] += formatFixed(texts[1], NUMBER_SIZE, results[round % countResults], 2);
+    }
+    seconds[1] = elapsedSeconds(&start);
+    report("fixed  snprintf(%.2f) / formatFixed", seconds);
+    for (int i = 0; i < countResults; i++) {
+        snprintf(texts[0], NUMBER_SIZE, "%.2f", results[i]);
+        formatFixed(texts[1], NUMBER_SIZE, results[i], 2);
+        if (strcmp(texts[0], texts[1]) != 0) {
+            printf("Different text for %.17g: %s and %s\n", results[i], texts[0], texts[1]);
+            failures++;
+        }
+    }
+
+    // Shortest round trip
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        lengthSums[0] += snprintf(texts[0], NUMBER_SIZE, "%.17g", results[round % countResults]);
+    }
+    seconds[0] = elapsedSeconds(&start);
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        lengthSums[1] += formatShortest(texts[1], results[round % countResults]);
+    }
+    seconds[1] = elapsedSeconds(&start);
+    report("format snprintf(%.17g) / formatShortest", seconds);
+    for (int i = 0; i < countResults; i++) {
+        formatShortest(texts[1], results[i]);
+        if (strtod(texts[1], NULL) != results[i]) {
+            printf("%s does not read back to %.17g\n", texts[1], results[i]);
+            failures++;
+        }
+    }
+
+    // Integer results
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        lengthSums[0] += snprintf(texts[0], NUMBER_SIZE, "%.2f", (double) integers[round % countIntegers]);
+    }
+    seconds[0] = elapsedSeconds(&start);
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        lengthSums[1] += formatInteger(texts[1], NUMBER_SIZE, integers[round % countIntegers], 2);
+    }
+    seconds[1] = elapsedSeconds(&start);
+    report("integer snprintf(%.2f) / formatInteger", seconds);
+    for (int i = 0; i < countIntegers; i++) {
+        snprintf(texts[0], NUMBER_SIZE, "%.2f", (double) integers[i]);
+        formatInteger(texts[1], NUMBER_SIZE, integers[i], 2);
+        if (strcmp(texts[0], texts[1]) != 0) {
+            printf("Different text for %lld: %s and %s\n", (long long) integers[i], texts[0], texts[1]);
+            failures++;
+        }
+    }
+
+    // Keeps the loops from being optimized away
+    if (sums[0] != sums[1] || lengthSums[0] < 0 || lengthSums[1] < 0) {
+        printf("The two parsers read different values.\n");
+        failures++;
+    }
+    return failures > 0;
+}
+
+/**
+ * @brief Prints the time per number of both implementations.
+ *
+ * @param name The conversions compared.
+ * @param seconds The time taken by the C library and by the new code.
+ */
+static void report(const char *name, const double *seconds) {
+    printf("%-40s %6.1f / %6.1f ns/number (%.1fx)\n", name,
+           seconds[0] * 1e9 / ROUNDS, seconds[1] * 1e9 / ROUNDS, seconds[0] / seconds[1]);
+}
+
+/**
+ * @brief Measures the time elapsed since a start time.
+ *
+ * @param start The start time.
+ * @return The elapsed time in seconds.
+ */
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -0,0 +1,131 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Scanner.h"
+
+/**
+ * @file ScannerBenchmark.c
+ * @brief Microbenchmark of the scanner of the text requests.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Parses the same requests with the previous strtok_r() and sscanf() code, kept
+ * here as the reference, and with parseOperation(), then prints the time per request.
+ */
+
+#define ROUNDS 2000000          // Requests parsed by each implementation
+
+static const char *requests[] = {
+    "+ 1 2", "- 1000 2500", "* 12 34", "/ 144 12", "+ 123456 654321",
+    "- -7 3", "* 99999 99999", "/ 1 3"
+};
+
+static int legacyParse(const char *request, char *operator, double *operands);
+static int scannerParse(const char *request, int length, char *operator, double *operands);
+static double elapsedSeconds(const struct timespec *start);
+
+/**
+ * @brief Main function of the benchmark.
+ *
+ * @return 0 if both implementations read the same operands, 1 otherwise.
+ */
+int main(void) {
+    int count = (int) (sizeof(requests) / sizeof(requests[0]));
+    int lengths[sizeof(requests) / sizeof(requests[0])];
+    double checksums[2] = { 0, 0 };
+    double seconds[2];
+    char operator;
+    double operands[MAXOPERANDS];
+
+    for (int i = 0; i < count; i++) {
+        lengths[i] = (int) strlen(requests[i]);
+    }
+
+    struct timespec start;
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        int i = round % count;
+        int numOperands = legacyParse(requests[i], &operator, operands);
+        checksums[0] += operator + numOperands + operands[0] + operands[1];
+    }
+    seconds[0] = elapsedSeconds(&start);
+
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        int i = round % count;
+        int numOperands = scannerParse(requests[i], lengths[i], &operator, operands);
+        checksums[1] += operator + numOperands + operands[0] + operands[1];
+    }
+    seconds[1] = elapsedSeconds(&start);
+
+    printf("strtok_r + sscanf: %6.1f ns/request\n", seconds[0] * 1e9 / ROUNDS);
+    printf("scanner:           %6.1f ns/request (%.1fx)\n", seconds[1] * 1e9 / ROUNDS, seconds[0] / seconds[1]);
+    if (checksums[0] != checksums[1]) {
+        printf("The two implementations read different operands.\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses a request as processData() did before the scanner.
+ *
+ * @param request The NUL-terminated request.
+ * @param operator Receives the operator.
+ * @param operands Receives the operands.
+ * @return The number of operands, -1 on an invalid operand.
+ */
+static int legacyParse(const char *request, char *operator, double *operands) {
+    char msg[BUFFERSIZE];
+    int numOperands = 0;
+
+    // The tokenizer writes to the request, so it works on a copy
+    strcpy(msg, request);
+    *operator = msg[0];
+
+    char *savePointer = NULL;
+    char *token = strtok_r(msg + 2, " ", &savePointer);
+    while (token != NULL && numOperands < MAXOPERANDS) {
+        if (sscanf(token, "%lf", &operands[numOperands]) != 1) {
+            return -1;
+        }
+        numOperands++;
+        token = strtok_r(NULL, " ", &savePointer);
+    }
+    return numOperands;
+}
+
+/**
+ * @brief Parses a request with the scanner.
+ *
+ * @param request The request.
+ * @param length The length of the request.
+ * @param operator Receives the operator.
+ * @param operands Receives the operands.
+ * @return The number of operands, -1 on an invalid operand.
+ */
+static int scannerParse(const char *request, int length, char *operator, double *operands) {
+    struct Scanner scanner;
+    struct Operation operation;
+
+    initScanner(&scanner, request, length);
+    if (parseOperation(&scanner, &operation) != CALC_OK) {
+        return -1;
+    }
+    *operator = operation.operator;
+    for (int i = 0; i < operation.numOperands; i++) {
+        operands[i] = operation.operands[i];
+    }
+    return operation.numOperands;
+}
+
+/**
+ * @brief Returns the seconds elapsed since a time.
+ *
+ * @param start The time.
+ * @return The elapsed seconds.
+ */
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
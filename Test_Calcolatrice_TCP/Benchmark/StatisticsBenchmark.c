@@ -0,0 +1,257 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Vector.h"
+#include "../Server/Statistics.h"
+
+#include <math.h>       // fabsl()
+
+/**
+ * @file StatisticsBenchmark.c
+ * @brief Microbenchmark of the reductions and the prefix sums of Statistics.c.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Summarizes and scans arrays from the L1 cache up to main memory, with a plain
+ * loop that sums the values and their squares as the baseline, then with the
+ * kernels of every instruction set in one thread and with the best one split
+ * among threads, and prints the values per second. The values are 1e8 plus a
+ * uniform noise, where the plain sums lose digits and the variance from the sum
+ * of the squares cancels altogether. Every kernel must match a reference computed
+ * in long double within a few roundings.
+ */
+
+#define TIME_PER_SIZE 0.2       // Seconds spent on each measurement
+#define OFFSET 1e8              // Distance of the values from zero
+
+static const int sizes[] = { 1024, 65536, 1 << 20, 1 << 22 };
+
+static double *values;
+static double *sums;
+static long double *expectedSums;   // Reference prefix sums
+static long double *magnitudes;     // Prefix sums of the absolute values, which the errors grow with
+
+static double elapsedSeconds(const struct timespec *start);
+static double timeFold(int count, struct Statistics *result);
+static double timeScan(int count, struct Statistics *result);
+static double timePlain(int count, double *sum, double *variance);
+static void computeReference(int count, struct Statistics *reference);
+static int check(const char *name, int count, const struct Statistics *result,
+                 const struct Statistics *reference, int scanned);
+
+/**
+ * @brief Main function of the benchmark.
+ *
+ * @return 0 if every kernel matches the reference, 1 otherwise.
+ */
+int main(void) {
+    int largest = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    int best = setVectorLevel(VECTOR_AVX512);
+    int failures = 0;
+
+    values = malloc(largest * sizeof(double));
+    sums = malloc(largest * sizeof(double));
+    expectedSums = malloc(largest * sizeof(long double));
+    magnitudes = malloc(largest * sizeof(long double));
+    if (values == NULL || sums == NULL || expectedSums == NULL || magnitudes == NULL) {
+        printf("Not enough memory for %d values\n", largest);
+        return 1;
+    }
+    srand(1);
+    for (int i = 0; i < largest; i++) {
+        values[i] = OFFSET + 2.0 * rand() / RAND_MAX - 1.0;
+    }
+
+    printf("%-9s %-8s %-8s %12s %12s\n", "values", "kernel", "threads", "fold Mv/s", "scan Mv/s");
+    for (int s = 0; s < (int) (sizeof(sizes) / sizeof(sizes[0])); s++) {
+        int count = sizes[s];
+        struct Statistics reference, result;
+        double plainSum, plainVariance;
+        computeReference(count, &reference);
+
+        double plain = timePlain(count, &plainSum, &plainVariance);
+        printf("%-9d %-8s %-8d %12.0f %12s\n", count, "plain", 1, count / plain / 1e6, "-");
+
+        setStatisticsThreads(1);
+        for (int level = VECTOR_SCALAR; level <= best; level++) {
+            setVectorLevel(level);
+            double fold = timeFold(count, &result);
+            failures += check(getVectorLevelName(level), count, &result, &reference, 0);
+            double scan = timeScan(count, &result);
+            failures += check(getVectorLevelName(level), count, &result, &reference, 1);
+            printf("%-9d %-8s %-8d %12.0f %12.0f\n", count, getVectorLevelName(level), 1,
+                   count / fold / 1e6, count / scan / 1e6);
+        }
+
+        setStatisticsThreads(0);
+        if (count >= 2 * STATISTICS_PARALLEL) {
+            double fold = timeFold(count, &result);
+            failures += check("threads", count, &result, &reference, 0);
+            double scan = timeScan(count, &result);
+            failures += check("threads", count, &result, &reference, 1);
+            printf("%-9d %-8s %-8s %12.0f %12.0f\n", count, getVectorLevelName(best), "all",
+                   count / fold / 1e6, count / scan / 1e6);
+        }
+
+        if (count == largest) {
+            double sum = (double) (reference.sum + (long double) reference.error);
+            printf("\nerror of the sum of %d values: plain %.3g, compensated %.3g\n", count,
+                   plainSum - sum, getStatisticsSum(&result) - sum);
+            printf("variance %.6f: from the squares %.6g, Welford %.6f\n", getStatisticsVariance(&reference),
+                   plainVariance, getStatisticsVariance(&result));
+        }
+    }
+    return failures > 0;
+}
+
+/**
+ * @brief Summarizes the first values again and again for TIME_PER_SIZE seconds.
+ *
+ * @param count The number of values.
+ * @param result Receives the summary.
+ * @return The time of one summary in seconds.
+ */
+static double timeFold(int count, struct Statistics *result) {
+    struct timespec start;
+    long rounds = 0;
+
+    timespec_get(&start, TIME_UTC);
+    do {
+        initStatistics(result);
+        foldStatistics(result, values, count);
+        rounds++;
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    return elapsedSeconds(&start) / (double) rounds;
+}
+
+/**
+ * @brief Scans the first values again and again for TIME_PER_SIZE seconds.
+ *
+ * @param count The number of values.
+ * @param result Receives the summary.
+ * @return The time of one scan in seconds.
+ */
+static double timeScan(int count, struct Statistics *result) {
+    struct timespec start;
+    long rounds = 0;
+
+    timespec_get(&start, TIME_UTC);
+    do {
+        initStatistics(result);
+        scanStatistics(result, values, sums, count);
+        rounds++;
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    return elapsedSeconds(&start) / (double) rounds;
+}
+
+/**
+ * @brief Sums the values and their squares with a plain loop for TIME_PER_SIZE seconds.
+ *
+ * @param count The number of values.
+ * @param sum Receives the sum.
+ * @param variance Receives the variance from the mean of the squares minus the squared mean.
+ * @return The time of one pass in seconds.
+ */
+static double timePlain(int count, double *sum, double *variance) {
+    struct timespec start;
+    long rounds = 0;
+    double squares;
+
+    timespec_get(&start, TIME_UTC);
+    do {
+        *sum = 0;
+        squares = 0;
+        for (int i = 0; i < count; i++) {
+            *sum += values[i];
+            squares += values[i] * values[i];
+        }
+        rounds++;
+    } while (elapsedSeconds(&start) < TIME_PER_SIZE);
+    double mean = *sum / count;
+    *variance = squares / count - mean * mean;
+    return elapsedSeconds(&start) / (double) rounds;
+}
+
+/**
+ * @brief Summarizes and scans the first values in long double.
+ *
+ * The values are positive, so the sum is never smaller than a value and its
+ * rounding is kept by Fast2Sum.
+ *
+ * @param count The number of values.
+ * @param reference Receives the summary, with the sum split into sum and error.
+ */
+static void computeReference(int count, struct Statistics *reference) {
+    long double sum = 0, error = 0, magnitude = 0, squares = 0;
+    initStatistics(reference);
+
+    for (int i = 0; i < count; i++) {
+        long double total = sum + values[i];
+        error += (sum - total) + values[i];
+        sum = total;
+        magnitude += values[i] < 0 ? -values[i] : values[i];
+        expectedSums[i] = sum + error;
+        magnitudes[i] = magnitude;
+        reference->min = values[i] < reference->min ? values[i] : reference->min;
+        reference->max = values[i] > reference->max ? values[i] : reference->max;
+    }
+    sum += error;
+    long double mean = sum / count;
+    for (int i = 0; i < count; i++) {
+        squares += (values[i] - mean) * (values[i] - mean);
+    }
+    reference->count = count;
+    reference->sum = (double) sum;
+    reference->error = (double) (sum - (long double) reference->sum);
+    reference->mean = (double) mean;
+    reference->squares = (double) squares;
+}
+
+/**
+ * @brief Compares a summary, and the prefix sums of a scan, with the reference.
+ *
+ * The sums may be off by a few roundings of the largest partial sum, the variance
+ * by a part in a million of the rounding of the squares of the values.
+ *
+ * @param name The name of the kernel, for the messages.
+ * @param count The number of values.
+ * @param result The summary.
+ * @param reference The reference summary.
+ * @param scanned 1 if the prefix sums were written.
+ * @return 0 if they match, 1 otherwise.
+ */
+static int check(const char *name, int count, const struct Statistics *result,
+                 const struct Statistics *reference, int scanned) {
+    const long double epsilon = 1.0L / (1LL << 52);
+    long double sum = (long double) reference->sum + reference->error;
+    long double variance = (long double) reference->squares / count;
+    long double varianceTolerance = 1e-6L * OFFSET * OFFSET * epsilon + 1e-12L * variance;
+
+    if (result->count != count || result->min != reference->min || result->max != reference->max
+        || fabsl(getStatisticsSum(result) - sum) > 4 * epsilon * magnitudes[count - 1]
+        || fabsl(getStatisticsMean(result) - (long double) reference->mean) > 4 * epsilon * OFFSET
+        || fabsl(getStatisticsVariance(result) - variance) > varianceTolerance) {
+        printf("%s: the summary of %d values is wrong (sum %.17g, mean %.17g, variance %.17g)\n", name, count,
+               getStatisticsSum(result), getStatisticsMean(result), getStatisticsVariance(result));
+        return 1;
+    }
+    for (int i = 0; scanned && i < count; i++) {
+        if (fabsl(sums[i] - expectedSums[i]) > 4 * epsilon * magnitudes[i]) {
+            printf("%s: the prefix sum %d of %d values is %.17g instead of %.17Lg\n", name, i, count,
+                   sums[i], expectedSums[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Measures the time elapsed since a start time.
+ *
+ * @param start The start time.
+ * @return The elapsed time in seconds.
+ */
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -0,0 +1,152 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Calculator.h"
+#include "../Server/Vector.h"
+
+/**
+ * @file VectorBenchmark.c
+ * @brief Microbenchmark of the vector kernels against the scalar functions.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Applies every operator to the same arrays with add(), sub(), mult() and
+ * division() called once per element, then with the kernels of every
+ * instruction set the processor supports, and prints the elements per second.
+ * The arrays fit in the L1 cache, so the loops measure the arithmetic rather
+ * than the memory. Every kernel must give the results of the scalar functions,
+ * and the division must flag exactly the zero divisors.
+ */
+
+#define ELEMENTS 1024           // Elements of every array
+#define ROUNDS 100000           // Passes over the arrays for every measurement
+
+static double a[ELEMENTS];
+static double b[ELEMENTS];
+static double expected[ELEMENTS];
+static double results[ELEMENTS];
+static unsigned char errors[ELEMENTS];
+
+static double elapsedSeconds(const struct timespec *start);
+static double runScalar(char operator);
+static double runVectors(char operator);
+static int check(char operator, int level);
+
+/**
+ * @brief Main function of the benchmark.
+ *
+ * @return 0 if every kernel matches the scalar functions, 1 otherwise.
+ */
+int main(void) {
+    const char operators[] = { '+', '-', '*', '/' };
+    int best = setVectorLevel(VECTOR_AVX512);
+    int failures = 0;
+
+    // Operands of every magnitude, with a zero divisor every 16 elements
+    srand(1);
+    for (int i = 0; i < ELEMENTS; i++) {
+        a[i] = ((double) rand() / RAND_MAX - 0.5) * 1e6;
+        b[i] = i % 16 == 5 ? 0.0 : ((double) rand() / RAND_MAX - 0.5) * 1e3;
+    }
+    b[ELEMENTS - 1] = -0.0;
+
+    printf("%-9s %-8s %12s %9s\n", "operator", "kernel", "Melements/s", "speedup");
+    for (int k = 0; k < (int) sizeof(operators); k++) {
+        double scalar = runScalar(operators[k]);
+        printf("%-9c %-8s %12.0f %9s\n", operators[k], "scalar()", ELEMENTS * (double) ROUNDS / scalar / 1e6, "1.0x");
+        for (int level = VECTOR_SCALAR; level <= best; level++) {
+            setVectorLevel(level);
+            double seconds = runVectors(operators[k]);
+            printf("%-9c %-8s %12.0f %8.1fx\n", operators[k], getVectorLevelName(level),
+                   ELEMENTS * (double) ROUNDS / seconds / 1e6, scalar / seconds);
+            failures += check(operators[k], level);
+        }
+    }
+    return failures > 0;
+}
+
+/**
+ * @brief Applies an operator to the arrays with the scalar functions of Calculator.c.
+ *
+ * @param operator The operator.
+ * @return The time taken in seconds.
+ */
+static double runScalar(char operator) {
+    struct timespec start;
+
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < ELEMENTS; i++) {
+            switch (operator) {
+                case '+':
+                    expected[i] = add(a[i], b[i]);
+                    break;
+                case '-':
+                    expected[i] = sub(a[i], b[i]);
+                    break;
+                case '*':
+                    expected[i] = mult(a[i], b[i]);
+                    break;
+                default:
+                    expected[i] = division(a[i], b[i]);
+                    break;
+            }
+        }
+    }
+    return elapsedSeconds(&start);
+}
+
+/**
+ * @brief Applies an operator to the arrays with the kernels of the selected level.
+ *
+ * @param operator The operator.
+ * @return The time taken in seconds.
+ */
+static double runVectors(char operator) {
+    struct timespec start;
+
+    timespec_get(&start, TIME_UTC);
+    for (int round = 0; round < ROUNDS; round++) {
+        calculateVectors(operator, a, b, results, errors, ELEMENTS);
+    }
+    return elapsedSeconds(&start);
+}
+
+/**
+ * @brief Compares the results of the last kernel run with the scalar functions.
+ *
+ * The odd counts check the elements the kernels leave after their last whole vector.
+ *
+ * @param operator The operator.
+ * @param level The VECTOR_ level of the kernel.
+ * @return The number of mismatches found.
+ */
+static int check(char operator, int level) {
+    int failures = 0;
+
+    for (int count = ELEMENTS - 7; count <= ELEMENTS; count++) {
+        memset(results, 0xFF, sizeof(results));
+        calculateVectors(operator, a, b, results, errors, count);
+        for (int i = 0; i < count; i++) {
+            int zero = operator == '/' && b[i] == 0;
+            if (memcmp(&results[i], &expected[i], sizeof(double)) != 0 || errors[i] != zero) {
+                printf("%s %c differs at %d of %d: %.17g instead of %.17g\n", getVectorLevelName(level),
+                       operator, i, count, results[i], expected[i]);
+                failures++;
+                break;
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Measures the time elapsed since a start time.
+ *
+ * @param start The start time.
+ * @return The elapsed time in seconds.
+ */
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -16,11 +16,25 @@
  * and receives data to and from the server until the server sends "Bye," and then
  * closes the connection.
  *
+ * Passing --framed sends every request as a length-prefixed frame, which also
+ * makes the server answer with frames; --binary additionally sends the single
+ * operations as binary frames. The welcome message is always a fixed block of
+ * BUFFERSIZE bytes.
+ *
  * @param argc The number of command-line arguments.
  * @param argv An array of command-line argument strings.
  * @return 0 upon successful execution.
  */
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--framed") == 0) {
+            framed = 1;
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            framed = 1;
+            binary = 1;
+        }
+    }
+
     // 0) Initialize the WSA library in case we are on Windows
     checkWindowDevice();
 
@@ -45,7 +59,11 @@ int main(int argc, char *argv[]) {
         sendData(c_socket, msg);
 
         // 5) Receive data from the server
-        receiveData(c_socket, sizeof(char) * BUFFERSIZE, msg);
+        if (framed) {
+            receiveFrame(c_socket, msg);
+        } else {
+            receiveData(c_socket, sizeof(char) * BUFFERSIZE, msg);
+        }
 
         // Check if the received message is "Bye"
         char *byeString = "Bye";
@@ -87,8 +105,30 @@ void clearwinsock() {
  * @return 1 if the send operation is successful, -1 if there is an error.
  */
 int sendData(int c_socket, char *msg) {
+    char request[FRAME_HEADERSIZE + BUFFERSIZE];
+    int length = strlen(msg);
+
+    if (framed) {
+        // Header: magic, type and the big-endian payload length
+        int binaryLength = binary ? encodeBinary(msg, request + FRAME_HEADERSIZE) : -1;
+        if (binaryLength > 0) {
+            length = binaryLength;
+        } else {
+            memcpy(request + FRAME_HEADERSIZE, msg, length);
+        }
+        request[0] = (char) FRAME_MAGIC;
+        request[1] = binaryLength > 0 ? FRAME_BINARY : FRAME_TEXT;
+        request[2] = (char) (length >> 8);
+        request[3] = (char) (length & 0xFF);
+        length += FRAME_HEADERSIZE;
+    } else {
+        // The legacy protocol sends the string with its terminator
+        memcpy(request, msg, length + 1);
+        length += 1;
+    }
+
     // Send data to the server
-    if (send(c_socket, msg, sizeof(sizeof(char) * BUFFERSIZE), 0) != sizeof(sizeof(char) * BUFFERSIZE)) {
+    if (send(c_socket, request, length, 0) != length) {
         errorhandler("send() sent a different number of bytes than expected.");
         closesocket(c_socket);
         clearwinsock();
@@ -129,6 +169,82 @@ int receiveData(int c_socket, int string_len, char *msg) {
     return 0;
 }
 
+/**
+ * @brief Receives exactly length bytes from the server.
+ *
+ * @param c_socket The socket for receiving data.
+ * @param buffer The buffer that receives the bytes.
+ * @param length The number of bytes to receive.
+ * @return 0 if all the bytes are received, -1 if there is an error.
+ */
+int receiveAll(int c_socket, char *buffer, int length) {
+    int bytes_received;
+    int total_bytes_received = 0;
+
+    while (total_bytes_received < length) {
+        if ((bytes_received = recv(c_socket, buffer + total_bytes_received, length - total_bytes_received, 0)) <= 0) {
+            errorhandler("recv() failed or the connection closed prematurely.");
+            closesocket(c_socket);
+            clearwinsock();
+            return -1;
+        }
+        total_bytes_received += bytes_received; // Keep track of the total received bytes
+    }
+    return 0;
+}
+
+/**
+ * @brief Receives a framed reply from the server and stores its payload in msg.
+ *
+ * @param c_socket The socket for receiving data.
+ * @param msg The received payload will be stored in this buffer.
+ * @return 0 if the frame is received successfully, -1 if there is an error.
+ */
+int receiveFrame(int c_socket, char *msg) {
+    unsigned char header[FRAME_HEADERSIZE];
+
+    printf("Received: "); // Set up to print the received string
+
+    if (receiveAll(c_socket, (char *) header, FRAME_HEADERSIZE) < 0) {
+        return -1;
+    }
+
+    int length = (header[2] << 8) | header[3];
+    if (header[0] != FRAME_MAGIC || (header[1] != FRAME_TEXT && header[1] != FRAME_BINARY) || length >= BUFFERSIZE
+        || (header[1] == FRAME_BINARY && length != BINARY_REPLYSIZE)) {
+        errorhandler("Invalid frame received.");
+        closesocket(c_socket);
+        clearwinsock();
+        return -1;
+    }
+
+    if (receiveAll(c_socket, msg, length) < 0) {
+        return -1;
+    }
+    msg[length] = '\0'; // Null-terminate the received payload
+
+    if (header[1] == FRAME_BINARY) {
+        // Status, result type, 2 reserved bytes and the big-endian IEEE-754 result
+        const unsigned char *result = (const unsigned char*) msg;
+        unsigned long long bits = 0;
+        for (int i = 4; i < BINARY_REPLYSIZE; i++) {
+            bits = (bits << 8) | result[i];
+        }
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+
+        if (result[0] == 0) {
+            snprintf(msg, BUFFERSIZE, "%.2f", value);
+        } else {
+            snprintf(msg, BUFFERSIZE, "E%d", result[0]);
+        }
+    }
+
+    printf("%s\n", msg);
+
+    return 0;
+}
+
 /**
  * @brief Closes the connection and performs cleanup.
  *
@@ -248,9 +364,11 @@ void inputString(char *msg) {
     int num1, num2;
     if (sscanf(msg, "%c", &operator) == 1 && strchr("=", operator) != NULL) {
         printf("\nClosing the connection...\n");
+    } else if (operator == BATCH_OPERATOR || operator == EXPRESSION_OPERATOR) {
+        // Batch of operations or expression: validated by the server
     } else {
         if (sscanf(msg, "%c %d %d", &operator, &num1, &num2) != 3 || strchr("+-*/", operator) == NULL) {
-            sprintf(msgLog,"Invalid input format. Please use the format: operator [+-*/] value value or = to close the connection");
+            sprintf(msgLog,"Invalid input format. Please use the format: operator [+-*/] value value..., B followed by operations separated by ;, X followed by an expression or = to close the connection");
             printf("%s\n", msgLog);
             writeLog(msg);
             writeLog(msgLog);
@@ -258,26 +376,64 @@ void inputString(char *msg) {
         }
     }
 }
+/**
+ * @brief Encodes an operation as the payload of a binary frame.
+ *
+ * @param msg The operation, in the "operator value value" format.
+ * @param payload Buffer receiving BINARY_REQUESTSIZE bytes.
+ * @return BINARY_REQUESTSIZE, or -1 if msg is not a single operation.
+ */
+int encodeBinary(const char *msg, char *payload) {
+    char operator;
+    long long operands[2];
+
+    if (sscanf(msg, "%c %lld %lld", &operator, &operands[0], &operands[1]) != 3 || strchr("+-*/", operator) == NULL) {
+        return -1;
+    }
+
+    // Opcode, operand type, 2 reserved bytes and the two big-endian operands
+    memset(payload, 0, BINARY_REQUESTSIZE);
+    payload[0] = operator;
+    payload[1] = BINARY_INT64;
+    for (int i = 0; i < 2; i++) {
+        unsigned long long bits = (unsigned long long) operands[i];
+        for (int j = 7; j >= 0; j--) {
+            payload[4 + 8 * i + j] = (char) (bits & 0xFF);
+            bits >>= 8;
+        }
+    }
+    return BINARY_REQUESTSIZE;
+}
+
 /**
  * @brief Writes a log message to the log file.
  *
+ * The file stays open for the whole run and the date is formatted at most once
+ * per second, so a request costs a single write to the file.
+ *
  * @param message The log message to be written.
  */
 void writeLog(const char* message) {
-    FILE* file = fopen("Log.txt", "a");
+    static FILE* file = NULL;           // Log file, opened by the first message
+    static time_t cachedSecond = -1;    // Second dateAndTime was formatted for
+    static char dateAndTime[20];        // Current date and time
+
+    if (file == NULL) {
+        file = fopen("Log.txt", "a");
+    }
 
     if (file != NULL) {
         time_t timestamp = time(NULL);
-        struct tm* timeInfo = localtime(&timestamp);
-
-        // Get current date and time
-        char dateAndTime[20];
-        strftime(dateAndTime, sizeof(dateAndTime), "%H:%M:%S %d/%m/%Y", timeInfo);
+        if (timestamp != cachedSecond) {
+            // Get current date and time
+            struct tm* timeInfo = localtime(&timestamp);
+            strftime(dateAndTime, sizeof(dateAndTime), "%H:%M:%S %d/%m/%Y", timeInfo);
+            cachedSecond = timestamp;
+        }
 
         // Write the log message to the file
         fprintf(file, "CLIENT - [%s] - %s\n", dateAndTime, message);
-
-        fclose(file);
+        fflush(file);
     } else {
         printf("Error opening the log file.\n");
     }
@@ -11,9 +11,20 @@
 #define PROTOPORT 53199         // Default Server Port
 #define PROTO_ADDR "127.0.0.1"  // Default Server Address
 #define BUFFERSIZE 512          // Default Buffer Size
+#define FRAME_MAGIC 0xC5        // First byte of a frame
+#define FRAME_TEXT 0x01         // Frame type: text request or reply
+#define FRAME_BINARY 0x02       // Frame type: binary operations or results
+#define BINARY_INT64 1          // Operand type: big-endian 64 bit integers
+#define BINARY_REQUESTSIZE 20   // Size of a binary operation
+#define BINARY_REPLYSIZE 12     // Size of a binary result
+#define FRAME_HEADERSIZE 4      // Size of the frame header
+#define BATCH_OPERATOR 'B'      // First character of a batch request: "B + 1 2; * 3 4"
+#define EXPRESSION_OPERATOR 'X' // First character of an expression request: "X (1 + 2) * -3"
 
 char msg[BUFFERSIZE];    // Message Array
 char msgLog[BUFFERSIZE]; // Message Log
+int framed;              // 1 if the requests are sent as length-prefixed frames (--framed)
+int binary;              // 1 if the operations are sent as binary frames (--binary)
 
 /**
  * @brief Binds the socket to the specified address and port.
@@ -82,6 +93,25 @@ void inputString(char *msg);
  */
 int receiveData(int c_socket, int string_len, char *msg);
 
+/**
+ * @brief Receives exactly length bytes from the server.
+ *
+ * @param c_socket The socket for receiving data.
+ * @param buffer The buffer that receives the bytes.
+ * @param length The number of bytes to receive.
+ * @return 0 if all the bytes are received, -1 if there is an error.
+ */
+int receiveAll(int c_socket, char *buffer, int length);
+
+/**
+ * @brief Receives a framed reply from the server and stores its payload in msg.
+ *
+ * @param c_socket The socket for receiving data.
+ * @param msg The received payload will be stored in this buffer.
+ * @return 0 if the frame is received successfully, -1 if there is an error.
+ */
+int receiveFrame(int c_socket, char *msg);
+
 /**
  * @brief Sends data to the server through the given socket.
  *
@@ -91,6 +121,15 @@ int receiveData(int c_socket, int string_len, char *msg);
  */
 int sendData(int c_socket, char *msg);
 
+/**
+ * @brief Encodes an operation as the payload of a binary frame.
+ *
+ * @param msg The operation, in the "operator value value" format.
+ * @param payload Buffer receiving BINARY_REQUESTSIZE bytes.
+ * @return BINARY_REQUESTSIZE, or -1 if msg is not a single operation.
+ */
+int encodeBinary(const char *msg, char *payload);
+
 /**
  * @brief Writes a log message to the log file.
  *
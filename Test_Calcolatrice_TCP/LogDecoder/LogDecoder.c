@@ -0,0 +1,65 @@
+#include "../Server/Headers.h"
+#include "../Server/Server.h"
+#include "../Server/Log.h"
+
+/**
+ * @file LogDecoder.c
+ * @brief Offline decoder of the binary server log.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+/**
+ * @brief Main function of the decoder.
+ *
+ * Reads a log written with "--log=binary", or one of its segments, and prints every
+ * record as the line the server would have written to LOG_FILE.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings: the binary log, LOG_BINARY_FILE if omitted.
+ * @return 0 if the whole file was decoded, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : LOG_BINARY_FILE;
+    char header[LOG_HEADERSIZE];
+    char payload[BUFFERSIZE];
+    char line[LOG_LINE];
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening %s.\n", path);
+        return 1;
+    }
+
+    char magic[LOG_MAGICSIZE];
+    if (fread(magic, 1, LOG_MAGICSIZE, file) != LOG_MAGICSIZE || memcmp(magic, LOG_MAGIC, LOG_MAGICSIZE) != 0) {
+        fprintf(stderr, "%s is not a binary log.\n", path);
+        fclose(file);
+        return 1;
+    }
+
+    int result = 0;
+    while (fread(header, 1, LOG_HEADERSIZE, file) == LOG_HEADERSIZE) {
+        long long micros;
+        int event;
+        struct sockaddr_in address;
+
+        int length = decodeRecord(header, &micros, &event, &address);
+        if (micros == 0) {
+            break; // Zero padding of a segment the server was still writing
+        }
+        if (length > BUFFERSIZE || fread(payload, 1, (size_t) length, file) != (size_t) length) {
+            // Truncated by a crash of the server, or not a record boundary
+            fprintf(stderr, "Corrupted record at the end of %s.\n", path);
+            result = 1;
+            break;
+        }
+
+        int lineLength = formatRecord(line, micros, event, event == LOG_EVENT_MESSAGE ? NULL : &address,
+                                      payload, length);
+        fwrite(line, 1, (size_t) lineLength, stdout);
+    }
+
+    fclose(file);
+    return result;
+}
@@ -15,6 +15,7 @@
 
 #if defined WIN32
 #include <winsock.h>    // Windows Sockets API
+#define strtok_r strtok_s       // Re-entrant tokenizer has the same signature
 #else
 #include <unistd.h>     // Symbolic constants and types for POSIX
 #include <sys/socket.h> // Socket functions
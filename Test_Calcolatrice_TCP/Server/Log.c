@@ -0,0 +1,552 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Log.h"
+#include "Binary.h"
+
+#include <stdint.h>     // Signed distance between ring positions
+#if !defined WIN32
+#include <pthread.h>    // Writer thread
+#endif
+#if defined __linux__
+#include "LogSegments.h"
+#endif
+
+/**
+ * @file Log.c
+ * @brief Implementation file for the asynchronous log of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The ring is a bounded multi-producer queue: every slot carries the position it is
+ * ready for, so a request thread claims a position with a single compare-and-swap
+ * and publishes its record by advancing the sequence of the slot, while the only
+ * consumer, the writer thread, takes the records in order and appends them to the
+ * file with one write per batch. A full ring never blocks a request: the record is
+ * dropped and counted, and the writer reports the count. Records hold the raw
+ * fields of their event, the writer is the only one formatting or encoding them.
+ */
+
+#define LOG_MASK (LOG_RECORDS - 1)
+
+/**
+ * @brief A slot of the ring.
+ */
+struct LogRecord {
+    size_t sequence;            // Position + 1 once the record is published, position while free
+    long long micros;           // Time of the record in microseconds since the epoch
+    int event;                  // LOG_EVENT_ value
+    int length;                 // Size of the payload
+    struct sockaddr_in address; // Address of the client, zero for none
+    char text[BUFFERSIZE];      // Payload, not terminated
+};
+
+static struct LogRecord records[LOG_RECORDS]; // Ring of the records
+static size_t enqueuePosition;  // Next position claimed by a request thread
+static size_t dequeuePosition;  // Next position read by the writer
+static unsigned long dropped;   // Records dropped because the ring was full
+static int writerRunning;       // 1 while the writer thread consumes the ring
+static FILE *logFile;           // Log file, open for the whole run
+static int sinkOpen;            // 1 once the log file or the segments are open
+static int logSegments;         // Number of rotating segments, 0 to append to a single file
+static size_t logSegmentSize = (size_t) LOG_SEGMENT_SIZE << 20; // Size of a segment in bytes
+static int logFormat = LOG_FORMAT_TEXT; // LOG_FORMAT_ value the records are written in
+static time_t cachedSecond = -1; // Second cachedDate was formatted for
+static char cachedDate[20];     // Date and time of cachedSecond
+
+int logLevel = LOG_LEVEL_DEBUG; // Messages above this level are skipped at run time
+int logSampling = 1;            // Only 1 request in logSampling is logged
+
+#if !defined WIN32
+static pthread_t writerThread;  // Thread writing the records
+static pthread_mutex_t logMutex = PTHREAD_MUTEX_INITIALIZER; // Serializes the writes to the log file
+
+static void pushRecord(int event, const struct sockaddr_in *address, const char *data, int length);
+static void *runWriter(void *unused);
+#endif
+static FILE *openFile(void);
+static long long currentMicros(void);
+static int appendRecord(char *buffer, long long micros, int event, const struct sockaddr_in *address,
+                        const char *data, int length);
+static int encodeRecord(char *buffer, long long micros, int event, const struct sockaddr_in *address,
+                        const char *data, int length);
+static int openSink(void);
+static int messageLength(const char *message);
+static void writeBatch(const char *batch, int length);
+
+/**
+ * @brief Opens the log file and starts the thread writing the records.
+ *
+ * @param format LOG_FORMAT_TEXT to write LOG_FILE, LOG_FORMAT_BINARY to write LOG_BINARY_FILE.
+ * @return 0 on success, -1 if the records are written synchronously.
+ */
+int openLog(int format) {
+    logFormat = format;
+    sinkOpen = openSink() == 0;
+    if (!sinkOpen) {
+        printf("Error opening the log file.\n");
+        return -1;
+    }
+
+#if defined WIN32
+    return -1;
+#else
+    for (size_t i = 0; i < LOG_RECORDS; i++) {
+        records[i].sequence = i;
+    }
+
+    __atomic_store_n(&writerRunning, 1, __ATOMIC_RELEASE);
+    if (pthread_create(&writerThread, NULL, runWriter, NULL) != 0) {
+        __atomic_store_n(&writerRunning, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
+    atexit(closeLog);
+    return 0;
+#endif
+}
+
+/**
+ * @brief Writes the records still in the ring and stops the writer thread.
+ */
+void closeLog(void) {
+#if !defined WIN32
+    if (__atomic_exchange_n(&writerRunning, 0, __ATOMIC_ACQ_REL)) {
+        pthread_join(writerThread, NULL);
+    }
+#endif
+#if defined __linux__
+    if (logSegments > 0) {
+        closeSegments();
+        return;
+    }
+#endif
+    if (logFile != NULL) {
+        fflush(logFile);
+    }
+}
+
+/**
+ * @brief Keeps the log in rotating, memory-mapped segments instead of a single file.
+ *
+ * @param count The number of segments kept, 0 to append to a single file.
+ * @param size The size of a segment in MiB.
+ */
+void setLogSegments(int count, int size) {
+    logSegments = count > 0 ? count : 0;
+    if (size > 0) {
+        logSegmentSize = (size_t) size << 20;
+    }
+}
+
+/**
+ * @brief Sets the level of the messages kept at run time and the request sampling.
+ *
+ * @param level The highest LOG_LEVEL_ value kept.
+ * @param sampling Log 1 request in sampling (1 logs all of them).
+ */
+void setLogLevel(int level, int sampling) {
+    logLevel = level;
+    logSampling = sampling < 1 ? 1 : sampling;
+}
+
+/**
+ * @brief Converts the name of a level (error, warn, info, debug, trace) to its value.
+ *
+ * @param name The name of the level.
+ * @return The LOG_LEVEL_ value, -1 for an unknown name.
+ */
+int parseLogLevel(const char *name) {
+    static const char *names[] = { "error", "warn", "info", "debug", "trace" };
+
+    for (int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_TRACE; level++) {
+        if (strcmp(name, names[level]) == 0) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Decides whether the current request of the calling thread is logged.
+ *
+ * @return 1 for 1 request in logSampling, 0 for the others.
+ */
+int sampleRequest(void) {
+    static _Thread_local unsigned int requests; // Requests seen by the calling thread
+
+    return logSampling <= 1 || requests++ % (unsigned int) logSampling == 0;
+}
+
+/**
+ * @brief Writes a log message to the log file.
+ *
+ * @param message The log message to be written.
+ */
+void writeLog(const char* message) {
+    logEvent(LOG_EVENT_MESSAGE, NULL, message, messageLength(message));
+}
+
+/**
+ * @brief Logs an event of a client without formatting it.
+ *
+ * While the writer thread runs the record is only copied into the ring, so no
+ * request thread waits for the file; otherwise it is written immediately.
+ *
+ * @param event One of the LOG_EVENT_ values.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the event, not necessarily terminated.
+ * @param length The size of the payload, at most BUFFERSIZE bytes are kept.
+ */
+void logEvent(int event, const struct sockaddr_in *address, const char *data, int length) {
+    char line[LOG_LINE];
+
+    if (length > BUFFERSIZE) {
+        length = BUFFERSIZE;
+    }
+#if !defined WIN32
+    if (__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+        pushRecord(event, address, data, length);
+        return;
+    }
+    pthread_mutex_lock(&logMutex);
+#endif
+    if (!sinkOpen) {
+        sinkOpen = openSink() == 0;
+    }
+    if (sinkOpen) {
+        writeBatch(line, appendRecord(line, currentMicros(), event, address, data, length));
+    } else {
+        printf("Error opening the log file.\n");
+    }
+#if !defined WIN32
+    pthread_mutex_unlock(&logMutex);
+#endif
+}
+
+#if !defined WIN32
+/**
+ * @brief Copies an event into the next free slot of the ring.
+ *
+ * @param event The LOG_EVENT_ value.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the event.
+ * @param length The size of the payload, at most BUFFERSIZE.
+ */
+static void pushRecord(int event, const struct sockaddr_in *address, const char *data, int length) {
+    size_t position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+    struct LogRecord *record;
+
+    while (1) {
+        record = &records[position & LOG_MASK];
+        size_t sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+        intptr_t distance = (intptr_t) (sequence - position);
+
+        if (distance == 0) {
+            // The slot is free: claim it (a failed exchange reloads the position)
+            if (__atomic_compare_exchange_n(&enqueuePosition, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (distance < 0) {
+            // The writer is a whole ring behind
+            __atomic_add_fetch(&dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+
+    record->micros = currentMicros();
+    record->event = event;
+    record->length = length;
+    if (address != NULL) {
+        record->address = *address;
+    } else {
+        memset(&record->address, 0, sizeof(record->address));
+    }
+    memcpy(record->text, data, (size_t) length);
+    __atomic_store_n(&record->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Body of the writer thread: drains the ring into the file in batches.
+ *
+ * When the ring is empty the thread sleeps for LOG_IDLE_MS, so the request threads
+ * never have to wake it up. It exits once closeLog() is called and the ring is empty.
+ *
+ * @param unused Not used.
+ * @return NULL.
+ */
+static void *runWriter(void *unused) {
+    static char batch[LOG_BATCH];
+    const struct timespec idle = { 0, LOG_IDLE_MS * 1000000L };
+
+    (void) unused;
+    while (1) {
+        int length = 0;
+        int count = 0;
+        size_t position = dequeuePosition;
+        struct LogRecord *record = &records[position & LOG_MASK];
+
+        pthread_mutex_lock(&logMutex);
+        while (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) == position + 1) {
+            if (length + LOG_LINE > LOG_BATCH) {
+                writeBatch(batch, length);
+                length = 0;
+            }
+            length += appendRecord(batch + length, record->micros, record->event, &record->address,
+                                   record->text, record->length);
+
+            // Free the slot for the producer one ring ahead
+            __atomic_store_n(&record->sequence, position + LOG_RECORDS, __ATOMIC_RELEASE);
+            position++;
+            count++;
+            record = &records[position & LOG_MASK];
+        }
+        dequeuePosition = position;
+
+        unsigned long lost = __atomic_exchange_n(&dropped, 0, __ATOMIC_RELAXED);
+        if (lost > 0) {
+            char note[BUFFERSIZE];
+            snprintf(note, sizeof(note), "%lu log records dropped, the log ring was full", lost);
+            if (length + LOG_LINE > LOG_BATCH) {
+                writeBatch(batch, length);
+                length = 0;
+            }
+            length += appendRecord(batch + length, currentMicros(), LOG_EVENT_MESSAGE, NULL,
+                                   note, messageLength(note));
+        }
+        if (length > 0) {
+            writeBatch(batch, length);
+        }
+#if defined __linux__
+        if (count == 0 && logSegments > 0) {
+            syncSegments(); // Write back the end of the last burst
+        }
+#endif
+        pthread_mutex_unlock(&logMutex);
+
+        if (count == 0) {
+            if (!__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+                return NULL;
+            }
+            nanosleep(&idle, NULL);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Opens the segments of the current format, or its file when they are not used.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+static int openSink(void) {
+#if defined __linux__
+    if (logSegments > 0) {
+        if (logFormat == LOG_FORMAT_BINARY) {
+            return openSegments(LOG_BINARY_FILE, logSegments, logSegmentSize, LOG_MAGIC, LOG_MAGICSIZE);
+        }
+        return openSegments(LOG_FILE, logSegments, logSegmentSize, NULL, 0);
+    }
+#endif
+    logFile = openFile();
+    return logFile != NULL ? 0 : -1;
+}
+
+/**
+ * @brief Opens the file of the current format for appending.
+ *
+ * A new binary file starts with LOG_MAGIC.
+ *
+ * @return The file, NULL on failure.
+ */
+static FILE *openFile(void) {
+    if (logFormat == LOG_FORMAT_TEXT) {
+        return fopen(LOG_FILE, "a");
+    }
+
+    FILE *file = fopen(LOG_BINARY_FILE, "ab");
+    if (file != NULL && fseek(file, 0, SEEK_END) == 0 && ftell(file) == 0) {
+        fwrite(LOG_MAGIC, 1, LOG_MAGICSIZE, file);
+    }
+    return file;
+}
+
+/**
+ * @brief Returns the wall-clock time in microseconds since the epoch.
+ *
+ * @return The current time.
+ */
+static long long currentMicros(void) {
+#if defined WIN32
+    return (long long) time(NULL) * 1000000;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * @brief Writes a record in the current format.
+ *
+ * @param buffer Buffer of LOG_LINE bytes receiving the record.
+ * @param micros The time of the record.
+ * @param event The event of the record.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the record.
+ * @param length The size of the payload.
+ * @return The number of bytes written.
+ */
+static int appendRecord(char *buffer, long long micros, int event, const struct sockaddr_in *address,
+                        const char *data, int length) {
+    if (logFormat == LOG_FORMAT_BINARY) {
+        return encodeRecord(buffer, micros, event, address, data, length);
+    }
+    return formatRecord(buffer, micros, event, address, data, length);
+}
+
+/**
+ * @brief Renders a record as a line of the text log.
+ *
+ * The date is formatted once per second and reused for every record of that second.
+ *
+ * @param line Buffer of LOG_LINE bytes receiving the line.
+ * @param micros The time of the record in microseconds since the epoch.
+ * @param event The event of the record.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the record.
+ * @param length The size of the payload.
+ * @return The length of the line.
+ */
+int formatRecord(char *line, long long micros, int event, const struct sockaddr_in *address,
+                 const char *data, int length) {
+    time_t timestamp = (time_t) (micros / 1000000);
+    int written;
+
+    if (timestamp != cachedSecond) {
+        struct tm timeInfo;
+#if defined WIN32
+        localtime_s(&timeInfo, &timestamp);
+#else
+        localtime_r(&timestamp, &timeInfo);
+#endif
+        // Get current date and time
+        strftime(cachedDate, sizeof(cachedDate), "%H:%M:%S %d/%m/%Y", &timeInfo);
+        cachedSecond = timestamp;
+    }
+
+    if (address == NULL || event == LOG_EVENT_MESSAGE) {
+        written = snprintf(line, LOG_LINE, "SERVER - [%s] - %.*s\n", cachedDate, length, data);
+    } else if (event == LOG_EVENT_BINARY) {
+        written = snprintf(line, LOG_LINE, "SERVER - [%s] - Client: %s:%d send: %d binary operations\n",
+                           cachedDate, inet_ntoa(address->sin_addr), ntohs(address->sin_port),
+                           length / BINARY_REQUESTSIZE);
+    } else {
+        written = snprintf(line, LOG_LINE, "SERVER - [%s] - %s: %s:%d %s: %.*s\n", cachedDate,
+                           event == LOG_EVENT_REPLY ? "Server" : "Client", inet_ntoa(address->sin_addr),
+                           ntohs(address->sin_port), event == LOG_EVENT_REPLY ? "said" : "send", length, data);
+    }
+
+    // A truncated line still ends the record
+    if (written >= LOG_LINE) {
+        written = LOG_LINE - 1;
+        line[written - 1] = '\n';
+    }
+    return written;
+}
+
+/**
+ * @brief Encodes a record in the binary format.
+ *
+ * @param buffer Buffer of LOG_LINE bytes receiving the record.
+ * @param micros The time of the record.
+ * @param event The event of the record.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the record.
+ * @param length The size of the payload.
+ * @return The size of the record.
+ */
+static int encodeRecord(char *buffer, long long micros, int event, const struct sockaddr_in *address,
+                        const char *data, int length) {
+    unsigned char *header = (unsigned char *) buffer;
+    uint64_t value = (uint64_t) micros;
+
+    for (int i = 7; i >= 0; i--) {
+        header[i] = (unsigned char) (value & 0xFF);
+        value >>= 8;
+    }
+    header[8] = (unsigned char) (event >> 8);
+    header[9] = (unsigned char) event;
+    header[10] = (unsigned char) (length >> 8);
+    header[11] = (unsigned char) length;
+    if (address != NULL) {
+        memcpy(header + 12, &address->sin_addr, 4);
+        memcpy(header + 16, &address->sin_port, 2);
+    } else {
+        memset(header + 12, 0, 6);
+    }
+    header[18] = 0;
+    header[19] = 0;
+
+    memcpy(buffer + LOG_HEADERSIZE, data, (size_t) length);
+    return LOG_HEADERSIZE + length;
+}
+
+/**
+ * @brief Reads the fixed part of a binary record.
+ *
+ * @param header LOG_HEADERSIZE bytes of the binary log.
+ * @param micros Receives the time of the record.
+ * @param event Receives the event of the record.
+ * @param address Receives the address of the client.
+ * @return The size of the payload that follows the header.
+ */
+int decodeRecord(const char *header, long long *micros, int *event, struct sockaddr_in *address) {
+    const unsigned char *bytes = (const unsigned char *) header;
+    uint64_t value = 0;
+
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | bytes[i];
+    }
+    *micros = (long long) value;
+    *event = (bytes[8] << 8) | bytes[9];
+
+    memset(address, 0, sizeof(*address));
+    address->sin_family = AF_INET;
+    memcpy(&address->sin_addr, bytes + 12, 4);
+    memcpy(&address->sin_port, bytes + 16, 2);
+    return (bytes[10] << 8) | bytes[11];
+}
+
+/**
+ * @brief Returns the length of a message, at most BUFFERSIZE.
+ *
+ * @param message The NUL-terminated message.
+ * @return The number of characters stored for it.
+ */
+static int messageLength(const char *message) {
+    int length = 0;
+
+    while (length < BUFFERSIZE && message[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief Appends formatted lines to the log file.
+ *
+ * @param batch The lines.
+ * @param length The number of bytes.
+ */
+static void writeBatch(const char *batch, int length) {
+#if defined __linux__
+    if (logSegments > 0) {
+        writeSegments(batch, length);
+        return;
+    }
+#endif
+    fwrite(batch, 1, (size_t) length, logFile);
+    fflush(logFile);
+}
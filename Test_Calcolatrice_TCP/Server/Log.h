@@ -0,0 +1,150 @@
+#ifndef SERVER_LOG_H_
+#define SERVER_LOG_H_
+
+/**
+ * @file Log.h
+ * @brief Header file for the asynchronous log of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Every record keeps the raw fields of its event, so a request thread only copies
+ * them. The writer renders them as text lines, or appends them to a binary file
+ * that the LogDecoder tool renders as the same lines later. A binary file starts
+ * with LOG_MAGIC and every record is laid out as follows, multi-byte fields
+ * big-endian unless stated:
+ *
+ *     8 byte time in microseconds since the epoch, 2 byte event, 2 byte payload length,
+ *     4 byte IPv4 address and 2 byte port as stored in the sockaddr_in (network order),
+ *     2 reserved bytes, then the payload
+ */
+
+#define LOG_FILE "Log.txt"      // File the records are appended to
+#define LOG_BINARY_FILE "Log.bin" // File the records are appended to in the binary format
+#define LOG_RECORDS 4096        // Records the ring can hold (power of two)
+#define LOG_BATCH 65536         // Bytes the writer gathers before each write to the file
+#define LOG_IDLE_MS 1           // Time the writer sleeps when the ring is empty
+#define LOG_SEGMENT_SIZE 16     // Default size of a log segment in MiB
+#define LOG_LINE (BUFFERSIZE + 80) // Longest text line or binary record
+
+#define LOG_FORMAT_TEXT 0       // Records are written as text lines
+#define LOG_FORMAT_BINARY 1     // Records are written in the binary format
+#define LOG_MAGIC "CALCLOG1"    // First bytes of a binary log file
+#define LOG_MAGICSIZE 8         // Size of LOG_MAGIC
+#define LOG_HEADERSIZE 20       // Size of a binary record without its payload
+
+// Events of the records and the text each one is rendered as
+#define LOG_EVENT_MESSAGE 0     // The payload as it is, without address
+#define LOG_EVENT_REQUEST 1     // "Client: ip:port send: <payload>"
+#define LOG_EVENT_REPLY 2       // "Server: ip:port said: <payload>"
+#define LOG_EVENT_BINARY 3      // "Client: ip:port send: <n> binary operations", the payload holds them
+
+// Levels of the messages: a message is kept if its level is at most both the level
+// compiled in and the level chosen at run time
+#define LOG_LEVEL_ERROR 0       // The server or a client cannot go on
+#define LOG_LEVEL_WARN 1        // Something unexpected the server recovered from
+#define LOG_LEVEL_INFO 2        // Connections and state of the server
+#define LOG_LEVEL_DEBUG 3       // Every request and reply, 1 in logSampling
+#define LOG_LEVEL_TRACE 4       // Even more detail about the sampled requests
+
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LOG_LEVEL_TRACE // Messages above this level are compiled out
+#endif
+
+extern int logLevel;            // Messages above this level are skipped at run time
+extern int logSampling;         // Only 1 request in logSampling is logged
+
+// True if messages of the level are kept; a constant false when compiled out
+#define LOG_ENABLED(level) ((level) <= LOG_COMPILED_LEVEL && (level) <= logLevel)
+// True if the current request is logged at the level
+#define LOG_SAMPLED(level) (LOG_ENABLED(level) && sampleRequest())
+// Writes a message if its level is kept
+#define LOG_MESSAGE(level, message) do { if (LOG_ENABLED(level)) writeLog(message); } while (0)
+
+/**
+ * @brief Opens the log file and starts the thread writing the records.
+ *
+ * From then on writeLog() and logEvent() only copy the record into a lock-free
+ * ring; if the thread cannot be started the records are written synchronously
+ * instead. The remaining records are written when the process exits.
+ *
+ * @param format LOG_FORMAT_TEXT to write LOG_FILE, LOG_FORMAT_BINARY to write LOG_BINARY_FILE.
+ * @return 0 on success, -1 if the records are written synchronously.
+ */
+int openLog(int format);
+
+/**
+ * @brief Writes the records still in the ring and stops the writer thread.
+ */
+void closeLog(void);
+
+/**
+ * @brief Keeps the log in rotating, memory-mapped segments instead of a single file.
+ *
+ * Must be called before openLog(); the segments are only available on Linux.
+ *
+ * @param count The number of segments kept, 0 to append to a single file.
+ * @param size The size of a segment in MiB.
+ */
+void setLogSegments(int count, int size);
+
+/**
+ * @brief Logs an event of a client without formatting it.
+ *
+ * @param event One of the LOG_EVENT_ values.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the event, not necessarily terminated.
+ * @param length The size of the payload, at most BUFFERSIZE bytes are kept.
+ */
+void logEvent(int event, const struct sockaddr_in *address, const char *data, int length);
+
+/**
+ * @brief Renders a record as a line of the text log.
+ *
+ * @param line Buffer of LOG_LINE bytes receiving the line.
+ * @param micros The time of the record in microseconds since the epoch.
+ * @param event The event of the record.
+ * @param address The address of the client, NULL for none.
+ * @param data The payload of the record.
+ * @param length The size of the payload.
+ * @return The length of the line.
+ */
+int formatRecord(char *line, long long micros, int event, const struct sockaddr_in *address,
+                 const char *data, int length);
+
+/**
+ * @brief Reads the fixed part of a binary record.
+ *
+ * @param header LOG_HEADERSIZE bytes of the binary log.
+ * @param micros Receives the time of the record.
+ * @param event Receives the event of the record.
+ * @param address Receives the address of the client.
+ * @return The size of the payload that follows the header.
+ */
+int decodeRecord(const char *header, long long *micros, int *event, struct sockaddr_in *address);
+
+/**
+ * @brief Sets the level of the messages kept at run time and the request sampling.
+ *
+ * @param level The highest LOG_LEVEL_ value kept.
+ * @param sampling Log 1 request in sampling (1 logs all of them).
+ */
+void setLogLevel(int level, int sampling);
+
+/**
+ * @brief Converts the name of a level (error, warn, info, debug, trace) to its value.
+ *
+ * @param name The name of the level.
+ * @return The LOG_LEVEL_ value, -1 for an unknown name.
+ */
+int parseLogLevel(const char *name);
+
+/**
+ * @brief Decides whether the current request of the calling thread is logged.
+ *
+ * Every thread counts its own requests, so the decision takes no shared state.
+ *
+ * @return 1 for 1 request in logSampling, 0 for the others.
+ */
+int sampleRequest(void);
+
+#endif /* SERVER_LOG_H_ */
@@ -0,0 +1,50 @@
+#ifndef SERVER_LOGSEGMENTS_H_
+#define SERVER_LOGSEGMENTS_H_
+
+/**
+ * @file LogSegments.h
+ * @brief Header file for the memory-mapped, rotating segments of the log.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The log is kept in a fixed number of segment files, "<name>.0" to "<name>.N-1".
+ * Each segment is preallocated to its full size and written through a shared
+ * mapping, so appending a batch is a memcpy; when a segment is full the oldest
+ * one is overwritten. A finished segment is truncated to the bytes it holds, only
+ * the segment being written, or the last one of a killed server, ends with zeros.
+ */
+
+#define LOG_SYNC_MS 1000        // Time between two msync() of the segment being written
+
+/**
+ * @brief Opens the segment after the most recently written one.
+ *
+ * @param name The name of the log file the segments are named after.
+ * @param count The number of segments kept.
+ * @param size The size of a segment in bytes.
+ * @param header Bytes every segment starts with, NULL for none.
+ * @param headerLength The number of bytes of the header.
+ * @return 0 on success, -1 on failure.
+ */
+int openSegments(const char *name, int count, size_t size, const char *header, int headerLength);
+
+/**
+ * @brief Appends a batch to the current segment, moving to the next one when it is full.
+ *
+ * @param data The bytes to append.
+ * @param length The number of bytes, at most the size of a segment minus the header.
+ * @return 0 on success, -1 if no segment could be mapped.
+ */
+int writeSegments(const char *data, int length);
+
+/**
+ * @brief Schedules the write-back of the current segment if LOG_SYNC_MS have passed.
+ */
+void syncSegments(void);
+
+/**
+ * @brief Waits for the write-back of the current segment, truncates and closes it.
+ */
+void closeSegments(void);
+
+#endif /* SERVER_LOGSEGMENTS_H_ */
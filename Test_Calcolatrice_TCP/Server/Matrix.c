@@ -0,0 +1,521 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Vector.h"
+#include "Matrix.h"
+
+#include <float.h>      // DBL_MIN, DBL_EPSILON
+#include <math.h>       // sqrt(), fabs(), isfinite(), isinf()
+#if !defined WIN32
+#include <pthread.h>    // Threads of the large products
+#endif
+
+#if (defined __x86_64__ || defined __i386__) && defined __GNUC__
+#define MATRIX_X86 1            // The SIMD kernels are compiled
+#include <immintrin.h>  // SSE2, AVX2, FMA and AVX-512 intrinsics
+#endif
+
+/**
+ * @file Matrix.c
+ * @brief Implementation file for the linear algebra on arrays of operands.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The product follows the layout of Goto's algorithm: a block of MATRIX_BLOCKDEPTH
+ * rows of the second factor is copied into panels of two vectors of columns, a
+ * block of MATRIX_BLOCKROWS rows of the first factor into panels of MATRIX_TILEROWS
+ * rows, so the tile kernel reads both with unit stride from the caches and keeps
+ * a tile of MATRIX_TILEROWS x 2 vectors of the result in registers across the
+ * whole depth of the block.
+ */
+
+#define SCALAR_TILECOLUMNS 4    // Columns of a tile of the scalar kernel
+#define MAX_TILECOLUMNS 16      // Columns of a tile of the widest kernel
+
+/**
+ * @brief The kernels of an instruction set.
+ */
+struct Kernels {
+    double (*dot)(const double *x, const double *y, int count);
+    void (*axpy)(double a, const double *x, double *y, int count);
+    void (*tile)(int depth, const double *a, const double *b, double *c, int stride);
+    int tileColumns;            // Columns of the result a tile kernel computes
+};
+
+/**
+ * @brief The rows of a product given to a thread.
+ */
+struct Part {
+    const double *a;                // First row of the first factor
+    const double *b;                // The second factor
+    double *c;                      // First row of the product
+    int rows;                       // Rows of the part
+    int depth;                      // Columns of the first factor
+    int columns;                    // Columns of the second factor
+    const struct Kernels *kernel;   // Kernels of the instruction set in use
+};
+
+static int threadLimit = 0;     // Most threads, 0 for the processors up to MATRIX_THREADS
+
+static const struct Kernels *getKernels(void);
+static int countParts(int rows, int depth, int columns);
+static void runParts(struct Part *parts, int count);
+static void *multiplyPart(void *argument);
+static void multiplyBlocks(const struct Part *part, double *packedA, double *packedB);
+static void packRows(const double *a, int stride, int rows, int depth, double *packed);
+static void packColumns(const double *b, int stride, int depth, int columns, int tileColumns, double *packed);
+static double dotScalar(const double *x, const double *y, int count);
+static void axpyScalar(double a, const double *x, double *y, int count);
+static void tileScalar(int depth, const double *a, const double *b, double *c, int stride);
+
+#if defined MATRIX_X86
+/**
+ * @brief Defines the dot product kernel of an instruction set.
+ *
+ * Four vectors of partial sums hide the latency of the multiply-adds.
+ */
+#define DOT_KERNEL(name, isa, width, type, setzero, load, store, add, fmadd) \
+    __attribute__((target(isa))) \
+    static double name(const double *x, const double *y, int count) { \
+        type sum[4]; \
+        int i = 0; \
+        sum[0] = sum[1] = sum[2] = sum[3] = setzero(); \
+        for (; i + 4 * (width) <= count; i += 4 * (width)) { \
+            _Pragma("GCC unroll 4") \
+            for (int j = 0; j < 4; j++) { \
+                sum[j] = fmadd(load(x + i + j * (width)), load(y + i + j * (width)), sum[j]); \
+            } \
+        } \
+        double lanes[width]; \
+        double total = 0; \
+        store(lanes, add(add(sum[0], sum[1]), add(sum[2], sum[3]))); \
+        for (int lane = 0; lane < (width); lane++) { \
+            total += lanes[lane]; \
+        } \
+        return total + dotScalar(x + i, y + i, count - i); \
+    }
+
+/**
+ * @brief Defines the axpy kernel of an instruction set.
+ */
+#define AXPY_KERNEL(name, isa, width, type, set1, load, store, fmadd) \
+    __attribute__((target(isa))) \
+    static void name(double a, const double *x, double *y, int count) { \
+        type multiplier = set1(a); \
+        int i = 0; \
+        for (; i + (width) <= count; i += (width)) { \
+            store(y + i, fmadd(multiplier, load(x + i), load(y + i))); \
+        } \
+        axpyScalar(a, x + i, y + i, count - i); \
+    }
+
+/**
+ * @brief Defines the tile kernel of an instruction set.
+ *
+ * Adds to a tile of MATRIX_TILEROWS x 2 vectors of the result the product of a
+ * packed panel of rows and a packed panel of columns, with every partial sum in
+ * a register of its own.
+ */
+#define TILE_KERNEL(name, isa, width, type, setzero, set1, load, store, add, fmadd) \
+    __attribute__((target(isa))) \
+    static void name(int depth, const double *a, const double *b, double *c, int stride) { \
+        type sum[MATRIX_TILEROWS][2]; \
+        _Pragma("GCC unroll 6") \
+        for (int i = 0; i < MATRIX_TILEROWS; i++) { \
+            sum[i][0] = sum[i][1] = setzero(); \
+        } \
+        for (int p = 0; p < depth; p++) { \
+            type low = load(b + p * 2 * (width)); \
+            type high = load(b + p * 2 * (width) + (width)); \
+            _Pragma("GCC unroll 6") \
+            for (int i = 0; i < MATRIX_TILEROWS; i++) { \
+                type factor = set1(a[p * MATRIX_TILEROWS + i]); \
+                sum[i][0] = fmadd(factor, low, sum[i][0]); \
+                sum[i][1] = fmadd(factor, high, sum[i][1]); \
+            } \
+        } \
+        _Pragma("GCC unroll 6") \
+        for (int i = 0; i < MATRIX_TILEROWS; i++) { \
+            store(c + i * stride, add(load(c + i * stride), sum[i][0])); \
+            store(c + i * stride + (width), add(load(c + i * stride + (width)), sum[i][1])); \
+        } \
+    }
+
+/**
+ * @brief Multiplies and adds with SSE2, which has no fused multiply-add.
+ */
+__attribute__((target("sse2")))
+static inline __m128d multAddSse2(__m128d a, __m128d b, __m128d c) {
+    return _mm_add_pd(_mm_mul_pd(a, b), c);
+}
+
+DOT_KERNEL(dotSse2, "sse2", 2, __m128d, _mm_setzero_pd, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, multAddSse2)
+DOT_KERNEL(dotAvx2, "avx2,fma", 4, __m256d, _mm256_setzero_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+           _mm256_add_pd, _mm256_fmadd_pd)
+DOT_KERNEL(dotAvx512, "avx512f", 8, __m512d, _mm512_setzero_pd, _mm512_loadu_pd, _mm512_storeu_pd,
+           _mm512_add_pd, _mm512_fmadd_pd)
+AXPY_KERNEL(axpySse2, "sse2", 2, __m128d, _mm_set1_pd, _mm_loadu_pd, _mm_storeu_pd, multAddSse2)
+AXPY_KERNEL(axpyAvx2, "avx2,fma", 4, __m256d, _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_fmadd_pd)
+AXPY_KERNEL(axpyAvx512, "avx512f", 8, __m512d, _mm512_set1_pd, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_fmadd_pd)
+TILE_KERNEL(tileSse2, "sse2", 2, __m128d, _mm_setzero_pd, _mm_set1_pd, _mm_loadu_pd, _mm_storeu_pd,
+            _mm_add_pd, multAddSse2)
+TILE_KERNEL(tileAvx2, "avx2,fma", 4, __m256d, _mm256_setzero_pd, _mm256_set1_pd, _mm256_loadu_pd,
+            _mm256_storeu_pd, _mm256_add_pd, _mm256_fmadd_pd)
+TILE_KERNEL(tileAvx512, "avx512f", 8, __m512d, _mm512_setzero_pd, _mm512_set1_pd, _mm512_loadu_pd,
+            _mm512_storeu_pd, _mm512_add_pd, _mm512_fmadd_pd)
+#endif
+
+static const struct Kernels kernels[] = {
+    { dotScalar, axpyScalar, tileScalar, SCALAR_TILECOLUMNS },
+#if defined MATRIX_X86
+    { dotSse2, axpySse2, tileSse2, 4 },
+    { dotAvx2, axpyAvx2, tileAvx2, 8 },
+    { dotAvx512, axpyAvx512, tileAvx512, 16 },
+#endif
+};
+
+/**
+ * @brief Computes the dot product of two arrays.
+ *
+ * @param x The first array.
+ * @param y The second array.
+ * @param count The number of elements.
+ * @return The sum of x[i] * y[i].
+ */
+double dotVectors(const double *x, const double *y, int count) {
+    return getKernels()->dot(x, y, count);
+}
+
+/**
+ * @brief Adds a multiple of an array to another: y[i] = a * x[i] + y[i].
+ *
+ * @param a The multiplier.
+ * @param x The array multiplied.
+ * @param y The array receiving the results.
+ * @param count The number of elements.
+ */
+void axpyVectors(double a, const double *x, double *y, int count) {
+    getKernels()->axpy(a, x, y, count);
+}
+
+/**
+ * @brief Computes the Euclidean norm of an array.
+ *
+ * The direct sum is exact enough unless a square overflows, or the sum falls
+ * where the squares of the small elements lose their digits; only then are the
+ * elements divided by the largest one, as in the dnrm2 of the reference BLAS.
+ *
+ * @param x The array.
+ * @param count The number of elements.
+ * @return The square root of the sum of the squares.
+ */
+double normVector(const double *x, int count) {
+    double squares = dotVectors(x, x, count);
+    if (isfinite(squares) && squares >= DBL_MIN / DBL_EPSILON) {
+        return sqrt(squares);
+    }
+
+    double largest = 0;
+    for (int i = 0; i < count; i++) {
+        double magnitude = fabs(x[i]);
+        largest = magnitude > largest ? magnitude : largest;
+    }
+    if (largest == 0 || isinf(largest)) {
+        return largest == 0 ? sqrt(squares) : largest; // 0, or NaN if an element is NaN
+    }
+
+    double scaled = 0;
+    for (int i = 0; i < count; i++) {
+        double ratio = x[i] / largest;
+        scaled += ratio * ratio;
+    }
+    return largest * sqrt(scaled);
+}
+
+/**
+ * @brief Multiplies two matrices stored by rows: c = a * b.
+ *
+ * The rows of the product are split among the threads in multiples of
+ * MATRIX_TILEROWS; every thread packs the blocks it reads into buffers of its own.
+ *
+ * @param a The first factor, rows x depth.
+ * @param b The second factor, depth x columns.
+ * @param c Receives the product, rows x columns; it must not overlap the factors.
+ * @param rows The rows of a and c.
+ * @param depth The columns of a and the rows of b.
+ * @param columns The columns of b and c.
+ */
+void multMatrices(const double *a, const double *b, double *c, int rows, int depth, int columns) {
+    struct Part parts[MATRIX_THREADS];
+    int partCount = countParts(rows, depth, columns);
+    int tiles = (rows + MATRIX_TILEROWS - 1) / MATRIX_TILEROWS;
+
+    for (int i = 0; i < partCount; i++) {
+        int first = tiles * i / partCount * MATRIX_TILEROWS;
+        int last = i == partCount - 1 ? rows : tiles * (i + 1) / partCount * MATRIX_TILEROWS;
+        parts[i].a = a + (size_t) first * depth;
+        parts[i].b = b;
+        parts[i].c = c + (size_t) first * columns;
+        parts[i].rows = last - first;
+        parts[i].depth = depth;
+        parts[i].columns = columns;
+        parts[i].kernel = getKernels();
+    }
+
+    runParts(parts, partCount);
+}
+
+/**
+ * @brief Limits the threads a product is split among, to compare them.
+ *
+ * @param threads The most threads, 1 to multiply in the calling thread,
+ *                0 for the processors of the machine up to MATRIX_THREADS.
+ * @return The previous limit.
+ */
+int setMatrixThreads(int threads) {
+    int previous = threadLimit;
+    threadLimit = threads < 0 ? 0 : threads > MATRIX_THREADS ? MATRIX_THREADS : threads;
+    return previous;
+}
+
+/**
+ * @brief Returns the kernels of the instruction set in use.
+ *
+ * @return The kernels.
+ */
+static const struct Kernels *getKernels(void) {
+    return &kernels[getVectorLevel()];
+}
+
+/**
+ * @brief Decides among how many threads a product is split.
+ *
+ * @param rows The rows of the product.
+ * @param depth The columns of the first factor.
+ * @param columns The columns of the product.
+ * @return The number of parts, 1 for the calling thread alone.
+ */
+static int countParts(int rows, int depth, int columns) {
+    long long work = (long long) rows * depth * columns;
+    int threads = threadLimit;
+    if (threads == 0) {
+#if defined __linux__
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#elif defined WIN32
+        threads = 1; // The parts would all run in the calling thread
+#else
+        threads = MATRIX_THREADS;
+#endif
+    }
+    if (threads > MATRIX_THREADS) {
+        threads = MATRIX_THREADS;
+    }
+    if (threads > work / MATRIX_PARALLEL) {
+        threads = (int) (work / MATRIX_PARALLEL);
+    }
+    if (threads > rows / MATRIX_TILEROWS) {
+        threads = rows / MATRIX_TILEROWS;
+    }
+    return threads > 1 ? threads : 1;
+}
+
+/**
+ * @brief Multiplies every part, the first in the calling thread and the others in threads of their own.
+ *
+ * A part whose thread cannot be created is multiplied by the calling thread;
+ * without POSIX threads (Windows) every part is.
+ *
+ * @param parts The parts.
+ * @param count The number of parts.
+ */
+static void runParts(struct Part *parts, int count) {
+#if defined WIN32
+    for (int i = 0; i < count; i++) {
+        multiplyPart(&parts[i]);
+    }
+#else
+    pthread_t threads[MATRIX_THREADS];
+    int started[MATRIX_THREADS];
+
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, multiplyPart, &parts[i]) == 0;
+    }
+    multiplyPart(&parts[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            multiplyPart(&parts[i]);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Multiplies the rows of a part, with packing buffers of its own.
+ *
+ * Without memory for the buffers the rows are multiplied by plain loops.
+ *
+ * @param argument The struct Part.
+ * @return NULL.
+ */
+static void *multiplyPart(void *argument) {
+    const struct Part *part = argument;
+    int tileColumns = part->kernel->tileColumns;
+    int blockRows = part->rows < MATRIX_BLOCKROWS ? part->rows : MATRIX_BLOCKROWS;
+    int blockDepth = part->depth < MATRIX_BLOCKDEPTH ? part->depth : MATRIX_BLOCKDEPTH;
+    int blockColumns = part->columns < MATRIX_BLOCKCOLUMNS ? part->columns : MATRIX_BLOCKCOLUMNS;
+
+    // The buffers are no larger than the blocks, rounded up to whole panels
+    blockRows = (blockRows + MATRIX_TILEROWS - 1) / MATRIX_TILEROWS * MATRIX_TILEROWS;
+    blockColumns = (blockColumns + tileColumns - 1) / tileColumns * tileColumns;
+    double *packedA = malloc(sizeof(double) * blockRows * blockDepth);
+    double *packedB = malloc(sizeof(double) * blockDepth * blockColumns);
+
+    memset(part->c, 0, sizeof(double) * (size_t) part->rows * part->columns);
+    if (packedA != NULL && packedB != NULL) {
+        multiplyBlocks(part, packedA, packedB);
+    } else {
+        for (int i = 0; i < part->rows; i++) {
+            for (int p = 0; p < part->depth; p++) {
+                axpyScalar(part->a[i * part->depth + p], part->b + (size_t) p * part->columns,
+                           part->c + (size_t) i * part->columns, part->columns);
+            }
+        }
+    }
+    free(packedA);
+    free(packedB);
+    return NULL;
+}
+
+/**
+ * @brief Adds to the rows of a part the product of their factors, block by block.
+ *
+ * @param part The part, whose product is zero.
+ * @param packedA Buffer of the panels of a block of the first factor.
+ * @param packedB Buffer of the panels of a block of the second factor.
+ */
+static void multiplyBlocks(const struct Part *part, double *packedA, double *packedB) {
+    const struct Kernels *kernel = part->kernel;
+    int tileColumns = kernel->tileColumns;
+    int columns = part->columns;
+
+    for (int jc = 0; jc < columns; jc += MATRIX_BLOCKCOLUMNS) {
+        int blockColumns = columns - jc < MATRIX_BLOCKCOLUMNS ? columns - jc : MATRIX_BLOCKCOLUMNS;
+        for (int pc = 0; pc < part->depth; pc += MATRIX_BLOCKDEPTH) {
+            int blockDepth = part->depth - pc < MATRIX_BLOCKDEPTH ? part->depth - pc : MATRIX_BLOCKDEPTH;
+            packColumns(part->b + (size_t) pc * columns + jc, columns, blockDepth, blockColumns, tileColumns, packedB);
+
+            for (int ic = 0; ic < part->rows; ic += MATRIX_BLOCKROWS) {
+                int blockRows = part->rows - ic < MATRIX_BLOCKROWS ? part->rows - ic : MATRIX_BLOCKROWS;
+                packRows(part->a + (size_t) ic * part->depth + pc, part->depth, blockRows, blockDepth, packedA);
+
+                for (int jr = 0; jr < blockColumns; jr += tileColumns) {
+                    for (int ir = 0; ir < blockRows; ir += MATRIX_TILEROWS) {
+                        const double *panelA = packedA + ir * blockDepth;
+                        const double *panelB = packedB + jr * blockDepth;
+                        double *tile = part->c + (size_t) (ic + ir) * columns + jc + jr;
+                        if (ir + MATRIX_TILEROWS <= blockRows && jr + tileColumns <= blockColumns) {
+                            kernel->tile(blockDepth, panelA, panelB, tile, columns);
+                            continue;
+                        }
+
+                        // A tile past the edges of the product is computed apart and only its inside is kept
+                        double edge[MATRIX_TILEROWS * MAX_TILECOLUMNS] = { 0 };
+                        kernel->tile(blockDepth, panelA, panelB, edge, tileColumns);
+                        for (int i = 0; i < MATRIX_TILEROWS && ir + i < blockRows; i++) {
+                            for (int j = 0; j < tileColumns && jr + j < blockColumns; j++) {
+                                tile[(size_t) i * columns + j] += edge[i * tileColumns + j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies a block of the first factor into panels of MATRIX_TILEROWS rows.
+ *
+ * In every panel the MATRIX_TILEROWS elements of a column follow each other; the
+ * rows past the block are zero.
+ *
+ * @param a The first element of the block.
+ * @param stride The distance between two rows of the factor.
+ * @param rows The rows of the block.
+ * @param depth The columns of the block.
+ * @param packed Receives the panels.
+ */
+static void packRows(const double *a, int stride, int rows, int depth, double *packed) {
+    for (int panel = 0; panel < rows; panel += MATRIX_TILEROWS) {
+        for (int p = 0; p < depth; p++) {
+            for (int i = 0; i < MATRIX_TILEROWS; i++) {
+                *packed++ = panel + i < rows ? a[(size_t) (panel + i) * stride + p] : 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies a block of the second factor into panels of tileColumns columns.
+ *
+ * In every panel the tileColumns elements of a row follow each other; the columns
+ * past the block are zero.
+ *
+ * @param b The first element of the block.
+ * @param stride The distance between two rows of the factor.
+ * @param depth The rows of the block.
+ * @param columns The columns of the block.
+ * @param tileColumns The columns of a panel.
+ * @param packed Receives the panels.
+ */
+static void packColumns(const double *b, int stride, int depth, int columns, int tileColumns, double *packed) {
+    for (int panel = 0; panel < columns; panel += tileColumns) {
+        int width = columns - panel < tileColumns ? columns - panel : tileColumns;
+        for (int p = 0; p < depth; p++) {
+            memcpy(packed, b + (size_t) p * stride + panel, sizeof(double) * width);
+            memset(packed + width, 0, sizeof(double) * (tileColumns - width));
+            packed += tileColumns;
+        }
+    }
+}
+
+/**
+ * @brief Computes the dot product of two arrays one element at a time.
+ */
+static double dotScalar(const double *x, const double *y, int count) {
+    double sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Adds a multiple of an array to another one element at a time.
+ */
+static void axpyScalar(double a, const double *x, double *y, int count) {
+    for (int i = 0; i < count; i++) {
+        y[i] += a * x[i];
+    }
+}
+
+/**
+ * @brief Adds the product of two packed panels to a tile of SCALAR_TILECOLUMNS columns.
+ */
+static void tileScalar(int depth, const double *a, const double *b, double *c, int stride) {
+    double sum[MATRIX_TILEROWS][SCALAR_TILECOLUMNS] = { { 0 } };
+
+    for (int p = 0; p < depth; p++) {
+        for (int i = 0; i < MATRIX_TILEROWS; i++) {
+            for (int j = 0; j < SCALAR_TILECOLUMNS; j++) {
+                sum[i][j] += a[p * MATRIX_TILEROWS + i] * b[p * SCALAR_TILECOLUMNS + j];
+            }
+        }
+    }
+    for (int i = 0; i < MATRIX_TILEROWS; i++) {
+        for (int j = 0; j < SCALAR_TILECOLUMNS; j++) {
+            c[i * stride + j] += sum[i][j];
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef SERVER_MATRIX_H_
+#define SERVER_MATRIX_H_
+
+/**
+ * @file Matrix.h
+ * @brief Header file for the linear algebra on arrays of operands.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The level 1 operations of BLAS (dot product, axpy, Euclidean norm) and the
+ * product of dense matrices stored by rows, with the instruction set chosen by
+ * Vector.h. The product packs blocks of the factors that fit the caches and
+ * computes MATRIX_TILEROWS rows of the result at a time in registers; a product
+ * of at least MATRIX_PARALLEL multiply-adds splits the rows among threads.
+ * All of them use the fused multiply-add of the instruction sets that have it,
+ * so their roundings depend on the level.
+ */
+
+#define MATRIX_TILEROWS 6           // Rows of the result a kernel keeps in registers
+#define MATRIX_BLOCKROWS 96         // Rows of the first factor packed together (L2 cache)
+#define MATRIX_BLOCKDEPTH 256       // Columns of the first factor packed together (L1 cache)
+#define MATRIX_BLOCKCOLUMNS 1024    // Columns of the second factor packed together (L3 cache)
+#define MATRIX_PARALLEL 2097152     // Multiply-adds from which a product is split among threads
+#define MATRIX_THREADS 8            // Most threads a product is split among
+
+/**
+ * @brief Computes the dot product of two arrays.
+ *
+ * @param x The first array.
+ * @param y The second array.
+ * @param count The number of elements.
+ * @return The sum of x[i] * y[i].
+ */
+double dotVectors(const double *x, const double *y, int count);
+
+/**
+ * @brief Adds a multiple of an array to another: y[i] = a * x[i] + y[i].
+ *
+ * @param a The multiplier.
+ * @param x The array multiplied.
+ * @param y The array receiving the results.
+ * @param count The number of elements.
+ */
+void axpyVectors(double a, const double *x, double *y, int count);
+
+/**
+ * @brief Computes the Euclidean norm of an array.
+ *
+ * The squares are summed directly, and again after scaling the elements by the
+ * largest one only if that sum overflows or underflows.
+ *
+ * @param x The array.
+ * @param count The number of elements.
+ * @return The square root of the sum of the squares.
+ */
+double normVector(const double *x, int count);
+
+/**
+ * @brief Multiplies two matrices stored by rows: c = a * b.
+ *
+ * @param a The first factor, rows x depth.
+ * @param b The second factor, depth x columns.
+ * @param c Receives the product, rows x columns; it must not overlap the factors.
+ * @param rows The rows of a and c.
+ * @param depth The columns of a and the rows of b.
+ * @param columns The columns of b and c.
+ */
+void multMatrices(const double *a, const double *b, double *c, int rows, int depth, int columns);
+
+/**
+ * @brief Limits the threads a product is split among, to compare them.
+ *
+ * @param threads The most threads, 1 to multiply in the calling thread,
+ *                0 for the processors of the machine up to MATRIX_THREADS.
+ * @return The previous limit.
+ */
+int setMatrixThreads(int threads);
+
+#endif /* SERVER_MATRIX_H_ */
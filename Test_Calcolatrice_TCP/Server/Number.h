@@ -0,0 +1,78 @@
+#ifndef SERVER_NUMBER_H_
+#define SERVER_NUMBER_H_
+
+/**
+ * @file Number.h
+ * @brief Header file for the conversions between doubles and decimal text.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The conversions are exact and do not depend on the locale. Decimals are turned
+ * into doubles with the Eisel-Lemire algorithm, doubles into the shortest decimal
+ * that reads back to the same value with Schubfach, and into a fixed number of
+ * decimals with integer arithmetic that rounds like printf("%.*f"). The exact
+ * integer results are written two digits at a time, without a double.
+ */
+
+#include <stdint.h>     // Fixed width integers
+
+#define NUMBER_SHORTEST (-1)    // Precision of formatNumber() giving the shortest exact digits
+#define NUMBER_MAXPRECISION 9   // Highest fixed precision formatted without the C library
+#define NUMBER_SIZE 32          // Buffer that always holds a shortest number
+
+/**
+ * @brief Converts a decimal mantissa and exponent to the nearest double.
+ *
+ * @param mantissa The decimal digits of the number, without the sign.
+ * @param exponent The power of ten the mantissa is multiplied by.
+ * @param value Receives the nearest double (0 or infinity out of range).
+ * @return 0 on success, -1 in the rare cases the caller must convert the text itself.
+ */
+int decimalToDouble(uint64_t mantissa, int exponent, double *value);
+
+/**
+ * @brief Writes the shortest decimal that reads back to exactly the value.
+ *
+ * The digits are written in positional notation when the decimal point falls
+ * within 21 digits of them, in exponential notation ("1.5e+300") otherwise.
+ *
+ * @param buffer Buffer of NUMBER_SIZE bytes receiving the terminated text.
+ * @param value The value.
+ * @return The length of the text.
+ */
+int formatShortest(char *buffer, double value);
+
+/**
+ * @brief Writes the value with a fixed number of decimals, exactly as printf("%.*f").
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param value The value.
+ * @param precision The number of decimals.
+ * @return The length of the text, as snprintf().
+ */
+int formatFixed(char *buffer, int size, double value, int precision);
+
+/**
+ * @brief Writes the value with formatFixed() or formatShortest().
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param value The value.
+ * @param precision The number of decimals, NUMBER_SHORTEST for the shortest exact digits.
+ * @return The length of the text, as snprintf().
+ */
+int formatNumber(char *buffer, int size, double value, int precision);
+
+/**
+ * @brief Writes an integer with a fixed number of zero decimals, without converting it to a double.
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param value The integer.
+ * @param precision The number of decimals, NUMBER_SHORTEST for none.
+ * @return The length of the text, as snprintf().
+ */
+int formatInteger(char *buffer, int size, int64_t value, int precision);
+
+#endif /* SERVER_NUMBER_H_ */
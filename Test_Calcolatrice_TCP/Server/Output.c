@@ -0,0 +1,342 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Session.h"
+#include "Output.h"
+
+#include <errno.h>      // Error numbers of the non-blocking calls
+
+/**
+ * @file Output.c
+ * @brief Implementation file for the scatter-gather replies of a connection.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+static const char zeros[BUFFERSIZE];   // Padding of the legacy replies
+
+static long long outputMemory;         // Memory taken by the queued replies of every thread
+static long long outputMemoryLimit = (long long) OUTPUT_MEMORY << 20; // Limit of outputMemory
+
+static void queueData(struct Output *output, int length);
+
+/**
+ * @brief Sets the memory all the queued replies of the process may take.
+ *
+ * @param bytes The limit in bytes.
+ */
+void setOutputMemoryLimit(long long bytes) {
+    outputMemoryLimit = bytes;
+}
+
+/**
+ * @brief Accounts for memory taken by queued replies.
+ *
+ * Every connection may always take the memory of its first reply, so a client
+ * never waits for the replies of the others to be read; only what it queues on
+ * top of that is bounded by the limit.
+ *
+ * @param size The size of the allocation.
+ * @param always 1 to take the memory even past the limit, 0 to respect it.
+ * @return 1 if the memory may be allocated, 0 if the limit is reached.
+ */
+int reserveOutputMemory(long long size, int always) {
+    long long taken = __atomic_add_fetch(&outputMemory, size, __ATOMIC_RELAXED);
+
+    if (!always && taken > outputMemoryLimit) {
+        __atomic_sub_fetch(&outputMemory, size, __ATOMIC_RELAXED);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Gives back memory taken by queued replies.
+ *
+ * @param size The size of the released allocation.
+ */
+void releaseOutputMemory(long long size) {
+    __atomic_sub_fetch(&outputMemory, size, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Initializes an empty queue.
+ *
+ * @param queue The queue.
+ */
+void initQueue(struct OutputQueue *queue) {
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->paused = 0;
+}
+
+/**
+ * @brief Returns the output that receives the next reply of a queue.
+ *
+ * A new chunk is only added below the high watermark and within the memory limit;
+ * otherwise the queue is paused until flushQueue() brings it to the low watermark.
+ *
+ * @param queue The queue.
+ * @return An output with room for one reply, NULL while the queue is paused.
+ */
+struct Output *queueSpace(struct OutputQueue *queue) {
+    if (queue->paused) {
+        return NULL;
+    }
+    if (queue->tail != NULL && outputHasRoom(&queue->tail->output)) {
+        return &queue->tail->output;
+    }
+
+    int length = queueLength(queue);
+    if (length >= OUTPUT_HIGH_WATERMARK || !reserveOutputMemory(sizeof(struct OutputChunk), length == 0)) {
+        queue->paused = 1;
+        return NULL;
+    }
+
+    struct OutputChunk *chunk = malloc(sizeof(struct OutputChunk));
+    if (chunk == NULL) {
+        releaseOutputMemory(sizeof(struct OutputChunk));
+        errorhandler("Out of memory, reply delayed.");
+        queue->paused = 1;
+        return NULL;
+    }
+    chunk->next = NULL;
+    resetOutput(&chunk->output);
+
+    if (queue->tail == NULL) {
+        queue->head = chunk;
+    } else {
+        queue->tail->next = chunk;
+    }
+    queue->tail = chunk;
+    return &chunk->output;
+}
+
+/**
+ * @brief Returns the number of bytes queued and not sent yet.
+ *
+ * @param queue The queue.
+ * @return The number of bytes.
+ */
+int queueLength(const struct OutputQueue *queue) {
+    int length = 0;
+
+    for (const struct OutputChunk *chunk = queue->head; chunk != NULL; chunk = chunk->next) {
+        length += chunk->output.length;
+    }
+    return length;
+}
+
+/**
+ * @brief Sends the chunks of a queue in order until the socket would block.
+ *
+ * Sent chunks are released, except the last one, which is kept for the next replies.
+ * A paused queue resumes at the low watermark only once something was sent: a queue
+ * paused by the memory limit may already be below it, and resuming it without
+ * progress would only pause it again.
+ *
+ * @param my_socket The non-blocking socket.
+ * @param queue The queue.
+ * @return 0 on success (even if part of the queue is still waiting), -1 on errors.
+ */
+int flushQueue(int my_socket, struct OutputQueue *queue) {
+    int before = queue->paused ? queueLength(queue) : 0;
+
+    while (queue->head != NULL) {
+        struct OutputChunk *chunk = queue->head;
+        if (flushOutput(my_socket, &chunk->output) < 0) {
+            return -1;
+        }
+        if (chunk->output.length > 0 || chunk == queue->tail) {
+            break; // The socket would block, or the queue is empty
+        }
+
+        queue->head = chunk->next;
+        free(chunk);
+        releaseOutputMemory(sizeof(struct OutputChunk));
+    }
+
+    if (queue->paused) {
+        int length = queueLength(queue);
+        if (length <= OUTPUT_LOW_WATERMARK && (length < before || length == 0)) {
+            queue->paused = 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Releases every chunk of a queue.
+ *
+ * @param queue The queue.
+ */
+void freeQueue(struct OutputQueue *queue) {
+    while (queue->head != NULL) {
+        struct OutputChunk *chunk = queue->head;
+        queue->head = chunk->next;
+        free(chunk);
+        releaseOutputMemory(sizeof(struct OutputChunk));
+    }
+    queue->tail = NULL;
+}
+
+/**
+ * @brief Empties an output.
+ *
+ * @param output The output.
+ */
+void resetOutput(struct Output *output) {
+    output->iovCount = 0;
+    output->iovFirst = 0;
+    output->length = 0;
+    output->dataLength = 0;
+}
+
+/**
+ * @brief Tells whether one more reply of any kind fits in the output.
+ *
+ * A reply takes at most two fragments and MAXREPLYSIZE bytes of data.
+ *
+ * @param output The output.
+ * @return 1 if a reply can be queued, 0 if the output must be sent first.
+ */
+int outputHasRoom(const struct Output *output) {
+    return output->iovCount + 2 <= OUTPUT_IOV && output->dataLength + MAXREPLYSIZE <= OUTPUTBUFFER;
+}
+
+/**
+ * @brief Queues a fragment of static memory, which must outlive the send.
+ *
+ * @param output The output.
+ * @param data The fragment.
+ * @param length The size of the fragment.
+ */
+void queueStatic(struct Output *output, const char *data, int length) {
+    struct iovec *fragment = &output->iov[output->iovCount++];
+
+    fragment->iov_base = (void*) data;
+    fragment->iov_len = (size_t) length;
+    output->length += length;
+}
+
+/**
+ * @brief Queues a text reply encoded for the protocol of the session.
+ *
+ * @param output The output.
+ * @param session The session of the connection.
+ * @param reply The NUL-terminated reply.
+ */
+void queueText(struct Output *output, const struct Session *session, const char *reply) {
+    if (session->protocol != PROTOCOL_FRAMED) {
+        int length = (int) strlen(reply);
+        if (length > MAXPAYLOAD) {
+            length = MAXPAYLOAD;
+        }
+        memcpy(output->data + output->dataLength, reply, length);
+        queueData(output, length);
+        queueStatic(output, zeros, BUFFERSIZE - length);
+        return;
+    }
+
+    queueData(output, encodeReply(session, reply, output->data + output->dataLength));
+}
+
+/**
+ * @brief Evaluates a binary, stream or linear request and queues its reply frame.
+ *
+ * @param output The output.
+ * @param session The session of the connection.
+ * @param type REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR.
+ * @param request The payload of the frame.
+ * @param length The size of the payload.
+ * @return 0 on success, -1 if the payload is malformed.
+ */
+int queueBinaryReply(struct Output *output, struct Session *session, int type, const char *request, int length) {
+    int replyLength = answerBinary(session, type, request, length, output->data + output->dataLength);
+    if (replyLength < 0) {
+        return -1;
+    }
+
+    queueData(output, replyLength);
+    return 0;
+}
+
+/**
+ * @brief Sends as much of the output as the socket accepts with one sendmsg() per try.
+ *
+ * @param my_socket The non-blocking socket.
+ * @param output The output.
+ * @return 0 on success (even if part of the output is still queued), -1 on errors.
+ */
+int flushOutput(int my_socket, struct Output *output) {
+    struct msghdr message;
+
+    while (output->length > 0) {
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = output->iov + output->iovFirst;
+        message.msg_iovlen = (size_t) (output->iovCount - output->iovFirst);
+
+        ssize_t bytes_sent = sendmsg(my_socket, &message, MSG_NOSIGNAL);
+        if (bytes_sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            errorhandler("sendmsg() failed.");
+            return -1;
+        }
+        consumeOutput(output, (int) bytes_sent);
+    }
+    return 0;
+}
+
+/**
+ * @brief Marks the first bytes of the output as sent.
+ *
+ * Completely sent fragments are skipped and a partially sent one is shortened;
+ * once everything is sent the output is emptied.
+ *
+ * @param output The output.
+ * @param sent The number of bytes sent.
+ */
+void consumeOutput(struct Output *output, int sent) {
+    output->length -= sent;
+    if (output->length == 0) {
+        resetOutput(output);
+        return;
+    }
+
+    while (sent > 0) {
+        struct iovec *fragment = &output->iov[output->iovFirst];
+        if ((size_t) sent < fragment->iov_len) {
+            fragment->iov_base = (char*) fragment->iov_base + sent;
+            fragment->iov_len -= (size_t) sent;
+            return;
+        }
+        sent -= (int) fragment->iov_len;
+        output->iovFirst++;
+    }
+}
+
+/**
+ * @brief Queues the bytes just built at the end of the data.
+ *
+ * They extend the last fragment when it also ends there, so consecutive replies
+ * built in the data are sent as one fragment.
+ *
+ * @param output The output.
+ * @param length The number of bytes built.
+ */
+static void queueData(struct Output *output, int length) {
+    char *start = output->data + output->dataLength;
+    struct iovec *last = output->iovCount > output->iovFirst ? &output->iov[output->iovCount - 1] : NULL;
+
+    if (last != NULL && (char*) last->iov_base + last->iov_len == start) {
+        last->iov_len += (size_t) length;
+        output->length += length;
+    } else {
+        queueStatic(output, start, length);
+    }
+    output->dataLength += length;
+}
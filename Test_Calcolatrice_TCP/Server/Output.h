@@ -0,0 +1,187 @@
+#ifndef SERVER_OUTPUT_H_
+#define SERVER_OUTPUT_H_
+
+/**
+ * @file Output.h
+ * @brief Header file for the scatter-gather replies of a connection.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#include <sys/uio.h>    // Scatter-gather vectors
+
+#define OUTPUT_IOV 128          // Fragments sent by a single sendmsg() (well below IOV_MAX)
+
+// A connection whose client does not read its replies stops being read itself once
+// the replies waiting for it reach the high watermark, and is read again only when
+// they fall back to the low watermark.
+#define OUTPUT_HIGH_WATERMARK (64 * 1024)
+#define OUTPUT_LOW_WATERMARK (16 * 1024)
+
+/**
+ * @brief The replies queued for a connection, as a list of fragments.
+ *
+ * Fragments either point into the data of the output, where the bytes built for
+ * the replies are stored back to back and coalesced into one fragment, or to
+ * preformatted static memory such as the banner and the padding of the legacy
+ * replies, which is never copied.
+ */
+struct Output {
+    struct iovec iov[OUTPUT_IOV];  // Fragments of the queued replies
+    int iovCount;                  // Number of fragments
+    int iovFirst;                  // First fragment not completely sent
+    int length;                    // Bytes queued and not sent yet
+    int dataLength;                // Bytes used in the data
+    char data[OUTPUTBUFFER];       // Storage of the bytes built for the replies
+};
+
+/**
+ * @brief A block of the replies queued for a connection.
+ */
+struct OutputChunk {
+    struct OutputChunk *next;      // Next chunk, sent after this one
+    struct Output output;          // Replies of the chunk
+};
+
+/**
+ * @brief The replies of a connection, as a list of chunks sent in order.
+ *
+ * A queue keeps its last chunk when everything is sent, so a connection answering
+ * one request at a time does not allocate on every reply.
+ */
+struct OutputQueue {
+    struct OutputChunk *head;      // Chunk being sent
+    struct OutputChunk *tail;      // Chunk receiving the next replies
+    int paused;                    // 1 from the high watermark until the low one
+};
+
+/**
+ * @brief Sets the memory all the queued replies of the process may take.
+ *
+ * @param bytes The limit in bytes.
+ */
+void setOutputMemoryLimit(long long bytes);
+
+/**
+ * @brief Accounts for memory taken by queued replies.
+ *
+ * @param size The size of the allocation.
+ * @param always 1 to take the memory even past the limit, 0 to respect it.
+ * @return 1 if the memory may be allocated, 0 if the limit is reached.
+ */
+int reserveOutputMemory(long long size, int always);
+
+/**
+ * @brief Gives back memory taken by queued replies.
+ *
+ * @param size The size of the released allocation.
+ */
+void releaseOutputMemory(long long size);
+
+/**
+ * @brief Initializes an empty queue.
+ *
+ * @param queue The queue.
+ */
+void initQueue(struct OutputQueue *queue);
+
+/**
+ * @brief Returns the output that receives the next reply of a queue.
+ *
+ * @param queue The queue.
+ * @return An output with room for one reply, NULL while the queue is paused.
+ */
+struct Output *queueSpace(struct OutputQueue *queue);
+
+/**
+ * @brief Returns the number of bytes queued and not sent yet.
+ *
+ * @param queue The queue.
+ * @return The number of bytes.
+ */
+int queueLength(const struct OutputQueue *queue);
+
+/**
+ * @brief Sends the chunks of a queue in order until the socket would block.
+ *
+ * A paused queue resumes at the low watermark once something was sent.
+ *
+ * @param my_socket The non-blocking socket.
+ * @param queue The queue.
+ * @return 0 on success (even if part of the queue is still waiting), -1 on errors.
+ */
+int flushQueue(int my_socket, struct OutputQueue *queue);
+
+/**
+ * @brief Releases every chunk of a queue.
+ *
+ * @param queue The queue.
+ */
+void freeQueue(struct OutputQueue *queue);
+
+/**
+ * @brief Empties an output.
+ *
+ * @param output The output.
+ */
+void resetOutput(struct Output *output);
+
+/**
+ * @brief Tells whether one more reply of any kind fits in the output.
+ *
+ * @param output The output.
+ * @return 1 if a reply can be queued, 0 if the output must be sent first.
+ */
+int outputHasRoom(const struct Output *output);
+
+/**
+ * @brief Queues a fragment of static memory, which must outlive the send.
+ *
+ * @param output The output.
+ * @param data The fragment.
+ * @param length The size of the fragment.
+ */
+void queueStatic(struct Output *output, const char *data, int length);
+
+/**
+ * @brief Queues a text reply encoded for the protocol of the session.
+ *
+ * Legacy replies are the characters of the reply followed by a static fragment
+ * of zeros; framed replies are built in the data.
+ *
+ * @param output The output.
+ * @param session The session of the connection.
+ * @param reply The NUL-terminated reply.
+ */
+void queueText(struct Output *output, const struct Session *session, const char *reply);
+
+/**
+ * @brief Evaluates a binary, stream or linear request and queues its reply frame.
+ *
+ * @param output The output.
+ * @param session The session of the connection.
+ * @param type REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR.
+ * @param request The payload of the frame.
+ * @param length The size of the payload.
+ * @return 0 on success, -1 if the payload is malformed.
+ */
+int queueBinaryReply(struct Output *output, struct Session *session, int type, const char *request, int length);
+
+/**
+ * @brief Sends as much of the output as the socket accepts with one sendmsg() per try.
+ *
+ * @param my_socket The non-blocking socket.
+ * @param output The output.
+ * @return 0 on success (even if part of the output is still queued), -1 on errors.
+ */
+int flushOutput(int my_socket, struct Output *output);
+
+/**
+ * @brief Marks the first bytes of the output as sent.
+ *
+ * @param output The output.
+ * @param sent The number of bytes sent.
+ */
+void consumeOutput(struct Output *output, int sent);
+
+#endif /* SERVER_OUTPUT_H_ */
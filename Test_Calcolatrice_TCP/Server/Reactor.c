@@ -0,0 +1,572 @@
+#define _GNU_SOURCE     // accept4() and MSG_NOSIGNAL
+
+#include "Headers.h"
+#include "Server.h"
+#include "Session.h"
+#include "Binary.h"
+#include "Log.h"
+#include "Output.h"
+#include "TimerWheel.h"
+#include "Reactor.h"
+
+#include <errno.h>      // Error numbers of the non-blocking calls
+#include <fcntl.h>      // File control options
+#include <sys/epoll.h>  // Linux event notification facility
+
+/**
+ * @file Reactor.c
+ * @brief Implementation file for the epoll based event loop of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+static void acceptClients(struct Reactor *reactor);
+static void closeClient(struct Connection *connection);
+static void expireConnection(struct Timer *timer);
+static int loopTimeout(const struct Reactor *reactor);
+static int handleBinary(struct Connection *connection, struct Output *output, int type, const char *request, int length);
+static void handleRequest(struct Connection *connection, struct Output *output, char *request, int length);
+static int handleRequests(struct Connection *connection);
+static struct Connection *newConnection(int client_socket, struct sockaddr_in address);
+static void receiveHandOffs(struct Reactor *reactor);
+static void registerClient(struct Reactor *reactor, struct Connection *connection);
+static int serveClient(struct Connection *connection);
+static int setNonBlocking(int my_socket);
+static void updateDeadline(struct Connection *connection);
+
+/**
+ * @brief Runs the edge-triggered epoll event loop on the listening socket.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if the event loop cannot be started or fails.
+ */
+int runReactor(int my_socket, const struct Timeouts *timeouts) {
+    static struct Reactor reactor;
+
+    if (initReactor(&reactor, my_socket, 0, timeouts) < 0) {
+        return -1;
+    }
+
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Searching for a client...");
+    return runReactorLoop(&reactor);
+}
+
+/**
+ * @brief Creates the epoll instance of a reactor and registers its sources.
+ *
+ * The listening socket is registered with a NULL pointer and the hand-off pipe with
+ * the reactor itself, while every client is registered with its own Connection, so an
+ * event tells directly which state to use.
+ *
+ * @param reactor The reactor to initialize.
+ * @param listen_socket The listening socket to accept from, or -1.
+ * @param handoff 1 to create the hand-off pipe used by a dispatcher thread, 0 otherwise.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return 0 on success, -1 on failure.
+ */
+int initReactor(struct Reactor *reactor, int listen_socket, int handoff, const struct Timeouts *timeouts) {
+    struct epoll_event event;
+
+    reactor->listen_socket = listen_socket;
+    reactor->handoff[0] = -1;
+    reactor->handoff[1] = -1;
+    reactor->timeouts = *timeouts;
+    reactor->acceptDelayed = 0;
+    initWheel(&reactor->wheel);
+
+    reactor->epoll_fd = epoll_create1(0);
+    if (reactor->epoll_fd < 0) {
+        errorhandler("epoll_create1() failed.");
+        return -1;
+    }
+
+    if (listen_socket >= 0) {
+        if (setNonBlocking(listen_socket) < 0) {
+            errorhandler("fcntl() failed.");
+            closesocket(reactor->epoll_fd);
+            return -1;
+        }
+
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = NULL; // NULL marks the listening socket
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, listen_socket, &event) < 0) {
+            errorhandler("epoll_ctl() failed.");
+            closesocket(reactor->epoll_fd);
+            return -1;
+        }
+    }
+
+    if (handoff) {
+        // Only the reading end is non-blocking: a full pipe slows the dispatcher down
+        if (pipe(reactor->handoff) < 0 || setNonBlocking(reactor->handoff[0]) < 0) {
+            errorhandler("pipe() failed.");
+            closesocket(reactor->epoll_fd);
+            return -1;
+        }
+
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = reactor; // The reactor itself marks the hand-off pipe
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->handoff[0], &event) < 0) {
+            errorhandler("epoll_ctl() failed.");
+            closesocket(reactor->epoll_fd);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Runs the event loop of an initialized reactor.
+ *
+ * epoll_wait() sleeps at most until the next tick of the timing wheel; the expired
+ * connections are closed after the events of the iteration have been handled, so
+ * no event can refer to a connection that is already gone. An accept() delayed by
+ * missing resources is retried at the end of every iteration.
+ *
+ * @param reactor The reactor to run.
+ * @return -1 when the loop fails, it never returns otherwise.
+ */
+int runReactorLoop(struct Reactor *reactor) {
+    struct epoll_event events[MAXEVENTS];
+
+    while (1) {
+        int ready = epoll_wait(reactor->epoll_fd, events, MAXEVENTS, loopTimeout(reactor));
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            errorhandler("epoll_wait() failed.");
+            closesocket(reactor->epoll_fd);
+            return -1;
+        }
+
+        reactor->wheel.now = monotonicMs();
+        for (int i = 0; i < ready; i++) {
+            void *source = events[i].data.ptr;
+
+            if (source == NULL) {
+                acceptClients(reactor);
+            } else if (source == reactor) {
+                receiveHandOffs(reactor);
+            } else if (events[i].events & EPOLLERR) {
+                closeClient(source);
+            } else if (serveClient(source) < 0) {
+                closeClient(source);
+            } else {
+                updateDeadline(source);
+            }
+        }
+
+        advanceWheel(&reactor->wheel, expireConnection);
+
+        // The clients already waiting bring no new edge: accept them once resources are back
+        if (reactor->acceptDelayed) {
+            acceptClients(reactor);
+        }
+    }
+}
+
+/**
+ * @brief Hands a connection accepted by another thread over to a reactor.
+ *
+ * Only the pointer to the new Connection travels through the pipe; writes of a
+ * pointer are atomic, so several dispatchers could share the same reactor.
+ *
+ * @param reactor The reactor that will serve the client.
+ * @param client_socket The non-blocking socket of the client.
+ * @param address The address of the client.
+ * @return 0 on success, -1 on failure (the socket is closed).
+ */
+int handOffClient(struct Reactor *reactor, int client_socket, struct sockaddr_in address) {
+    struct Connection *connection = newConnection(client_socket, address);
+    if (connection == NULL) {
+        return -1;
+    }
+
+    if (write(reactor->handoff[1], &connection, sizeof(connection)) != sizeof(connection)) {
+        errorhandler("write() on the hand-off pipe failed.");
+        closeClient(connection);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Accepts every pending connection on the listening socket.
+ *
+ * With edge-triggered notifications the queue has to be drained until accept()
+ * reports that no more clients are waiting. Out of descriptors or memory the queue
+ * cannot be drained, and no new edge would come for the clients left in it, so
+ * the reactor retries until they are accepted, as the dispatcher of WorkerPool.c.
+ *
+ * @param reactor The reactor owning the listening socket.
+ */
+static void acceptClients(struct Reactor *reactor) {
+    while (1) {
+        struct sockaddr_in cad;
+        socklen_t client_len = sizeof(cad);
+        int client_socket = accept4(reactor->listen_socket, (struct sockaddr*) &cad, &client_len, SOCK_NONBLOCK);
+
+        if (client_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                if (!reactor->acceptDelayed) {
+                    errorhandler("accept() failed, out of resources.");
+                    reactor->acceptDelayed = 1;
+                }
+                return;
+            }
+            reactor->acceptDelayed = 0;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                errorhandler("accept() failed.");
+            }
+            return;
+        }
+        reactor->acceptDelayed = 0;
+
+        struct Connection *connection = newConnection(client_socket, cad);
+        if (connection != NULL) {
+            registerClient(reactor, connection);
+        }
+    }
+}
+
+/**
+ * @brief Returns how long epoll_wait() may sleep.
+ *
+ * @param reactor The reactor.
+ * @return The time to the next tick of the wheel, at most WHEEL_TICK while an
+ *         accept() is delayed, -1 to sleep until an event.
+ */
+static int loopTimeout(const struct Reactor *reactor) {
+    int timeout = wheelTimeout(&reactor->wheel);
+
+    if (reactor->acceptDelayed && (timeout < 0 || timeout > WHEEL_TICK)) {
+        timeout = WHEEL_TICK;
+    }
+    return timeout;
+}
+
+/**
+ * @brief Registers every connection waiting in the hand-off pipe.
+ *
+ * @param reactor The reactor owning the pipe.
+ */
+static void receiveHandOffs(struct Reactor *reactor) {
+    struct Connection *connections[MAXEVENTS];
+
+    while (1) {
+        ssize_t bytes_read = read(reactor->handoff[0], connections, sizeof(connections));
+        if (bytes_read <= 0) {
+            if (bytes_read < 0 && errno == EINTR) {
+                continue;
+            }
+            return; // Drained (EAGAIN) or dispatcher gone
+        }
+
+        int count = (int) (bytes_read / (ssize_t) sizeof(struct Connection *));
+        for (int i = 0; i < count; i++) {
+            registerClient(reactor, connections[i]);
+        }
+    }
+}
+
+/**
+ * @brief Allocates the state of a newly accepted client.
+ *
+ * @param client_socket The socket of the client.
+ * @param address The address of the client.
+ * @return The new connection, or NULL if memory is exhausted (the socket is closed).
+ */
+static struct Connection *newConnection(int client_socket, struct sockaddr_in address) {
+    struct Connection *connection = calloc(1, sizeof(struct Connection));
+    if (connection == NULL) {
+        errorhandler("Out of memory, connection refused.");
+        closesocket(client_socket);
+        return NULL;
+    }
+
+    connection->socket = client_socket;
+    connection->address = address;
+    initTimer(&connection->timer, connection);
+    initSession(&connection->session);
+    initQueue(&connection->output);
+    inet_ntop(AF_INET, &address.sin_addr, connection->addressString, sizeof(connection->addressString));
+    return connection;
+}
+
+/**
+ * @brief Adds a client to the reactor and sends it the welcome message.
+ *
+ * @param reactor The reactor that will serve the client.
+ * @param connection The client connection.
+ */
+static void registerClient(struct Reactor *reactor, struct Connection *connection) {
+    char msgLog[BUFFERSIZE];
+
+    connection->reactor = reactor;
+    connection->started = reactor->wheel.now;
+
+    if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+        snprintf(msgLog, sizeof(msgLog), "Connection established with %s:%d",
+                 connection->addressString, ntohs(connection->address.sin_port));
+        writeLog(msgLog);
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = connection;
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, connection->socket, &event) < 0) {
+        errorhandler("epoll_ctl() failed.");
+        closeClient(connection);
+        return;
+    }
+
+    // Queue the welcome message as the first reply of the connection
+    struct Output *output = queueSpace(&connection->output);
+    if (output != NULL) {
+        queueStatic(output, welcomeBlock, BUFFERSIZE);
+    }
+    if (output == NULL || serveClient(connection) < 0) {
+        closeClient(connection);
+    } else {
+        updateDeadline(connection);
+    }
+}
+
+/**
+ * @brief Makes progress on a connection until the socket would block.
+ *
+ * Every complete request already received is evaluated in order and its reply
+ * queued in the output, which is then sent with one sendmsg() per chunk, so a client
+ * pipelining many requests gets one send per read instead of one per request. A
+ * client that does not read its replies pauses the queue at the high watermark or
+ * at the memory limit: the socket is not read anymore until EPOLLOUT has drained it
+ * to the low watermark.
+ *
+ * @param connection The client connection.
+ * @return 0 if the connection must stay open, -1 if it must be closed.
+ */
+static int serveClient(struct Connection *connection) {
+    struct Session *session = &connection->session;
+
+    while (1) {
+        if (handleRequests(connection) < 0) {
+            errorhandler("Invalid frame received.");
+            return -1;
+        }
+
+        int paused = connection->output.paused;
+        if (flushQueue(connection->socket, &connection->output) < 0) {
+            return -1;
+        }
+        if (connection->closing) {
+            return queueLength(&connection->output) > 0 ? 0 : -1; // Wait for EPOLLOUT
+        }
+        if (connection->output.paused) {
+            return 0; // Wait for EPOLLOUT
+        }
+        if (paused) {
+            continue; // Drained to the low watermark: the requests left can be answered
+        }
+
+        char *space;
+        int spaceLength = inputSpace(session, &space);
+        int bytes_received = recv(connection->socket, space, spaceLength, 0);
+
+        if (bytes_received == 0) {
+            LOG_MESSAGE(LOG_LEVEL_INFO, "Client has closed the connection.");
+            return -1;
+        }
+        if (bytes_received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0; // Wait for EPOLLIN
+            }
+            errorhandler("recv() failed or connection closed prematurely");
+            return -1;
+        }
+
+        commitInput(session, bytes_received);
+    }
+}
+
+/**
+ * @brief Evaluates the received requests while the queue accepts their replies.
+ *
+ * @param connection The client connection.
+ * @return 0 on success, -1 on invalid frames.
+ */
+static int handleRequests(struct Connection *connection) {
+    char request[BUFFERSIZE];
+    struct Output *output;
+    int length;
+
+    while (!connection->closing && (output = queueSpace(&connection->output)) != NULL) {
+        int status = nextRequest(&connection->session, request, &length);
+        if (status <= 0) {
+            return status;
+        }
+        if (status != REQUEST_TEXT) {
+            if (handleBinary(connection, output, status, request, length) < 0) {
+                return -1;
+            }
+        } else {
+            handleRequest(connection, output, request, length);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Evaluates a binary, stream or linear request of the connection and queues the results in the output.
+ *
+ * @param connection The client connection.
+ * @param output The output receiving the reply.
+ * @param type REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR.
+ * @param request The payload of the frame.
+ * @param length The size of the payload.
+ * @return 0 on success, -1 if the payload is malformed.
+ */
+static int handleBinary(struct Connection *connection, struct Output *output, int type, const char *request, int length) {
+    if (queueBinaryReply(output, &connection->session, type, request, length) < 0) {
+        return -1;
+    }
+
+    if (type == REQUEST_BINARY && LOG_SAMPLED(LOG_LEVEL_DEBUG)) {
+        logEvent(LOG_EVENT_BINARY, &connection->address, request, length);
+    }
+    return 0;
+}
+
+/**
+ * @brief Processes a request of the connection and queues the reply in the output.
+ *
+ * @param connection The client connection.
+ * @param output The output receiving the reply.
+ * @param request The NUL-terminated request, overwritten with the result.
+ * @param length The length of the request.
+ */
+static void handleRequest(struct Connection *connection, struct Output *output, char *request, int length) {
+    // A sampled request is logged together with its reply
+    int logged = LOG_SAMPLED(LOG_LEVEL_DEBUG);
+    if (logged) {
+        logEvent(LOG_EVENT_REQUEST, &connection->address, request, length);
+    }
+
+    // Process data according to the logic defined in the function
+    processData(request, length, connection->session.registers);
+
+    if (logged) {
+        logEvent(LOG_EVENT_REPLY, &connection->address, request, (int) strlen(request));
+    }
+
+    queueText(output, &connection->session, request);
+
+    char *byeString = "Bye";
+    if (strcmp(request, byeString) == 0) {
+        connection->closing = 1;
+    }
+}
+
+/**
+ * @brief Moves the deadline of a connection after it made progress.
+ *
+ * A connection in the middle of a request, or with replies the client has not
+ * accepted yet, gets the read timeout, an idle one the idle timeout; neither can
+ * go past the end of the session.
+ *
+ * @param connection The client connection.
+ */
+static void updateDeadline(struct Connection *connection) {
+    struct Reactor *reactor = connection->reactor;
+    int waiting = connection->session.inputLength > 0 || queueLength(&connection->output) > 0;
+    int timeout = waiting ? reactor->timeouts.read : reactor->timeouts.idle;
+    long long deadline = timeout > 0 ? reactor->wheel.now + timeout : -1;
+
+    if (reactor->timeouts.session > 0) {
+        long long end = connection->started + reactor->timeouts.session;
+        if (deadline < 0 || end < deadline) {
+            deadline = end;
+        }
+    }
+
+    if (deadline < 0) {
+        cancelTimer(&reactor->wheel, &connection->timer);
+    } else {
+        scheduleTimer(&reactor->wheel, &connection->timer, deadline);
+    }
+}
+
+/**
+ * @brief Closes a connection whose deadline has passed.
+ *
+ * @param timer The timer of the connection.
+ */
+static void expireConnection(struct Timer *timer) {
+    char msgLog[BUFFERSIZE];
+    struct Connection *connection = timer->owner;
+    struct Reactor *reactor = connection->reactor;
+    const char *reason = "Idle timeout";
+
+    if (reactor->timeouts.session > 0 && reactor->wheel.now >= connection->started + reactor->timeouts.session) {
+        reason = "Session timeout";
+    } else if (connection->session.inputLength > 0 || queueLength(&connection->output) > 0) {
+        reason = "Read timeout";
+    }
+
+    if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+        snprintf(msgLog, sizeof(msgLog), "%s of %s:%d", reason,
+                 connection->addressString, ntohs(connection->address.sin_port));
+        writeLog(msgLog);
+    }
+    closeClient(connection);
+}
+
+/**
+ * @brief Closes the client socket and releases its state.
+ *
+ * Closing the descriptor also removes it from the epoll interest list.
+ *
+ * @param connection The client connection.
+ */
+static void closeClient(struct Connection *connection) {
+    char msgLog[BUFFERSIZE];
+
+    if (connection->reactor != NULL) {
+        cancelTimer(&connection->reactor->wheel, &connection->timer);
+    }
+
+    closesocket(connection->socket);
+    if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+        snprintf(msgLog, sizeof(msgLog), "Closing connection with %s:%d",
+                 connection->addressString, ntohs(connection->address.sin_port));
+        writeLog(msgLog);
+    }
+    freeQueue(&connection->output);
+    closeSession(&connection->session);
+    free(connection);
+}
+
+/**
+ * @brief Sets the O_NONBLOCK flag on a socket.
+ *
+ * @param my_socket The socket descriptor.
+ * @return 0 on success, -1 on failure.
+ */
+static int setNonBlocking(int my_socket) {
+    int flags = fcntl(my_socket, F_GETFL, 0);
+    if (flags < 0) {
+        return -1;
+    }
+    return fcntl(my_socket, F_SETFL, flags | O_NONBLOCK);
+}
@@ -0,0 +1,89 @@
+#ifndef SERVER_REACTOR_H_
+#define SERVER_REACTOR_H_
+
+/**
+ * @file Reactor.h
+ * @brief Header file for the epoll based event loop of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define MAXEVENTS 256           // Maximum number of events handled per epoll_wait()
+#define REACTOR_QUEUE 4096      // Listen queue used when the reactor serves the clients
+
+/**
+ * @brief State kept by the reactor for every connected client.
+ *
+ * Each connection owns its buffers, so no request path touches global storage.
+ */
+struct Connection {
+    int socket;                    // Socket descriptor of the client
+    struct sockaddr_in address;    // Address of the client
+    char addressString[INET_ADDRSTRLEN]; // Printable IP address of the client
+    struct Session session;        // Protocol state and received bytes
+    struct OutputQueue output;     // Replies waiting to be sent to the client
+    int closing;                   // 1 if the connection must be closed after the replies
+    struct Reactor *reactor;       // Reactor serving the client
+    struct Timer timer;            // Deadline of the connection in the wheel of the reactor
+    long long started;             // Time the reactor took the connection over
+};
+
+/**
+ * @brief An epoll instance together with the descriptors it is fed from.
+ *
+ * A reactor either accepts clients from its own listening socket or receives
+ * connections accepted by another thread through its hand-off pipe.
+ */
+struct Reactor {
+    int epoll_fd;           // epoll instance descriptor
+    int listen_socket;      // Listening socket served by this reactor, -1 if none
+    int handoff[2];         // Pipe carrying Connection pointers from a dispatcher, -1 if unused
+    struct Timeouts timeouts; // Deadlines of the clients
+    struct TimerWheel wheel;  // Deadlines of the connections served by this reactor
+    int acceptDelayed;        // 1 while accept() is out of descriptors or memory, retried at every tick
+};
+
+/**
+ * @brief Creates the epoll instance of a reactor and registers its sources.
+ *
+ * @param reactor The reactor to initialize.
+ * @param listen_socket The listening socket to accept from, or -1.
+ * @param handoff 1 to create the hand-off pipe used by a dispatcher thread, 0 otherwise.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return 0 on success, -1 on failure.
+ */
+int initReactor(struct Reactor *reactor, int listen_socket, int handoff, const struct Timeouts *timeouts);
+
+/**
+ * @brief Runs the event loop of an initialized reactor.
+ *
+ * @param reactor The reactor to run.
+ * @return -1 when the loop fails, it never returns otherwise.
+ */
+int runReactorLoop(struct Reactor *reactor);
+
+/**
+ * @brief Runs the edge-triggered epoll event loop on the listening socket.
+ *
+ * The listening socket and all the client sockets are made non-blocking and
+ * multiplexed by a single thread. The function only returns on fatal errors.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if the event loop cannot be started or fails.
+ */
+int runReactor(int my_socket, const struct Timeouts *timeouts);
+
+/**
+ * @brief Hands a connection accepted by another thread over to a reactor.
+ *
+ * Safe to call from any thread; the reactor registers the client in its own loop.
+ *
+ * @param reactor The reactor that will serve the client.
+ * @param client_socket The non-blocking socket of the client.
+ * @param address The address of the client.
+ * @return 0 on success, -1 on failure (the socket is closed).
+ */
+int handOffClient(struct Reactor *reactor, int client_socket, struct sockaddr_in address);
+
+#endif /* SERVER_REACTOR_H_ */
@@ -0,0 +1,171 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Scanner.h"
+#include "Number.h"
+#include "BigInt.h"
+#include "Registers.h"
+
+#include <math.h>       // isfinite()
+
+/**
+ * @file Registers.c
+ * @brief Implementation file for the result registers of a session.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+static int enabled = 0;         // 1 once the sessions keep registers
+
+static int isNameCharacter(char c);
+
+/**
+ * @brief Turns on the registers of the sessions created from now on.
+ */
+void enableRegisters(void) {
+    enabled = 1;
+}
+
+/**
+ * @brief Allocates the registers of a new session.
+ *
+ * @return The empty registers, NULL if they are not enabled or the memory is exhausted.
+ */
+struct Registers *createRegisters(void) {
+    if (!enabled) {
+        return NULL;
+    }
+    struct Registers *registers = malloc(sizeof(struct Registers));
+    if (registers != NULL) {
+        clearRegisters(registers);
+    }
+    return registers;
+}
+
+/**
+ * @brief Releases the registers of a session.
+ *
+ * @param registers The registers, may be NULL.
+ */
+void freeRegisters(struct Registers *registers) {
+    free(registers);
+}
+
+/**
+ * @brief Empties the registers and restarts the numbering from 1.
+ *
+ * The texts are left as they are: only the registers numbered from now on are read.
+ *
+ * @param registers The registers.
+ */
+void clearRegisters(struct Registers *registers) {
+    registers->count = 0;
+}
+
+/**
+ * @brief Replaces the references to the registers in the text of an operation.
+ *
+ * A reference is REGISTER_PREFIX followed by the number of an operation or by
+ * REGISTER_LAST, up to the first character that is not a letter or a digit, so
+ * "X $1*2" refers to $1. The text is copied up to its end or its first NUL.
+ *
+ * @param registers The registers.
+ * @param text The first character of the text.
+ * @param length The number of characters of the text.
+ * @param expanded Buffer of BUFFERSIZE bytes receiving the terminated text.
+ * @param expandedLength Receives the length of the expanded text.
+ * @param errorPosition Receives the offset in the text of a reference that failed.
+ * @return CALC_OK, CALC_INVALID_REGISTER if a reference names no kept result or
+ *         CALC_TOO_MANY_OPERANDS if the expanded text does not fit.
+ */
+int expandRegisters(const struct Registers *registers, const char *text, int length,
+                    char *expanded, int *expandedLength, int *errorPosition) {
+    int written = 0;
+
+    for (int i = 0; i < length && text[i] != '\0'; i++) {
+        int position = i;
+        const char *copy = text + i;
+        int copyLength = 1;
+
+        if (text[i] == REGISTER_PREFIX) {
+            const char *name = text + i + 1;
+            while (i + 1 < length && isNameCharacter(text[i + 1])) {
+                i++;
+            }
+            int nameLength = i - position;
+            long long number = -1;
+
+            if (nameLength == (int) strlen(REGISTER_LAST) && memcmp(name, REGISTER_LAST, nameLength) == 0) {
+                number = registers->count;
+            } else if (nameLength > 0 && nameLength <= 18) {
+                number = 0;
+                for (int j = 0; j < nameLength && number >= 0; j++) {
+                    number = name[j] >= '0' && name[j] <= '9' ? number * 10 + (name[j] - '0') : -1;
+                }
+            }
+
+            // Only the last REGISTERS operations are kept, and only the successful ones
+            if (number < 1 || number > registers->count || number <= registers->count - REGISTERS
+                || registers->lengths[number % REGISTERS] < 0) {
+                *errorPosition = position;
+                return CALC_INVALID_REGISTER;
+            }
+            copy = registers->values[number % REGISTERS];
+            copyLength = registers->lengths[number % REGISTERS];
+        }
+
+        if (written + copyLength > BUFFERSIZE - 1) {
+            *errorPosition = position;
+            return CALC_TOO_MANY_OPERANDS;
+        }
+        memcpy(expanded + written, copy, copyLength);
+        written += copyLength;
+    }
+
+    expanded[written] = '\0';
+    *expandedLength = written;
+    return CALC_OK;
+}
+
+/**
+ * @brief Numbers an evaluated operation and keeps its result in the next register.
+ *
+ * @param registers The registers, NULL to do nothing.
+ * @param scanner The scanner the operation was read with.
+ * @param operation The operation, or NULL if it could not be read.
+ * @param status The CALC_ code of the evaluation.
+ * @param result The result when the status is CALC_OK.
+ */
+void saveRegister(struct Registers *registers, const struct Scanner *scanner,
+                  const struct Operation *operation, int status, double result) {
+    if (registers == NULL) {
+        return;
+    }
+
+    int slot = (int) (++registers->count % REGISTERS);
+    char *value = registers->values[slot];
+    int length = -1;
+
+    if (status == CALC_OK && operation != NULL) {
+        if (operation->wide) {
+            // Integers past 64 bits are calculated again, exactly unless they are divided
+            if (calculateBig(scanner, operation, NUMBER_SHORTEST, value, BUFFERSIZE) == CALC_OK) {
+                length = (int) strlen(value);
+            }
+        } else if (operation->integer) {
+            length = formatInteger(value, BUFFERSIZE, operation->integerResult, NUMBER_SHORTEST);
+        } else if (isfinite(result)) {
+            length = formatShortest(value, result);
+        }
+    }
+    registers->lengths[slot] = (short) (length < BUFFERSIZE ? length : -1);
+}
+
+/**
+ * @brief Tells whether a character can be part of the name of a register.
+ *
+ * @param c The character.
+ * @return 1 for a letter or a digit, 0 otherwise.
+ */
+static int isNameCharacter(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
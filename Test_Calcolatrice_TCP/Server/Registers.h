@@ -0,0 +1,89 @@
+#ifndef SERVER_REGISTERS_H_
+#define SERVER_REGISTERS_H_
+
+/**
+ * @file Registers.h
+ * @brief Header file for the result registers of a session.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * In session mode every operation a client sends, alone or inside a batch, is
+ * numbered from 1 and its result is kept in a register: "$3" stands for the
+ * result of the third operation and "$last" for that of the one before, so a
+ * client can pipeline a chain of operations instead of waiting for each result.
+ * The references are replaced by the exact text of the results before the
+ * operation is read, so they work as operands of any operation or expression.
+ * Only the last REGISTERS results are kept; a failed operation leaves its
+ * register empty.
+ */
+
+#define REGISTERS 16            // Results kept by a session
+#define REGISTER_PREFIX '$'     // First character of a reference to a register
+#define REGISTER_LAST "last"    // Name of the register of the previous operation
+
+/**
+ * @brief The registers of a session.
+ */
+struct Registers {
+    long long count;                    // Operations numbered so far: the last one is $count
+    short lengths[REGISTERS];           // Length of every result, -1 if its operation failed
+    char values[REGISTERS][BUFFERSIZE]; // Exact text of the results, $n in values[n % REGISTERS]
+};
+
+/**
+ * @brief Turns on the registers of the sessions created from now on.
+ */
+void enableRegisters(void);
+
+/**
+ * @brief Allocates the registers of a new session.
+ *
+ * @return The empty registers, NULL if they are not enabled or the memory is exhausted.
+ */
+struct Registers *createRegisters(void);
+
+/**
+ * @brief Releases the registers of a session.
+ *
+ * @param registers The registers, may be NULL.
+ */
+void freeRegisters(struct Registers *registers);
+
+/**
+ * @brief Empties the registers and restarts the numbering from 1.
+ *
+ * @param registers The registers.
+ */
+void clearRegisters(struct Registers *registers);
+
+/**
+ * @brief Replaces the references to the registers in the text of an operation.
+ *
+ * @param registers The registers.
+ * @param text The first character of the text.
+ * @param length The number of characters of the text.
+ * @param expanded Buffer of BUFFERSIZE bytes receiving the terminated text.
+ * @param expandedLength Receives the length of the expanded text.
+ * @param errorPosition Receives the offset in the text of a reference that failed.
+ * @return CALC_OK, CALC_INVALID_REGISTER if a reference names no kept result or
+ *         CALC_TOO_MANY_OPERANDS if the expanded text does not fit.
+ */
+int expandRegisters(const struct Registers *registers, const char *text, int length,
+                    char *expanded, int *expandedLength, int *errorPosition);
+
+/**
+ * @brief Numbers an evaluated operation and keeps its result in the next register.
+ *
+ * Integers are kept exactly, other results with the shortest digits that read back
+ * to the same double, so the precision of the replies does not round them.
+ *
+ * @param registers The registers, NULL to do nothing.
+ * @param scanner The scanner the operation was read with.
+ * @param operation The operation, or NULL if it could not be read.
+ * @param status The CALC_ code of the evaluation.
+ * @param result The result when the status is CALC_OK.
+ */
+void saveRegister(struct Registers *registers, const struct Scanner *scanner,
+                  const struct Operation *operation, int status, double result);
+
+#endif /* SERVER_REGISTERS_H_ */
@@ -0,0 +1,273 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Log.h"
+#include "ResultCache.h"
+
+/**
+ * @file ResultCache.c
+ * @brief Implementation file for the cache of the replies to repeated requests.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define FNV_OFFSET 14695981039346656037ULL // Initial value of the FNV-1a hash
+#define FNV_PRIME 1099511628211ULL         // Multiplier of the FNV-1a hash
+
+/**
+ * @brief A cached reply.
+ */
+struct CacheEntry {
+    unsigned char keyLength;    // Characters of the normalized request
+    unsigned char replyLength;  // Characters of the reply
+    char key[CACHE_KEY];        // Normalized request, not terminated
+    char reply[CACHE_REPLY];    // Terminated reply
+};
+
+/**
+ * @brief A set of entries sharing a lock and a CLOCK hand.
+ *
+ * The hashes are kept apart from the entries, so a lookup compares them all
+ * within one cache line and touches a single entry on a match.
+ */
+struct CacheSet {
+    uint64_t hashes[CACHE_WAYS];        // Hash of the request of every entry in use
+    unsigned char lock;                 // 1 while a thread works on the set
+    unsigned char used;                 // Entries in use, filled in order
+    unsigned char hand;                 // Next entry the CLOCK considers for replacement
+    unsigned char referenced;           // One bit per entry found since the hand last passed
+    unsigned long long hits;            // Lookups of the set that found a reply
+    unsigned long long misses;          // Lookups of the set that did not
+    struct CacheEntry entries[CACHE_WAYS];
+};
+
+static struct CacheSet *sets = NULL;    // The cache, NULL when it is disabled
+static uint64_t setMask = 0;            // Number of sets minus one
+
+static void lockSet(struct CacheSet *set);
+static void unlockSet(struct CacheSet *set);
+static int findEntry(const struct CacheSet *set, const struct CacheKey *key);
+
+/**
+ * @brief Allocates the cache.
+ *
+ * @param entries The entries the cache can hold, rounded up to a power of two sets.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ */
+int createResultCache(int entries) {
+    if (entries <= 0 || sets != NULL) {
+        return 0;
+    }
+
+    uint64_t count = 1;
+    while (count * CACHE_WAYS < (uint64_t) entries) {
+        count <<= 1;
+    }
+    sets = calloc(count, sizeof(struct CacheSet));
+    if (sets == NULL) {
+        return -1;
+    }
+    setMask = count - 1;
+    atexit(logResultCacheStats);
+    return 0;
+}
+
+/**
+ * @brief Normalizes a request into the key of its reply.
+ *
+ * The text and its hash are built in the same pass over the request, which
+ * stops at the first NUL.
+ *
+ * @param msg The request.
+ * @param length The characters of the request.
+ * @param key Receives the normalized request.
+ * @return 0 on success, -1 if the cache is disabled or the request is too long.
+ */
+int makeCacheKey(const char *msg, int length, struct CacheKey *key) {
+    if (sets == NULL) {
+        return -1;
+    }
+
+    uint64_t hash = FNV_OFFSET;
+    int keyLength = 0;
+    int space = 0;
+    key->exact = 1;
+    for (int i = 0; i < length && msg[i] != '\0'; i++) {
+        char c = msg[i];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+            space++;
+            continue;
+        }
+        if (space > 0 && keyLength > 0) {
+            if (keyLength == CACHE_KEY) {
+                return -1;
+            }
+            key->text[keyLength++] = ' ';
+            hash = (hash ^ ' ') * FNV_PRIME;
+            if (space > 1 || msg[i - 1] != ' ') {
+                key->exact = 0;
+            }
+        }
+        space = 0;
+        if (keyLength == CACHE_KEY) {
+            return -1;
+        }
+        key->text[keyLength++] = c;
+        hash = (hash ^ (unsigned char) c) * FNV_PRIME;
+    }
+    key->hash = hash;
+    key->length = keyLength;
+    return 0;
+}
+
+/**
+ * @brief Copies the reply cached for a request.
+ *
+ * A thread logs the counters every CACHE_REPORT lookups it makes.
+ *
+ * @param key The normalized request.
+ * @param reply Receives the terminated reply.
+ * @return The length of the reply, -1 if it is not cached.
+ */
+int lookupResult(const struct CacheKey *key, char *reply) {
+    static _Thread_local unsigned int lookups; // Lookups made by the calling thread
+    struct CacheSet *set = &sets[key->hash & setMask];
+    int replyLength = -1;
+
+    lockSet(set);
+    int way = findEntry(set, key);
+    if (way >= 0) {
+        replyLength = set->entries[way].replyLength;
+        memcpy(reply, set->entries[way].reply, replyLength + 1);
+        set->referenced |= (unsigned char) (1u << way);
+        __atomic_store_n(&set->hits, set->hits + 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_store_n(&set->misses, set->misses + 1, __ATOMIC_RELAXED);
+    }
+    unlockSet(set);
+
+    if (++lookups % CACHE_REPORT == 0) {
+        logResultCacheStats();
+    }
+    return replyLength;
+}
+
+/**
+ * @brief Caches the reply to a request, replacing an entry of its set if it is full.
+ *
+ * A request cached meanwhile by another thread gets the new reply in its entry,
+ * otherwise the CLOCK hand skips the entries found since it last passed, clearing
+ * their bit, and replaces the first one that was not.
+ *
+ * @param key The normalized request.
+ * @param reply The terminated reply.
+ */
+void storeResult(const struct CacheKey *key, const char *reply) {
+    size_t replyLength = strlen(reply);
+    if (replyLength >= CACHE_REPLY) {
+        return;
+    }
+
+    struct CacheSet *set = &sets[key->hash & setMask];
+    lockSet(set);
+    int way = findEntry(set, key);
+    if (way < 0) {
+        if (set->used < CACHE_WAYS) {
+            way = set->used++;
+        } else {
+            while (set->referenced & (1u << set->hand)) {
+                set->referenced &= (unsigned char) ~(1u << set->hand);
+                set->hand = (unsigned char) ((set->hand + 1) % CACHE_WAYS);
+            }
+            way = set->hand;
+            set->hand = (unsigned char) ((set->hand + 1) % CACHE_WAYS);
+        }
+        set->hashes[way] = key->hash;
+        set->referenced &= (unsigned char) ~(1u << way);
+    }
+
+    struct CacheEntry *entry = &set->entries[way];
+    entry->keyLength = (unsigned char) key->length;
+    memcpy(entry->key, key->text, key->length);
+    entry->replyLength = (unsigned char) replyLength;
+    memcpy(entry->reply, reply, replyLength + 1);
+    unlockSet(set);
+}
+
+/**
+ * @brief Reads the counters of the cache.
+ *
+ * The counters of every set are added without taking the locks, so the totals
+ * may miss the lookups in progress.
+ *
+ * @param hits Receives the lookups that found a reply.
+ * @param misses Receives the lookups that did not.
+ */
+void getResultCacheStats(unsigned long long *hits, unsigned long long *misses) {
+    *hits = 0;
+    *misses = 0;
+    if (sets == NULL) {
+        return;
+    }
+    for (uint64_t i = 0; i <= setMask; i++) {
+        *hits += __atomic_load_n(&sets[i].hits, __ATOMIC_RELAXED);
+        *misses += __atomic_load_n(&sets[i].misses, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Writes the counters of the cache to the log.
+ */
+void logResultCacheStats(void) {
+    char msgLog[BUFFERSIZE];
+    unsigned long long hits;
+    unsigned long long misses;
+
+    if (!LOG_ENABLED(LOG_LEVEL_INFO)) {
+        return;
+    }
+    getResultCacheStats(&hits, &misses);
+    snprintf(msgLog, sizeof(msgLog), "Result cache: %llu hits, %llu misses (%.1f%% hit rate)",
+             hits, misses, hits + misses > 0 ? 100.0 * (double) hits / (double) (hits + misses) : 0.0);
+    writeLog(msgLog);
+}
+
+/**
+ * @brief Finds the entry of a request in its set.
+ *
+ * @param set The set, locked by the caller.
+ * @param key The normalized request.
+ * @return The index of the entry, -1 if the request is not cached.
+ */
+static int findEntry(const struct CacheSet *set, const struct CacheKey *key) {
+    for (int way = 0; way < set->used; way++) {
+        if (set->hashes[way] == key->hash && set->entries[way].keyLength == key->length
+            && memcmp(set->entries[way].key, key->text, key->length) == 0) {
+            return way;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Takes the lock of a set, spinning while another thread holds it.
+ *
+ * The lock is only held to copy a few bytes, so waiting on it is shorter than
+ * sleeping in the kernel.
+ *
+ * @param set The set.
+ */
+static void lockSet(struct CacheSet *set) {
+    while (__atomic_exchange_n(&set->lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&set->lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+/**
+ * @brief Releases the lock of a set.
+ *
+ * @param set The set.
+ */
+static void unlockSet(struct CacheSet *set) {
+    __atomic_store_n(&set->lock, 0, __ATOMIC_RELEASE);
+}
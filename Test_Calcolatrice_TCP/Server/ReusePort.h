@@ -0,0 +1,27 @@
+#ifndef SERVER_REUSEPORT_H_
+#define SERVER_REUSEPORT_H_
+
+/**
+ * @file ReusePort.h
+ * @brief Header file for the SO_REUSEPORT sharded mode of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define MAXSHARDS 256           // Maximum number of independent reactors
+
+/**
+ * @brief Serves the clients with independent reactors sharing the server port.
+ *
+ * Every shard owns a listening socket bound with SO_REUSEPORT and a thread running
+ * its reactor, so the kernel spreads the connections with no shared accept queue.
+ *
+ * @param shards The number of reactors to start (1..MAXSHARDS).
+ * @param pinThreads 1 to pin the thread of shard i to CPU i, 0 otherwise.
+ * @param steering 1 to attach a BPF program that keeps a flow on the receiving CPU.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if the shards cannot be started.
+ */
+int runReusePortShards(int shards, int pinThreads, int steering, const struct Timeouts *timeouts);
+
+#endif /* SERVER_REUSEPORT_H_ */
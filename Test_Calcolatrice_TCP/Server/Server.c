@@ -1,6 +1,29 @@
 #include "Headers.h"
 #include "Server.h"
 #include "Calculator.h"
+#include "Session.h"
+#include "Binary.h"
+#include "Scanner.h"
+#include "Expression.h"
+#include "Number.h"
+#include "BigInt.h"
+#include "ResultCache.h"
+#include "Registers.h"
+#include "Log.h"
+#if defined __linux__
+#include "Output.h"
+#include "TimerWheel.h"
+#include "Reactor.h"
+#include "WorkerPool.h"
+#include "ReusePort.h"
+#include "Uring.h"
+#endif
+
+#include <errno.h>      // Error numbers of the timed out calls
+
+
+const char welcomeBlock[BUFFERSIZE] = WELCOME_MSG; // Banner padded with zeros to BUFFERSIZE bytes
+static int resultPrecision = RESULT_PRECISION;     // Decimals of the results in the text replies
 
 /**
  * @file Server.c
@@ -15,7 +38,10 @@
  * This function initializes the WSA library (if on Windows), creates a socket,
  * binds the socket, sets the socket to listen mode, and accepts incoming connections.
  * It then communicates with the connected clients, processing their requests until
- * the client sends "=" to close the connection.
+ * the client sends "=" to close the connection. The clients are served by the epoll
+ * reactor on Linux, by a pool of reactors with "--threads[=N]", by independent
+ * SO_REUSEPORT listeners with "--reuseport[=N]", by io_uring with "--uring", and one
+ * at a time elsewhere or when "--blocking" is passed.
  *
  * @param argc The number of command-line arguments.
  * @param argv An array of command-line argument strings.
@@ -23,9 +49,31 @@
  */
 int main(int argc, char *argv[]) {
     printf("Look at the log file!");
+    struct ServerOptions options;
+    parseOptions(argc, argv, &options);
+    setLogLevel(options.logLevel, options.logSampling);
+    resultPrecision = options.precision;
+    setLogSegments(options.logSegments, options.logSegmentSize);
+    openLog(options.logFormat);
+    if (createResultCache(options.cacheEntries) != 0) {
+        LOG_MESSAGE(LOG_LEVEL_WARN, "The result cache cannot be allocated, requests are computed every time.");
+    }
+    if (options.registers) {
+        enableRegisters();
+    }
+
     // 0) Initialize the WSA library in case we are on Windows
     checkWindowDevice();
 
+#if defined __linux__
+    setOutputMemoryLimit((long long) options.outputMemory << 20);
+
+    if (options.mode == MODE_REUSEPORT) {
+        // 1-4) Every shard creates, binds and listens on its own socket
+        return runReusePortShards(options.workers, options.pinThreads, options.steering, &options.timeouts);
+    }
+#endif
+
     // 1) Create a socket
     int my_socket = -1;
     my_socket = createSocket(my_socket);
@@ -33,17 +81,170 @@ int main(int argc, char *argv[]) {
     // 2) Bind the socket
     struct sockaddr_in sad = bindSocket(my_socket, sad);
 
+#if defined __linux__
+    if (options.mode == MODE_EPOLL || options.mode == MODE_THREADS) {
+        // 3) Set the socket to listen mode with a queue sized for many clients
+        setSocketOnListen(my_socket, REACTOR_QUEUE);
+
+        // 4) Serve every client from the event loop(s)
+        int result = options.mode == MODE_EPOLL ? runReactor(my_socket, &options.timeouts)
+                                                : runWorkerPool(my_socket, options.workers, &options.timeouts);
+        closesocket(my_socket);
+        clearwinsock();
+        return result;
+    }
+
+    if (options.mode == MODE_URING) {
+        // 3) Set the socket to listen mode with a queue sized for many clients
+        setSocketOnListen(my_socket, REACTOR_QUEUE);
+
+        // 4) Serve every client from the ring, or from the reactor on older kernels
+        int result = runUringServer(my_socket, &options.timeouts);
+        if (result == URING_UNAVAILABLE) {
+            LOG_MESSAGE(LOG_LEVEL_WARN, "io_uring is not available, using the epoll reactor.");
+            result = runReactor(my_socket, &options.timeouts);
+        }
+        closesocket(my_socket);
+        clearwinsock();
+        return result;
+    }
+#endif
+
     // 3) Set the socket to listen mode
-    setSocketOnListen(my_socket);
+    setSocketOnListen(my_socket, QUEUE);
+
+    return runBlockingServer(my_socket, &options.timeouts);
+}
+
+/**
+ * @brief Parses the command line into the server options.
+ *
+ * "--blocking" selects the original one-client-at-a-time loop, "--epoll" the reactor,
+ * "--threads[=N]" N reactor threads fed by one acceptor and "--reuseport[=N]" N reactors
+ * with their own listener (one per online CPU if N is omitted), "--uring" the io_uring
+ * backend. "--pin" pins the reuseport threads to the CPUs and "--steer" keeps each
+ * flow on its receiving CPU. "--idle-timeout=S", "--read-timeout=S" and
+ * "--session-timeout=S" set the deadlines of the clients in seconds (0 disables one),
+ * "--output-memory=M" the MiB the replies waiting for slow clients may take.
+ * "--log=binary" writes the log as binary records, decoded later by LogDecoder.
+ * "--log-level=L" keeps the messages up to level L (error, warn, info, debug, trace)
+ * and "--log-sample=N" logs 1 request in N. "--log-segments=N" keeps the log in N
+ * rotating segments of "--log-segment-size=M" MiB each. "--precision=N" writes the
+ * results with N decimals (0 to NUMBER_MAXPRECISION), "--precision=shortest" with the
+ * fewest digits that read back to the same double. "--cache=N" keeps the replies to
+ * the last N distinct requests and answers the repeated ones without computing them.
+ * "--registers" keeps the results of every connection, which its requests can use
+ * as "$1" or "$last".
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @param options The options to fill (epoll mode by default on Linux, blocking elsewhere).
+ */
+void parseOptions(int argc, char *argv[], struct ServerOptions *options) {
+#if defined __linux__
+    options->mode = MODE_EPOLL;
+    options->workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    options->mode = MODE_BLOCKING;
+    options->workers = 1;
+#endif
+    options->pinThreads = 0;
+    options->steering = 0;
+    options->timeouts.idle = IDLE_TIMEOUT * 1000;
+    options->timeouts.read = READ_TIMEOUT * 1000;
+    options->timeouts.session = 0;
+    options->outputMemory = OUTPUT_MEMORY;
+    options->logFormat = LOG_FORMAT_TEXT;
+    options->logLevel = LOG_LEVEL_DEBUG;
+    options->logSampling = 1;
+    options->precision = RESULT_PRECISION;
+    options->logSegments = 0;
+    options->logSegmentSize = LOG_SEGMENT_SIZE;
+    options->cacheEntries = 0;
+    options->registers = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--blocking") == 0) {
+            options->mode = MODE_BLOCKING;
+        } else if (strncmp(argv[i], "--idle-timeout=", 15) == 0) {
+            options->timeouts.idle = atoi(argv[i] + 15) * 1000;
+        } else if (strncmp(argv[i], "--read-timeout=", 15) == 0) {
+            options->timeouts.read = atoi(argv[i] + 15) * 1000;
+        } else if (strncmp(argv[i], "--session-timeout=", 18) == 0) {
+            options->timeouts.session = atoi(argv[i] + 18) * 1000;
+        } else if (strcmp(argv[i], "--log=binary") == 0) {
+            options->logFormat = LOG_FORMAT_BINARY;
+        } else if (strcmp(argv[i], "--log=text") == 0) {
+            options->logFormat = LOG_FORMAT_TEXT;
+        } else if (strncmp(argv[i], "--log-level=", 12) == 0 && parseLogLevel(argv[i] + 12) >= 0) {
+            options->logLevel = parseLogLevel(argv[i] + 12);
+        } else if (strncmp(argv[i], "--log-sample=", 13) == 0) {
+            options->logSampling = atoi(argv[i] + 13);
+        } else if (strcmp(argv[i], "--precision=shortest") == 0) {
+            options->precision = NUMBER_SHORTEST;
+        } else if (strncmp(argv[i], "--precision=", 12) == 0) {
+            options->precision = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--cache=", 8) == 0) {
+            options->cacheEntries = atoi(argv[i] + 8);
+        } else if (strcmp(argv[i], "--registers") == 0) {
+            options->registers = 1;
+#if defined __linux__
+        } else if (strcmp(argv[i], "--epoll") == 0) {
+            options->mode = MODE_EPOLL;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            options->mode = MODE_THREADS;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            options->mode = MODE_THREADS;
+            options->workers = atoi(argv[i] + 10);
+        } else if (strcmp(argv[i], "--reuseport") == 0) {
+            options->mode = MODE_REUSEPORT;
+        } else if (strncmp(argv[i], "--reuseport=", 12) == 0) {
+            options->mode = MODE_REUSEPORT;
+            options->workers = atoi(argv[i] + 12);
+        } else if (strcmp(argv[i], "--uring") == 0) {
+            options->mode = MODE_URING;
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            options->pinThreads = 1;
+        } else if (strcmp(argv[i], "--steer") == 0) {
+            options->steering = 1;
+        } else if (strncmp(argv[i], "--output-memory=", 16) == 0) {
+            options->outputMemory = atoi(argv[i] + 16);
+        } else if (strncmp(argv[i], "--log-segments=", 15) == 0) {
+            options->logSegments = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--log-segment-size=", 19) == 0) {
+            options->logSegmentSize = atoi(argv[i] + 19);
+#endif
+        } else {
+            printf("\nUnknown or unsupported option: %s", argv[i]);
+        }
+    }
+
+    if (options->workers < 1) {
+        options->workers = 1;
+    }
+    if (options->precision < NUMBER_SHORTEST || options->precision > NUMBER_MAXPRECISION) {
+        options->precision = RESULT_PRECISION;
+    }
+}
 
+/**
+ * @brief Serves one client at a time using blocking socket calls.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if accept() fails, it never returns otherwise.
+ */
+int runBlockingServer(int my_socket, const struct Timeouts *timeouts) {
+    char msg[BUFFERSIZE];      // Message Array
+    char msgLog[BUFFERSIZE];   // Message Log
+    char output[OUTPUTBUFFER]; // Replies batched for a single send
+    struct Session session;    // Protocol state of the client
     struct sockaddr_in cad;    // Structure for the client's address
     int client_socket;     // Socket descriptor for the client
     int client_len;     // Size of the client's address
 
-
     while (1) {
-        sprintf(msgLog,"Searching for a client...");
-        writeLog(msgLog);
+        LOG_MESSAGE(LOG_LEVEL_INFO, "Searching for a client...");
         client_len = sizeof(cad); // Set the client's size
 
         // 4) Accept a connection
@@ -56,54 +257,121 @@ int main(int argc, char *argv[]) {
 
         // 5) Server sends a connection string
 
-        sprintf(msgLog,"Connection established with %s:%d", inet_ntoa(cad.sin_addr),ntohs(cad.sin_port));
-        writeLog(msgLog);
+        if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+            sprintf(msgLog,"Connection established with %s:%d", inet_ntoa(cad.sin_addr),ntohs(cad.sin_port));
+            writeLog(msgLog);
+        }
+
+        // A client that stops reading its replies is dropped after the read timeout
+        long long started = monotonicMs();
+        int receiveTimeout = 0;
+        setSocketTimeout(client_socket, SO_SNDTIMEO, timeouts->read);
 
         // Send Welcome Message
         sendWelcomeMsg(client_socket);
 
         // Receive and process data from the client until the client sends "="
-        while (1) {
-            int bytes_received = recv(client_socket, msg,sizeof(char) * BUFFERSIZE, 0);
+        initSession(&session);
+        int closing = 0;
+        while (!closing) {
+            // Evaluate every complete request received so far, batching the replies
+            int outputLength = 0;
+            int requestLength;
+            int status = 0;
+            while (!closing && outputLength + MAXREPLYSIZE <= OUTPUTBUFFER
+                   && (status = nextRequest(&session, msg, &requestLength)) > 0) {
+                if (status != REQUEST_TEXT) {
+                    int replyLength = answerBinary(&session, status, msg, requestLength, output + outputLength);
+                    if (replyLength < 0) {
+                        status = -1;
+                        break;
+                    }
+                    outputLength += replyLength;
+
+                    if (status == REQUEST_BINARY && LOG_SAMPLED(LOG_LEVEL_DEBUG)) {
+                        logEvent(LOG_EVENT_BINARY, &cad, msg, requestLength);
+                    }
+                    continue;
+                }
 
-            if (bytes_received <= 0) {
-                if (bytes_received == 0) {
-                    sprintf(msgLog,"Client has closed the connection.");
-                    writeLog(msgLog);
-                } else {
-                    errorhandler("recv() failed or connection closed prematurely");
+                // A sampled request is logged together with its reply
+                int logged = LOG_SAMPLED(LOG_LEVEL_DEBUG);
+                if (logged) {
+                    logEvent(LOG_EVENT_REQUEST, &cad, msg, requestLength);
                 }
-                closesocket(client_socket);
-                clearwinsock();
-                break; // Exit the loop
-            }
 
-            snprintf(msgLog, sizeof(msgLog),"Client: %s:%d send: %s", inet_ntoa(cad.sin_addr), ntohs(cad.sin_port), msg);
-            writeLog(msgLog);
+                // Process data according to the logic defined in the function
+                processData(msg, requestLength, session.registers);
 
-            // Process data according to the logic defined in the function
-            processData(msg);
+                if (logged) {
+                    logEvent(LOG_EVENT_REPLY, &cad, msg, (int) strlen(msg));
+                }
 
-            snprintf(msgLog, sizeof(msgLog),"Server: %s:%d said: %s", inet_ntoa(cad.sin_addr), ntohs(cad.sin_port), msg);
-            writeLog(msgLog);
+                outputLength += encodeReply(&session, msg, output + outputLength);
 
-            // Send processed data back to the client
-            if (send(client_socket, msg, sizeof(char) * BUFFERSIZE,0) != sizeof(char) * BUFFERSIZE) {
-                errorhandler("send() sent a different number of bytes than expected");
-                closesocket(client_socket);
-                clearwinsock();
+                char *byeString = "Bye";
+                if (strcmp(msg, byeString) == 0) {
+                    closing = 1; // Exit the loop if the server sends "Bye"
+                }
+            }
+
+            // Send the processed data back to the client
+            if (outputLength > 0 && sendAll(client_socket, output, outputLength) < 0) {
+                errorhandler("send() failed or the client stopped reading");
+                break; // Exit the loop
+            }
+            if (status < 0) {
+                errorhandler("Invalid frame received.");
                 break; // Exit the loop
             }
+            if (closing || status > 0) {
+                continue; // The batch was full: more requests may be waiting
+            }
+
+            // The next recv() waits for the idle or the read timeout, never past the session
+            int timeout = session.inputLength > 0 ? timeouts->read : timeouts->idle;
+            if (timeouts->session > 0) {
+                int left = timeouts->session - (int) (monotonicMs() - started);
+                if (left <= 0) {
+                    LOG_MESSAGE(LOG_LEVEL_INFO, "Session timeout, closing the connection.");
+                    break; // Exit the loop
+                }
+                if (timeout == 0 || left < timeout) {
+                    timeout = left;
+                }
+            }
+            if (timeout != receiveTimeout && setSocketTimeout(client_socket, SO_RCVTIMEO, timeout) == 0) {
+                receiveTimeout = timeout;
+            }
 
-            char *byeString = "Bye";
-            if (strcmp(msg, byeString) == 0) {
-                break; // Exit the loop if the server sends "Bye"
+            // No complete request left: read more bytes from the client
+            char *space;
+            int spaceLength = inputSpace(&session, &space);
+            int bytes_received = recv(client_socket, space, spaceLength, 0);
+
+            if (bytes_received <= 0) {
+                if (bytes_received == 0) {
+                    LOG_MESSAGE(LOG_LEVEL_INFO, "Client has closed the connection.");
+#if defined WIN32
+                } else if (WSAGetLastError() == WSAETIMEDOUT) {
+#else
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+#endif
+                    LOG_MESSAGE(LOG_LEVEL_INFO, "Client timed out, closing the connection.");
+                } else {
+                    errorhandler("recv() failed or connection closed prematurely");
+                }
+                break; // Exit the loop
             }
+            commitInput(&session, bytes_received);
         }
-        sprintf(msgLog,"Closing connection with %s:%d", inet_ntoa(cad.sin_addr),ntohs(cad.sin_port));
         // Close the client socket and wait for the next connection
+        closeSession(&session);
         closesocket(client_socket);
-        writeLog(msgLog);
+        if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+            sprintf(msgLog,"Closing connection with %s:%d", inet_ntoa(cad.sin_addr),ntohs(cad.sin_port));
+            writeLog(msgLog);
+        }
     }
 }
 
@@ -113,14 +381,59 @@ int main(int argc, char *argv[]) {
  * @param client_socket The socket descriptor for the connected client.
  */
 void sendWelcomeMsg(int client_socket) {
-    char welcomeString[] =
-            "\n* * * * * * * * * * * * * * * * * * * * * * * *\n"
-            "*   Francesco Conforti - Matricola: 776628    *\n"
-            "*             Basic Calculator                *\n"
-            "*      Supported operations: +, -, *, /       *\n"
-            "*      Enter = to close the connection        *\n"
-            "* * * * * * * * * * * * * * * * * * * * * * * *";
-    send(client_socket, welcomeString, sizeof(char) * BUFFERSIZE, 0);
+    sendAll(client_socket, welcomeBlock, sizeof(char) * BUFFERSIZE);
+}
+
+/**
+ * @brief Sends a whole buffer on a blocking socket, resuming after short sends.
+ *
+ * A blocking send() only returns early when interrupted or when the send timeout
+ * expires with part of the buffer accepted, so the rest is sent again until the
+ * timeout expires without progress.
+ *
+ * @param my_socket The socket descriptor.
+ * @param data The bytes to send.
+ * @param length The number of bytes to send.
+ * @return 0 on success, -1 if the socket fails or the send timeout expires.
+ */
+int sendAll(int my_socket, const char *data, int length) {
+    while (length > 0) {
+        int bytes_sent = send(my_socket, data, length, 0);
+        if (bytes_sent <= 0) {
+#if !defined WIN32
+            if (bytes_sent < 0 && errno == EINTR) {
+                continue;
+            }
+#endif
+            return -1;
+        }
+        data += bytes_sent;
+        length -= bytes_sent;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sets the time a blocking recv() or send() waits before failing.
+ *
+ * @param my_socket The socket descriptor.
+ * @param option SO_RCVTIMEO or SO_SNDTIMEO.
+ * @param milliseconds The timeout, 0 to wait forever.
+ * @return 0 on success, -1 on failure.
+ */
+int setSocketTimeout(int my_socket, int option, int milliseconds) {
+#if defined WIN32
+    DWORD timeout = (DWORD) milliseconds;
+#else
+    struct timeval timeout;
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_usec = (milliseconds % 1000) * 1000;
+#endif
+    if (setsockopt(my_socket, SOL_SOCKET, option, (const char*) &timeout, sizeof(timeout)) < 0) {
+        errorhandler("setsockopt() of the socket timeout failed.");
+        return -1;
+    }
+    return 0;
 }
 
 /**
@@ -153,12 +466,30 @@ int createSocket(int my_socket) {
         clearwinsock();
         return -1;
     } else {
-        sprintf(msgLog,"Socket created successfully!");
-        writeLog(msgLog);
+        LOG_MESSAGE(LOG_LEVEL_INFO, "Socket created successfully!");
     }
+
+    // Allow the server to restart while old connections are still in TIME_WAIT
+    int on = 1;
+    setsockopt(my_socket, SOL_SOCKET, SO_REUSEADDR, (const char*) &on, sizeof(on));
     return my_socket;
 }
 
+/**
+ * @brief Allows several sockets to bind the server address and port (SO_REUSEPORT).
+ *
+ * @param my_socket The socket descriptor, not bound yet.
+ * @return 0 on success, -1 if the option is not supported.
+ */
+int enableReusePort(int my_socket) {
+#if defined SO_REUSEPORT
+    int on = 1;
+    return setsockopt(my_socket, SOL_SOCKET, SO_REUSEPORT, (const char*) &on, sizeof(on));
+#else
+    return -1;
+#endif
+}
+
 /**
  * @brief Binds the socket to a specific address and port.
  *
@@ -186,9 +517,10 @@ struct sockaddr_in bindSocket(int my_socket, struct sockaddr_in sad) {
  * @brief Sets the socket to listen mode to accept incoming connections.
  *
  * @param my_socket The socket descriptor to set on listen.
+ * @param queue The maximum length of the queue of pending connections.
  */
-void setSocketOnListen(int my_socket) {
-    if (listen(my_socket, QUEUE < 0)) {
+void setSocketOnListen(int my_socket, int queue) {
+    if (listen(my_socket, queue) < 0) {
         errorhandler("listen() failed.");
         closesocket(my_socket);
         clearwinsock();
@@ -213,101 +545,235 @@ void clearwinsock() {
  */
 void errorhandler(char *errorMessage) {
     printf("\n%s", errorMessage);
-    writeLog(errorMessage);
+    LOG_MESSAGE(LOG_LEVEL_ERROR, errorMessage);
 }
 
 /**
  * @brief Processes the input message, performs calculations, and updates the input string.
  *
+ * With the result cache enabled a repeated request gets the reply stored the first
+ * time; the replies that quote the position of an error are not stored, since it
+ * depends on the whitespace the normalization removes.
+ *
+ * In session mode the references to the registers are replaced first, and the
+ * result is kept in the next register. Those requests bypass the cache, whose
+ * replies are rounded to the precision of the results.
+ *
  * @param msg The input message containing operator and operands.
+ * @param length The number of characters of the message.
+ * @param registers The registers of the session of the client, NULL outside session mode.
  */
-void processData(char *msg) {
-    // Extract the operator and operands from the input string
-    char operator = msg[0];
+void processData(char *msg, int length, struct Registers *registers) {
+    char reply[BUFFERSIZE];
+    struct Scanner scanner;
+    struct Operation operation;
+    struct CacheKey key;
+
+    // Extract the operator and operands from the input string in a single pass
+    initScanner(&scanner, msg, length);
+    char operator = skipSpaces(&scanner);
 
     // Check if the operator is '=' to terminate communication
     if (operator == '=') {
-        char *byeString = "Bye";
-        snprintf(msg, strlen(byeString) + 1, "%s", byeString);
+        strcpy(msg, "Bye");
+        return;
+    }
+
+    int cacheable = registers == NULL && makeCacheKey(msg, length, &key) == 0;
+    if (cacheable && lookupResult(&key, msg) >= 0) {
+        return;
+    }
+
+    if (operator == BATCH_OPERATOR) {
+        processBatch(msg, length, registers);
+        if (cacheable) {
+            storeResult(&key, msg);
+        }
         return;
     }
 
-    int numOperands = 0;
-    int operands[MAXOPERANDS];
+    if (registers != NULL && memchr(msg, REGISTER_PREFIX, length) != NULL) {
+        int expandedLength, errorPosition;
+        int expanded = expandRegisters(registers, msg, length, reply, &expandedLength, &errorPosition);
+        if (expanded != CALC_OK) {
+            saveRegister(registers, NULL, NULL, expanded, 0);
+            snprintf(msg, BUFFERSIZE, "%s at position %d", expanded == CALC_INVALID_REGISTER
+                     ? "Invalid register" : "Too many operands", errorPosition + 1);
+            return;
+        }
+        memcpy(msg, reply, expandedLength + 1);
+        length = expandedLength;
+        initScanner(&scanner, msg, length);
+    }
 
-    // Tokenize the input string and collect operands
-    char *token = strtok(msg + 2, " ");
-    while (token != NULL && numOperands < MAXOPERANDS) {
-        if (sscanf(token, "%d", &operands[numOperands]) != 1) {
-            // Error handling: Invalid operand format
-            snprintf(msg, strlen(msg), "Invalid operand format: %s", token);
-            return; // Or handle the error as needed
+    double result;
+    int status = evaluateOperation(&scanner, &operation, &result);
+    if (status == CALC_OK && operation.wide) {
+        // Integers past 64 bits are calculated again exactly
+        status = calculateBig(&scanner, &operation, resultPrecision, reply, sizeof(reply));
+    }
+    saveRegister(registers, &scanner, &operation, status, result);
+    switch (status) {
+        case CALC_OK:
+            // Convert the result to a string and update the input string
+            if (operation.wide) {
+                strcpy(msg, reply);
+            } else if (operation.integer) {
+                formatInteger(msg, BUFFERSIZE, operation.integerResult, resultPrecision);
+            } else {
+                formatNumber(msg, BUFFERSIZE, result, resultPrecision);
+            }
+            break;
+        case CALC_INVALID_OPERAND:
+            // Error handling: Invalid operand format, reported with its position (from 1)
+            snprintf(reply, sizeof(reply), "Invalid operand format at position %d: %.*s",
+                     operation.errorPosition + 1, operation.errorLength, msg + operation.errorPosition);
+            strcpy(msg, reply);
+            return;
+        case CALC_TOO_MANY_OPERANDS:
+            snprintf(msg, BUFFERSIZE, "Too many operands at position %d", operation.errorPosition + 1);
+            return;
+        case CALC_SYNTAX_ERROR:
+            snprintf(msg, BUFFERSIZE, "Syntax error at position %d", operation.errorPosition + 1);
+            return;
+        case CALC_MISSING_OPERANDS: {
+            char *insufficientNumberError = "Insufficient number of operands";
+            LOG_MESSAGE(LOG_LEVEL_DEBUG, insufficientNumberError);
+            strcpy(msg, insufficientNumberError);
+            break;
+        }
+        case CALC_DIVISION_BY_ZERO: {
+            // Error handling: Division by zero
+            char *divisionError = "|Error| -  Division by Zero";
+            strcpy(msg, divisionError);
+            break;
         }
-        numOperands++;
-        token = strtok(NULL, " ");
+        case CALC_UNKNOWN_OPERATOR:
+            // Error handling: Unknown operator
+            snprintf(msg, BUFFERSIZE, "Unknown operator: %c", operation.operator);
+            break;
     }
 
+    if (cacheable) {
+        storeResult(&key, msg);
+    }
+}
+
+/**
+ * @brief Applies an operator to the operands from left to right.
+ *
+ * @param operator The operator, one of + - * /.
+ * @param operands The operands.
+ * @param numOperands The number of operands.
+ * @param result Receives the result when the calculation succeeds.
+ * @return CALC_OK on success, otherwise the CALC_ error code.
+ */
+int calculate(char operator, const double *operands, int numOperands, double *result) {
     if (numOperands < 2) {
-        char *insufficientNumberError = "Insufficient number of operands";
-        writeLog(insufficientNumberError);
-        strcpy(msg, insufficientNumberError);
-        return;
+        return CALC_MISSING_OPERANDS;
     }
 
-    double result = operands[0];
+    double value = operands[0];
     for (int i = 1; i < numOperands; i++) {
         switch (operator) {
             case '+':
-                result = add(result, operands[i]);
+                value = add(value, operands[i]);
                 break;
             case '-':
-                result = sub(result, operands[i]);
+                value = sub(value, operands[i]);
                 break;
             case '*':
-                result = mult(result, operands[i]);
+                value = mult(value, operands[i]);
                 break;
             case '/':
-                if (operands[i] != 0) {
-                    result = division(result, operands[i]);
-                } else {
-                    // Error handling: Division by zero
-                    char *divisionError = "|Error| -  Division by Zero";
-                    strcpy(msg, divisionError);
-                    return;
+                if (operands[i] == 0) {
+                    return CALC_DIVISION_BY_ZERO;
                 }
+                value = division(value, operands[i]);
                 break;
             default:
-                // Error handling: Unknown operator
-                snprintf(msg, BUFFERSIZE, "Unknown operator: %c", operator);
-                return;
+                return CALC_UNKNOWN_OPERATOR;
         }
     }
 
-    // Convert the result to a string and update the input string
-    snprintf(msg, BUFFERSIZE, "%.2f", result);
+    *result = value;
+    return CALC_OK;
 }
 
 /**
- * @brief Writes a log message to the log file.
+ * @brief Evaluates a batch request and replaces it with the results of its operations.
+ *
+ * The operations are evaluated in order and written into the reply while it has
+ * room; once it is full the reply ends with the CALC_REPLY_FULL code, and the client
+ * resends the operations that were not answered.
  *
- * @param message The log message to be written.
+ * In session mode every operation is numbered, and its references to the registers
+ * are replaced just before it is evaluated, so it can use the results of the
+ * operations before it in the same batch.
+ *
+ * @param msg The batch request, starting with BATCH_OPERATOR.
+ * @param length The number of characters of the request.
+ * @param registers The registers of the session of the client, NULL outside session mode.
  */
-void writeLog(const char* message) {
-    FILE* file = fopen("Log.txt", "a");
-
-    if (file != NULL) {
-        time_t timestamp = time(NULL);
-        struct tm* timeInfo = localtime(&timestamp);
+void processBatch(char *msg, int length, struct Registers *registers) {
+    char reply[BUFFERSIZE];
+    char item[BUFFERSIZE];
+    char expanded[BUFFERSIZE];
+    int replyLength = 0;
+    const char separators[] = { BATCH_SEPARATOR, '\0' };
+    struct Scanner scanner, expandedScanner;
+    char c;
+
+    reply[0] = '\0';
+    initScanner(&scanner, msg, length);
+    skipSpaces(&scanner);
+    scanner.position++; // BATCH_OPERATOR
+    while ((c = skipSpaces(&scanner)) != '\0') {
+        if (c == BATCH_SEPARATOR) {
+            scanner.position++; // Empty operations are skipped
+            continue;
+        }
 
-        // Get current date and time
-        char dateAndTime[20];
-        strftime(dateAndTime, sizeof(dateAndTime), "%H:%M:%S %d/%m/%Y", timeInfo);
+        struct Operation operation;
+        struct Scanner *operationScanner = &scanner;
+        double result = 0;
+        int status = CALC_OK;
+        if (registers != NULL) {
+            int start = scanner.position;
+            int expandedLength, errorPosition;
+            skipOperation(&scanner);
+            status = expandRegisters(registers, msg + start, scanner.position - start, expanded,
+                                     &expandedLength, &errorPosition);
+            initScanner(&expandedScanner, expanded, status == CALC_OK ? expandedLength : 0);
+            operationScanner = &expandedScanner;
+        }
+        if (status == CALC_OK) {
+            status = evaluateOperation(operationScanner, &operation, &result);
+        }
+        if (status == CALC_OK && operation.wide) {
+            status = calculateBig(operationScanner, &operation, resultPrecision, item, sizeof(item));
+        } else if (status == CALC_OK && operation.integer) {
+            formatInteger(item, sizeof(item), operation.integerResult, resultPrecision);
+        } else if (status == CALC_OK) {
+            formatNumber(item, sizeof(item), result, resultPrecision);
+        }
+        if (registers == NULL) {
+            skipOperation(&scanner);
+        }
 
-        // Write the log message to the file
-        fprintf(file, "SERVER - [%s] - %s\n", dateAndTime, message);
+        int itemLength = status == CALC_OK ? (int) strlen(item) : snprintf(item, sizeof(item), "E%d", status);
 
-        fclose(file);
-    } else {
-        printf("Error opening the log file.\n");
+        // Keep room for the separator and the code that marks a full reply
+        if (replyLength + itemLength + 4 > BUFFERSIZE - 1) {
+            snprintf(reply + replyLength, sizeof(reply) - replyLength, "%sE%d",
+                     replyLength > 0 ? separators : "", CALC_REPLY_FULL);
+            break;
+        }
+        // An operation is numbered once it is answered: the client resends the skipped ones
+        saveRegister(registers, operationScanner, status == CALC_OK ? &operation : NULL, status, result);
+        replyLength += snprintf(reply + replyLength, sizeof(reply) - replyLength, "%s%s",
+                                replyLength > 0 ? separators : "", item);
     }
+
+    strcpy(msg, reply);
 }
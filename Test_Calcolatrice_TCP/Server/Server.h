@@ -15,10 +15,96 @@
 // Define the maximum queue size for pending client connections
 #define QUEUE 5
 
-#define MAXOPERANDS 2           // Maximum number of operands
+#define MAXOPERANDS 64          // Maximum number of operands, "+ 1 2 3" folds them from the left
+#define RESULT_PRECISION 2      // Decimals of the results in the text replies
 
-char msg[BUFFERSIZE];    // Message Array
-char msgLog[BUFFERSIZE]; // Message Log
+// Batch request: "B + 1 2; / 4 0; * 3 5" evaluates every operation and answers with
+// one result per operation, separated by BATCH_SEPARATOR ("3.00;E1;15.00").
+// A failed operation is answered by 'E' followed by its error code.
+#define BATCH_OPERATOR 'B'      // First character of a batch request
+#define BATCH_SEPARATOR ';'     // Separates the operations of a batch and their results
+
+// Expression request: "X (1 + 2) * -3 / 4" evaluates an infix formula with the usual
+// precedence, parentheses and signs (see Expression.h); it may be an operation of a batch too.
+#define EXPRESSION_OPERATOR 'X' // First character of an expression request
+
+// Error codes of calculate(), reported per operation in the reply of a batch
+#define CALC_OK 0               // The result is valid
+#define CALC_DIVISION_BY_ZERO 1 // "|Error| -  Division by Zero"
+#define CALC_INVALID_OPERAND 2  // An operand is not a number
+#define CALC_UNKNOWN_OPERATOR 3 // The operator is not one of + - * /
+#define CALC_MISSING_OPERANDS 4 // Fewer than two operands
+#define CALC_REPLY_FULL 5       // The reply has no room left: this and the next operations were skipped
+#define CALC_TOO_MANY_OPERANDS 6 // More than MAXOPERANDS operands, or an expression too large
+#define CALC_SYNTAX_ERROR 7     // An expression is malformed
+#define CALC_INVALID_REGISTER 8 // A reference names no result kept by the session (see Registers.h)
+
+// Framed protocol: a client switches to it by sending a frame as its first request.
+// Every frame is a 4 byte header (magic, type, 16 bit big-endian payload length)
+// followed by exactly that many payload bytes; no padding, no terminator.
+#define FRAME_MAGIC 0xC5        // First byte of a frame, never the first byte of a text request
+#define FRAME_TEXT 0x01         // Frame type: text request or reply
+#define FRAME_BINARY 0x02       // Frame type: binary operations or results (see Binary.h)
+#define FRAME_STREAM 0x03       // Frame type: operands folded into the stream of the connection (see Binary.h)
+#define FRAME_LINEAR 0x04       // Frame type: arrays or matrices of a linear algebra operation (see Binary.h)
+#define FRAME_HEADERSIZE 4      // Size of the frame header
+#define MAXPAYLOAD (BUFFERSIZE - 1) // Maximum payload of a frame
+
+// Banner sent to every client right after the connection is accepted
+#define WELCOME_MSG \
+        "\n* * * * * * * * * * * * * * * * * * * * * * * *\n" \
+        "*   Francesco Conforti - Matricola: 776628    *\n" \
+        "*             Basic Calculator                *\n" \
+        "*      Supported operations: +, -, *, /       *\n" \
+        "*      Enter = to close the connection        *\n" \
+        "* * * * * * * * * * * * * * * * * * * * * * * *"
+
+// The banner padded to BUFFERSIZE bytes, formatted once and sent as it is
+extern const char welcomeBlock[BUFFERSIZE];
+
+/**
+ * @brief Server execution modes selectable from the command line.
+ */
+enum ServerMode {
+    MODE_BLOCKING, // One client at a time with blocking accept()/recv()/send()
+    MODE_EPOLL,    // Non-blocking, edge-triggered epoll reactor (Linux only)
+    MODE_THREADS,  // One reactor per worker thread fed by an acceptor thread (Linux only)
+    MODE_REUSEPORT,// One reactor per thread, each with its own SO_REUSEPORT listener (Linux only)
+    MODE_URING     // io_uring with multishot accept/recv and linked sends (Linux only)
+};
+
+#define IDLE_TIMEOUT 300        // Default idle timeout in seconds
+#define READ_TIMEOUT 30         // Default read timeout in seconds
+#define OUTPUT_MEMORY 256       // Default memory in MiB for the replies queued for all the clients
+
+/**
+ * @brief Deadlines after which a client is disconnected, in milliseconds (0 disables one).
+ */
+struct Timeouts {
+    int idle;               // No request in progress and nothing to send
+    int read;               // A request partially received or replies not accepted by the client
+    int session;            // Whole lifetime of the connection
+};
+
+/**
+ * @brief Options read from the command line.
+ */
+struct ServerOptions {
+    enum ServerMode mode;   // Execution mode
+    int workers;            // Number of threads used by MODE_THREADS and MODE_REUSEPORT
+    int pinThreads;         // 1 to pin every reuseport thread to its own CPU
+    int steering;           // 1 to steer connections to the shard of the receiving CPU
+    struct Timeouts timeouts; // Deadlines after which a client is disconnected
+    int outputMemory;       // Memory in MiB for the replies queued for all the clients
+    int logFormat;          // LOG_FORMAT_ value of the log file
+    int logLevel;           // Highest LOG_LEVEL_ value written
+    int logSampling;        // Only 1 request in logSampling is logged
+    int precision;          // Decimals of the results, NUMBER_SHORTEST for the shortest exact digits
+    int logSegments;        // Number of rotating log segments, 0 for a single log file
+    int logSegmentSize;     // Size of a log segment in MiB
+    int cacheEntries;       // Replies kept by the result cache, 0 to disable it
+    int registers;          // 1 to keep the results of every connection in registers
+};
 
 /**
  * @brief Binds the socket to a specific address and port.
@@ -49,6 +135,14 @@ void clearwinsock();
  */
 int createSocket(int my_socket);
 
+/**
+ * @brief Allows several sockets to bind the server address and port (SO_REUSEPORT).
+ *
+ * @param my_socket The socket descriptor, not bound yet.
+ * @return 0 on success, -1 if the option is not supported.
+ */
+int enableReusePort(int my_socket);
+
 /**
  * @brief Handles errors by printing the error message to the console.
  *
@@ -56,12 +150,75 @@ int createSocket(int my_socket);
  */
 void errorhandler(char *errorMessage);
 
+/**
+ * @brief Applies an operator to the operands from left to right.
+ *
+ * @param operator The operator, one of + - * /.
+ * @param operands The operands.
+ * @param numOperands The number of operands.
+ * @param result Receives the result when the calculation succeeds.
+ * @return CALC_OK on success, otherwise the CALC_ error code.
+ */
+int calculate(char operator, const double *operands, int numOperands, double *result);
+
+struct Registers;
+
 /**
  * @brief Processes the input message, performs calculations, and updates the input string.
  *
- * @param msg The input message containing operator and operands.
+ * @param msg The input message containing operator and operands, in a buffer of
+ *            BUFFERSIZE bytes that receives the NUL-terminated reply.
+ * @param length The number of characters of the message.
+ * @param registers The registers of the session of the client, NULL outside session mode.
+ */
+void processData(char *msg, int length, struct Registers *registers);
+
+/**
+ * @brief Evaluates a batch request and replaces it with the results of its operations.
+ *
+ * @param msg The batch request, starting with BATCH_OPERATOR.
+ * @param length The number of characters of the request.
+ * @param registers The registers of the session of the client, NULL outside session mode.
+ */
+void processBatch(char *msg, int length, struct Registers *registers);
+
+/**
+ * @brief Parses the command line into the server options.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @param options The options to fill (epoll mode by default on Linux, blocking elsewhere).
+ */
+void parseOptions(int argc, char *argv[], struct ServerOptions *options);
+
+/**
+ * @brief Serves one client at a time using blocking socket calls.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if accept() fails, it never returns otherwise.
+ */
+int runBlockingServer(int my_socket, const struct Timeouts *timeouts);
+
+/**
+ * @brief Sets the time a blocking recv() or send() waits before failing.
+ *
+ * @param my_socket The socket descriptor.
+ * @param option SO_RCVTIMEO or SO_SNDTIMEO.
+ * @param milliseconds The timeout, 0 to wait forever.
+ * @return 0 on success, -1 on failure.
  */
-void processData(char *msg);
+int setSocketTimeout(int my_socket, int option, int milliseconds);
+
+/**
+ * @brief Sends a whole buffer on a blocking socket, resuming after short sends.
+ *
+ * @param my_socket The socket descriptor.
+ * @param data The bytes to send.
+ * @param length The number of bytes to send.
+ * @return 0 on success, -1 if the socket fails or the send timeout expires.
+ */
+int sendAll(int my_socket, const char *data, int length);
 
 /**
  * @brief Sends a welcome message to the client upon connection.
@@ -74,11 +231,15 @@ void sendWelcomeMsg(int client_socket);
  * @brief Sets the socket to listen mode to accept incoming connections.
  *
  * @param my_socket The socket descriptor to set on listen.
+ * @param queue The maximum length of the queue of pending connections.
  */
-void setSocketOnListen(int my_socket);
+void setSocketOnListen(int my_socket, int queue);
 
 /**
- * @brief Writes a log message to the log file.
+ * @brief Writes a log message to the log file (see Log.h).
+ *
+ * Safe to call from any thread; once openLog() has started the writer thread the
+ * message is queued and written in the background.
  *
  * @param message The log message to be written.
  */
@@ -0,0 +1,332 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Session.h"
+#include "Binary.h"
+#include "Scanner.h"
+#include "Registers.h"
+#include "Statistics.h"
+
+/**
+ * @file Session.c
+ * @brief Implementation file for the protocol state of a client connection.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define INPUTMASK (SESSIONBUFFER - 1)
+
+static enum Protocol decideProtocol(const struct Session *session);
+static void copyInput(const struct Session *session, int offset, char *out, int length);
+static void consumeInput(struct Session *session, int length);
+static void writeHeader(char *out, int type, int length);
+
+/**
+ * @brief Initializes a session whose protocol is not decided yet.
+ *
+ * @param session The session to initialize.
+ */
+void initSession(struct Session *session) {
+    session->protocol = PROTOCOL_NEW;
+    session->inputStart = 0;
+    session->inputLength = 0;
+    session->registers = createRegisters();
+    session->stream = NULL;
+}
+
+/**
+ * @brief Releases what a session allocated, once its client is gone.
+ *
+ * @param session The session.
+ */
+void closeSession(struct Session *session) {
+    freeRegisters(session->registers);
+    session->registers = NULL;
+    free(session->stream);
+    session->stream = NULL;
+}
+
+/**
+ * @brief Copies received bytes into the input of the session.
+ *
+ * @param session The session.
+ * @param data The received bytes.
+ * @param length The number of received bytes.
+ * @return The number of bytes copied, limited by the free space of the input.
+ */
+int feedSession(struct Session *session, const char *data, int length) {
+    int copied = 0;
+
+    while (copied < length) {
+        char *space;
+        int chunk = inputSpace(session, &space);
+        if (chunk == 0) {
+            break;
+        }
+        if (chunk > length - copied) {
+            chunk = length - copied;
+        }
+        memcpy(space, data + copied, chunk);
+        commitInput(session, chunk);
+        copied += chunk;
+    }
+    return copied;
+}
+
+/**
+ * @brief Returns the contiguous free space at the end of the input ring.
+ *
+ * @param session The session.
+ * @param space Receives the address of the free space.
+ * @return The number of bytes that can be written at that address.
+ */
+int inputSpace(struct Session *session, char **space) {
+    unsigned end = (session->inputStart + session->inputLength) & INPUTMASK;
+    int free = SESSIONBUFFER - session->inputLength;
+    int contiguous = SESSIONBUFFER - (int) end;
+
+    *space = session->input + end;
+    return free < contiguous ? free : contiguous;
+}
+
+/**
+ * @brief Publishes bytes written into the space returned by inputSpace().
+ *
+ * @param session The session.
+ * @param length The number of bytes written.
+ */
+void commitInput(struct Session *session, int length) {
+    session->inputLength += length;
+}
+
+/**
+ * @brief Extracts the next complete request from the input of the session.
+ *
+ * Legacy requests end with a NUL or a newline (a trailing carriage return is
+ * dropped) and empty ones, such as the padding of a fixed-size block, are skipped;
+ * a request without terminator is cut at BUFFERSIZE - 1 characters. Framed requests
+ * are only extracted once their header and payload are complete, whatever the
+ * segmentation of the stream; binary, stream and linear payloads are returned as they are.
+ *
+ * @param session The session.
+ * @param request Buffer of BUFFERSIZE bytes receiving the request.
+ * @param requestLength Receives the size of the request (without terminator for text).
+ * @return REQUEST_TEXT, REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR if a request was extracted,
+ *         0 if more bytes are needed, -1 on invalid frames.
+ */
+int nextRequest(struct Session *session, char *request, int *requestLength) {
+    if (session->protocol == PROTOCOL_NEW && session->inputLength > 0) {
+        session->protocol = decideProtocol(session);
+    }
+
+    // The original client sends every request in a block of sizeof(size_t) bytes: a
+    // longer request is cut, a shorter one is followed by its NUL and stale bytes
+    while (session->protocol == PROTOCOL_BLOCK && session->inputLength >= LEGACY_BLOCKSIZE) {
+        copyInput(session, 0, request, LEGACY_BLOCKSIZE);
+        consumeInput(session, LEGACY_BLOCKSIZE);
+        request[LEGACY_BLOCKSIZE] = '\0';
+        int length = (int) strlen(request);
+        if (length > 0) {
+            *requestLength = length;
+            return REQUEST_TEXT;
+        }
+    }
+    if (session->protocol == PROTOCOL_BLOCK) {
+        return 0;
+    }
+
+    while (session->protocol == PROTOCOL_LEGACY && session->inputLength > 0) {
+        if ((unsigned char) session->input[session->inputStart] == FRAME_MAGIC) {
+            session->protocol = PROTOCOL_FRAMED;
+            break;
+        }
+
+        int length = 0;
+        int terminated = 0;
+        int limit = session->inputLength < BUFFERSIZE - 1 ? session->inputLength : BUFFERSIZE - 1;
+        while (length < limit) {
+            char c = session->input[(session->inputStart + length) & INPUTMASK];
+            if (c == '\0' || c == '\n') {
+                terminated = 1;
+                break;
+            }
+            length++;
+        }
+
+        if (!terminated && length < BUFFERSIZE - 1) {
+            return 0; // The terminator has not been received yet
+        }
+
+        copyInput(session, 0, request, length);
+        consumeInput(session, length + terminated);
+        if (length > 0 && request[length - 1] == '\r') {
+            length--;
+        }
+        request[length] = '\0';
+        if (length > 0) {
+            *requestLength = length;
+            return REQUEST_TEXT;
+        }
+    }
+
+    if (session->inputLength < FRAME_HEADERSIZE) {
+        return 0;
+    }
+
+    unsigned char header[FRAME_HEADERSIZE];
+    copyInput(session, 0, (char*) header, FRAME_HEADERSIZE);
+    int payload = (header[2] << 8) | header[3];
+    if (header[0] != FRAME_MAGIC || header[1] < FRAME_TEXT || header[1] > FRAME_LINEAR || payload > MAXPAYLOAD) {
+        return -1;
+    }
+    if (session->inputLength < FRAME_HEADERSIZE + payload) {
+        return 0;
+    }
+
+    copyInput(session, FRAME_HEADERSIZE, request, payload);
+    request[payload] = '\0';
+    consumeInput(session, FRAME_HEADERSIZE + payload);
+    *requestLength = payload;
+    switch (header[1]) {
+        case FRAME_TEXT:
+            return REQUEST_TEXT;
+        case FRAME_BINARY:
+            return REQUEST_BINARY;
+        case FRAME_STREAM:
+            return REQUEST_STREAM;
+        default:
+            return REQUEST_LINEAR;
+    }
+}
+
+/**
+ * @brief Decides the protocol of a session from the bytes of its first request.
+ *
+ * @param session The session, with some input.
+ * @return PROTOCOL_FRAMED, PROTOCOL_BLOCK or PROTOCOL_LEGACY.
+ */
+static enum Protocol decideProtocol(const struct Session *session) {
+    char block[LEGACY_BLOCKSIZE];
+
+    if ((unsigned char) session->input[session->inputStart] == FRAME_MAGIC) {
+        return PROTOCOL_FRAMED;
+    }
+    if (session->inputLength != LEGACY_BLOCKSIZE) {
+        return PROTOCOL_LEGACY;
+    }
+    copyInput(session, 0, block, LEGACY_BLOCKSIZE);
+    return memchr(block, '\n', LEGACY_BLOCKSIZE) == NULL ? PROTOCOL_BLOCK : PROTOCOL_LEGACY;
+}
+
+/**
+ * @brief Copies bytes out of the input ring, handling the wrap-around.
+ *
+ * @param session The session.
+ * @param offset Offset of the first byte from the start of the input.
+ * @param out Destination buffer.
+ * @param length Number of bytes to copy.
+ */
+static void copyInput(const struct Session *session, int offset, char *out, int length) {
+    unsigned first = (session->inputStart + offset) & INPUTMASK;
+    int head = SESSIONBUFFER - (int) first;
+
+    if (head >= length) {
+        memcpy(out, session->input + first, length);
+    } else {
+        memcpy(out, session->input + first, head);
+        memcpy(out + head, session->input, length - head);
+    }
+}
+
+/**
+ * @brief Drops bytes from the start of the input ring.
+ *
+ * @param session The session.
+ * @param length Number of bytes to drop.
+ */
+static void consumeInput(struct Session *session, int length) {
+    session->inputLength -= length;
+    session->inputStart = session->inputLength == 0 ? 0 : (session->inputStart + length) & INPUTMASK;
+}
+
+/**
+ * @brief Encodes a reply for the protocol of the session.
+ *
+ * Legacy replies are padded with zeros to BUFFERSIZE bytes, framed replies carry
+ * only the characters of the reply.
+ *
+ * @param session The session.
+ * @param reply The NUL-terminated reply.
+ * @param out Buffer of MAXREPLYSIZE bytes receiving the encoded reply.
+ * @return The number of bytes to send.
+ */
+int encodeReply(const struct Session *session, const char *reply, char *out) {
+    int length = (int) strlen(reply);
+    if (length > MAXPAYLOAD) {
+        length = MAXPAYLOAD;
+    }
+
+    if (session->protocol != PROTOCOL_FRAMED) {
+        memset(out, 0, BUFFERSIZE);
+        memcpy(out, reply, length);
+        return BUFFERSIZE;
+    }
+
+    writeHeader(out, FRAME_TEXT, length);
+    memcpy(out + FRAME_HEADERSIZE, reply, length);
+    return FRAME_HEADERSIZE + length;
+}
+
+/**
+ * @brief Evaluates a binary, stream or linear request and encodes its results as a frame of the same type.
+ *
+ * The stream of a session is only allocated by its first stream request.
+ *
+ * @param session The session, whose stream the operands of a stream request are folded into.
+ * @param type REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR.
+ * @param request The payload of the frame.
+ * @param length The size of the payload.
+ * @param out Buffer of MAXREPLYSIZE bytes receiving the encoded reply.
+ * @return The number of bytes to send, -1 if the payload is malformed.
+ */
+int answerBinary(struct Session *session, int type, const char *request, int length, char *out) {
+    if (type == REQUEST_STREAM && session->stream == NULL) {
+        session->stream = malloc(sizeof(struct Statistics));
+        if (session->stream == NULL) {
+            return -1;
+        }
+        initStatistics(session->stream);
+    }
+
+    int replyLength;
+    int frameType;
+    if (type == REQUEST_STREAM) {
+        replyLength = processStream(session->stream, request, length, out + FRAME_HEADERSIZE);
+        frameType = FRAME_STREAM;
+    } else if (type == REQUEST_LINEAR) {
+        replyLength = processLinear(request, length, out + FRAME_HEADERSIZE);
+        frameType = FRAME_LINEAR;
+    } else {
+        replyLength = processBinary(request, length, out + FRAME_HEADERSIZE);
+        frameType = FRAME_BINARY;
+    }
+    if (replyLength < 0) {
+        return -1;
+    }
+
+    writeHeader(out, frameType, replyLength);
+    return FRAME_HEADERSIZE + replyLength;
+}
+
+/**
+ * @brief Writes the header of a frame.
+ *
+ * @param out Buffer receiving the FRAME_HEADERSIZE bytes of the header.
+ * @param type The frame type.
+ * @param length The size of the payload.
+ */
+static void writeHeader(char *out, int type, int length) {
+    out[0] = (char) FRAME_MAGIC;
+    out[1] = (char) type;
+    out[2] = (char) ((length >> 8) & 0xFF);
+    out[3] = (char) (length & 0xFF);
+}
@@ -0,0 +1,129 @@
+#ifndef SERVER_SESSION_H_
+#define SERVER_SESSION_H_
+
+/**
+ * @file Session.h
+ * @brief Header file for the protocol state of a client connection.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define SESSIONBUFFER 4096      // Input ring of a session (power of two, holds pipelined requests)
+#define MAXREPLYSIZE (FRAME_HEADERSIZE + BUFFERSIZE)  // Largest encoded reply
+#define OUTPUTBUFFER 8192       // Replies batched into a single send
+#define LEGACY_BLOCKSIZE ((int) sizeof(size_t)) // Request block of the original client, unterminated when full
+
+#define REQUEST_TEXT 1          // nextRequest() extracted a NUL-terminated text request
+#define REQUEST_BINARY 2        // nextRequest() extracted the payload of a binary frame
+#define REQUEST_STREAM 3        // nextRequest() extracted the payload of a stream frame
+#define REQUEST_LINEAR 4        // nextRequest() extracted the payload of a linear frame
+
+/**
+ * @brief Wire protocols a client can speak.
+ */
+enum Protocol {
+    PROTOCOL_NEW,    // No request received yet, replies as legacy
+    PROTOCOL_LEGACY, // Requests ended by NUL or newline, fixed BUFFERSIZE replies
+    PROTOCOL_BLOCK,  // Requests in blocks of LEGACY_BLOCKSIZE bytes, fixed BUFFERSIZE replies
+    PROTOCOL_FRAMED  // Length-prefixed frames in both directions
+};
+
+/**
+ * @brief Protocol state of a connection, independent from the I/O backend.
+ *
+ * The backend appends the received bytes to the input ring and then extracts the
+ * requests one by one, so a read may carry any number of whole or partial requests;
+ * replies are encoded for the protocol of the connection.
+ */
+struct Session {
+    enum Protocol protocol;        // Protocol decided by the first request
+    char input[SESSIONBUFFER];     // Ring of the bytes received and not consumed yet
+    unsigned inputStart;           // Position of the first unconsumed byte
+    int inputLength;               // Number of valid bytes in the input
+    struct Registers *registers;   // Results of the operations, NULL outside session mode
+    struct Statistics *stream;     // Operands of the stream frames, NULL until the first one
+};
+
+/**
+ * @brief Initializes a session whose protocol is not decided yet.
+ *
+ * @param session The session to initialize.
+ */
+void initSession(struct Session *session);
+
+/**
+ * @brief Releases what a session allocated, once its client is gone.
+ *
+ * @param session The session.
+ */
+void closeSession(struct Session *session);
+
+/**
+ * @brief Copies received bytes into the input of the session.
+ *
+ * @param session The session.
+ * @param data The received bytes.
+ * @param length The number of received bytes.
+ * @return The number of bytes copied, limited by the free space of the input.
+ */
+int feedSession(struct Session *session, const char *data, int length);
+
+/**
+ * @brief Returns the contiguous free space at the end of the input ring.
+ *
+ * Lets a backend recv() directly into the session; the received bytes are then
+ * published with commitInput().
+ *
+ * @param session The session.
+ * @param space Receives the address of the free space.
+ * @return The number of bytes that can be written at that address.
+ */
+int inputSpace(struct Session *session, char **space);
+
+/**
+ * @brief Publishes bytes written into the space returned by inputSpace().
+ *
+ * @param session The session.
+ * @param length The number of bytes written.
+ */
+void commitInput(struct Session *session, int length);
+
+/**
+ * @brief Extracts the next complete request from the input of the session.
+ *
+ * The first request decides the protocol: a frame switches the connection to the
+ * framed protocol, a block of exactly LEGACY_BLOCKSIZE bytes without newline, as
+ * the original client sends, to the block one, anything else to the legacy one.
+ * Framed connections may mix text and binary frames.
+ *
+ * @param session The session.
+ * @param request Buffer of BUFFERSIZE bytes receiving the request.
+ * @param requestLength Receives the size of the request (without terminator for text).
+ * @return REQUEST_TEXT, REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR if a request was extracted,
+ *         0 if more bytes are needed, -1 on invalid frames.
+ */
+int nextRequest(struct Session *session, char *request, int *requestLength);
+
+/**
+ * @brief Encodes a reply for the protocol of the session.
+ *
+ * @param session The session.
+ * @param reply The NUL-terminated reply.
+ * @param out Buffer of MAXREPLYSIZE bytes receiving the encoded reply.
+ * @return The number of bytes to send.
+ */
+int encodeReply(const struct Session *session, const char *reply, char *out);
+
+/**
+ * @brief Evaluates a binary, stream or linear request and encodes its results as a frame of the same type.
+ *
+ * @param session The session, whose stream the operands of a stream request are folded into.
+ * @param type REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR.
+ * @param request The payload of the frame.
+ * @param length The size of the payload.
+ * @param out Buffer of MAXREPLYSIZE bytes receiving the encoded reply.
+ * @return The number of bytes to send, -1 if the payload is malformed.
+ */
+int answerBinary(struct Session *session, int type, const char *request, int length, char *out);
+
+#endif /* SERVER_SESSION_H_ */
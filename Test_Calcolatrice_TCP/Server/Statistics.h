@@ -0,0 +1,109 @@
+#ifndef SERVER_STATISTICS_H_
+#define SERVER_STATISTICS_H_
+
+/**
+ * @file Statistics.h
+ * @brief Header file for the reductions and the prefix sums of arrays of operands.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The values are folded into a struct Statistics a chunk at a time, so a stream of
+ * any length is summarized in constant memory. The sums are compensated: the
+ * rounding error of every addition is kept apart and added back, so the error does
+ * not grow with the number of values. The variance is Welford's, updated from the
+ * running mean instead of the sum of the squares, which cancels when the values
+ * are far from zero. The kernels use the instruction set chosen by Vector.h and
+ * split an array among threads once every thread gets STATISTICS_PARALLEL values.
+ * The results differ among the instruction sets only by the order of the roundings.
+ */
+
+#define STATISTICS_PARALLEL 131072  // Values a thread gets at least, fewer are folded by the calling thread
+#define STATISTICS_THREADS 8        // Most threads an array is split among
+
+/**
+ * @brief Summary of the values folded so far.
+ */
+struct Statistics {
+    long long count;        // Number of values
+    double sum;             // Sum of the values, rounded
+    double error;           // What the roundings of sum lost: the exact sum is about sum + error
+    double mean;            // Running mean of Welford's update, which the squares are taken from
+    double squares;         // Sum of the squared distances of the values from the mean
+    double min;             // Smallest value, +inf while there is none
+    double max;             // Largest value, -inf while there is none
+};
+
+/**
+ * @brief Empties a summary.
+ *
+ * @param statistics The summary.
+ */
+void initStatistics(struct Statistics *statistics);
+
+/**
+ * @brief Folds an array of values into a summary.
+ *
+ * NaN values make the sum, the mean and the variance NaN, but are not compared
+ * for the minimum and the maximum.
+ *
+ * @param statistics The summary.
+ * @param values The values.
+ * @param count The number of values.
+ */
+void foldStatistics(struct Statistics *statistics, const double *values, int count);
+
+/**
+ * @brief Folds a summary into another one, as if its values were folded.
+ *
+ * @param statistics The summary receiving the values.
+ * @param other The summary of the other values.
+ */
+void mergeStatistics(struct Statistics *statistics, const struct Statistics *other);
+
+/**
+ * @brief Folds an array of values into a summary, writing the sum after every value.
+ *
+ * The sums continue from those of the values folded before, so a stream of values
+ * can be scanned a chunk at a time.
+ *
+ * @param statistics The summary.
+ * @param values The values.
+ * @param sums Receives the sum of all the values folded up to every value, may be values.
+ * @param count The number of values.
+ */
+void scanStatistics(struct Statistics *statistics, const double *values, double *sums, int count);
+
+/**
+ * @brief Returns the compensated sum of a summary.
+ *
+ * @param statistics The summary.
+ * @return The sum of the values.
+ */
+double getStatisticsSum(const struct Statistics *statistics);
+
+/**
+ * @brief Returns the mean of a summary.
+ *
+ * @param statistics The summary.
+ * @return The compensated sum divided by the count, 0 without values.
+ */
+double getStatisticsMean(const struct Statistics *statistics);
+
+/**
+ * @brief Returns the population variance of a summary.
+ *
+ * @param statistics The summary.
+ * @return The mean of the squared distances of the values from their mean, 0 without values.
+ */
+double getStatisticsVariance(const struct Statistics *statistics);
+
+/**
+ * @brief Limits the threads the kernels split an array among, to compare them.
+ *
+ * @param threads The most threads, 1 to fold every array in the calling thread,
+ *                0 for the processors of the machine up to STATISTICS_THREADS.
+ * @return The previous limit.
+ */
+int setStatisticsThreads(int threads);
+
+#endif /* SERVER_STATISTICS_H_ */
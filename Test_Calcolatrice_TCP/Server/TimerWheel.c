@@ -0,0 +1,166 @@
+#include "TimerWheel.h"
+
+#if defined WIN32
+#include <windows.h>    // GetTickCount64()
+#else
+#include <time.h>       // Monotonic clock
+#endif
+
+/**
+ * @file TimerWheel.c
+ * @brief Implementation file for the hashed timing wheel of the event loops.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define SLOTMASK (WHEEL_SLOTS - 1)
+
+static void unlinkTimer(struct Timer *timer);
+
+/**
+ * @brief Returns the time of a monotonic clock in milliseconds.
+ *
+ * @return The current time.
+ */
+long long monotonicMs(void) {
+#if defined WIN32
+    return (long long) GetTickCount64();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#endif
+}
+
+/**
+ * @brief Initializes an empty wheel at the current time.
+ *
+ * @param wheel The wheel.
+ */
+void initWheel(struct TimerWheel *wheel) {
+    for (int i = 0; i < WHEEL_SLOTS; i++) {
+        wheel->slots[i].next = &wheel->slots[i];
+        wheel->slots[i].prev = &wheel->slots[i];
+    }
+    wheel->now = monotonicMs();
+    wheel->tick = wheel->now / WHEEL_TICK;
+    wheel->count = 0;
+}
+
+/**
+ * @brief Initializes a timer that is not armed.
+ *
+ * @param timer The timer.
+ * @param owner The state the timer belongs to.
+ */
+void initTimer(struct Timer *timer, void *owner) {
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->expires = 0;
+    timer->owner = owner;
+}
+
+/**
+ * @brief Arms (or moves) a timer so that it expires at a deadline.
+ *
+ * The deadline is rounded up to the next tick, so a timer never fires early.
+ *
+ * @param wheel The wheel.
+ * @param timer The timer.
+ * @param deadline The deadline in milliseconds of monotonicMs().
+ */
+void scheduleTimer(struct TimerWheel *wheel, struct Timer *timer, long long deadline) {
+    long long expires = (deadline + WHEEL_TICK - 1) / WHEEL_TICK;
+    if (expires < wheel->tick) {
+        expires = wheel->tick;
+    }
+
+    if (timer->next != NULL) {
+        if (timer->expires == expires) {
+            return; // Already in the right slot
+        }
+        unlinkTimer(timer);
+    } else {
+        wheel->count++;
+    }
+
+    struct Timer *slot = &wheel->slots[expires & SLOTMASK];
+    timer->expires = expires;
+    timer->prev = slot->prev;
+    timer->next = slot;
+    slot->prev->next = timer;
+    slot->prev = timer;
+}
+
+/**
+ * @brief Disarms a timer; nothing happens if it is not armed.
+ *
+ * @param wheel The wheel.
+ * @param timer The timer.
+ */
+void cancelTimer(struct TimerWheel *wheel, struct Timer *timer) {
+    if (timer->next != NULL) {
+        unlinkTimer(timer);
+        wheel->count--;
+    }
+}
+
+/**
+ * @brief Expires every timer whose deadline is not after the time of the wheel.
+ *
+ * Each elapsed tick visits its own slot only; after a pause longer than a
+ * revolution every slot is visited once.
+ *
+ * @param wheel The wheel.
+ * @param expire Function called for every expired timer.
+ */
+void advanceWheel(struct TimerWheel *wheel, void (*expire)(struct Timer *timer)) {
+    long long target = wheel->now / WHEEL_TICK;
+
+    if (target - wheel->tick >= WHEEL_SLOTS) {
+        wheel->tick = target - WHEEL_SLOTS + 1;
+    }
+
+    for (; wheel->tick <= target; wheel->tick++) {
+        struct Timer *slot = &wheel->slots[wheel->tick & SLOTMASK];
+        struct Timer *timer = slot->next;
+
+        while (timer != slot) {
+            struct Timer *next = timer->next;
+            if (timer->expires <= target) {
+                unlinkTimer(timer);
+                wheel->count--;
+                expire(timer);
+            }
+            timer = next;
+        }
+    }
+}
+
+/**
+ * @brief Returns how long an event loop may sleep before advancing the wheel.
+ *
+ * @param wheel The wheel.
+ * @return The time to the next tick in milliseconds, -1 if no timer is armed.
+ */
+int wheelTimeout(const struct TimerWheel *wheel) {
+    if (wheel->count == 0) {
+        return -1;
+    }
+
+    long long wait = wheel->tick * WHEEL_TICK - monotonicMs();
+    return wait > 0 ? (int) wait : 0;
+}
+
+/**
+ * @brief Removes a timer from the list of its slot.
+ *
+ * @param timer The timer.
+ */
+static void unlinkTimer(struct Timer *timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+}
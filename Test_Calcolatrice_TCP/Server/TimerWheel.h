@@ -0,0 +1,98 @@
+#ifndef SERVER_TIMERWHEEL_H_
+#define SERVER_TIMERWHEEL_H_
+
+/**
+ * @file TimerWheel.h
+ * @brief Header file for the hashed timing wheel of the event loops.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define WHEEL_TICK 100          // Resolution of the wheel in milliseconds
+#define WHEEL_SLOTS 512         // Slots of the wheel (power of two)
+
+/**
+ * @brief A deadline kept in the slot of the wheel its tick hashes to.
+ *
+ * Timers are embedded in the state they belong to, so arming, moving and
+ * cancelling one never allocates.
+ */
+struct Timer {
+    struct Timer *next;            // Next timer of the slot
+    struct Timer *prev;            // Previous timer of the slot
+    long long expires;             // Tick at which the timer expires
+    void *owner;                   // State the timer belongs to
+};
+
+/**
+ * @brief Hashed timing wheel: every timer sits in slot "expiry tick % WHEEL_SLOTS".
+ *
+ * Scheduling and cancelling are O(1); advancing the wheel only visits the slots of
+ * the elapsed ticks, and a timer further away than a revolution simply stays in its
+ * slot until its own tick comes.
+ */
+struct TimerWheel {
+    struct Timer slots[WHEEL_SLOTS]; // Sentinel of the list of every slot
+    long long tick;                // Next tick to process
+    long long now;                 // Time of the current loop iteration in milliseconds
+    int count;                     // Number of armed timers
+};
+
+/**
+ * @brief Returns the time of a monotonic clock in milliseconds.
+ *
+ * @return The current time.
+ */
+long long monotonicMs(void);
+
+/**
+ * @brief Initializes an empty wheel at the current time.
+ *
+ * @param wheel The wheel.
+ */
+void initWheel(struct TimerWheel *wheel);
+
+/**
+ * @brief Initializes a timer that is not armed.
+ *
+ * @param timer The timer.
+ * @param owner The state the timer belongs to.
+ */
+void initTimer(struct Timer *timer, void *owner);
+
+/**
+ * @brief Arms (or moves) a timer so that it expires at a deadline.
+ *
+ * @param wheel The wheel.
+ * @param timer The timer.
+ * @param deadline The deadline in milliseconds of monotonicMs().
+ */
+void scheduleTimer(struct TimerWheel *wheel, struct Timer *timer, long long deadline);
+
+/**
+ * @brief Disarms a timer; nothing happens if it is not armed.
+ *
+ * @param wheel The wheel.
+ * @param timer The timer.
+ */
+void cancelTimer(struct TimerWheel *wheel, struct Timer *timer);
+
+/**
+ * @brief Expires every timer whose deadline is not after the time of the wheel.
+ *
+ * The timers are disarmed before the callback runs, so it may free their owner.
+ *
+ * @param wheel The wheel.
+ * @param expire Function called for every expired timer.
+ */
+void advanceWheel(struct TimerWheel *wheel, void (*expire)(struct Timer *timer));
+
+/**
+ * @brief Returns how long an event loop may sleep before advancing the wheel.
+ *
+ * @param wheel The wheel.
+ * @return The time to the next tick in milliseconds, -1 if no timer is armed.
+ */
+int wheelTimeout(const struct TimerWheel *wheel);
+
+#endif /* SERVER_TIMERWHEEL_H_ */
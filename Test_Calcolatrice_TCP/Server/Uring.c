@@ -0,0 +1,977 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Session.h"
+#include "Binary.h"
+#include "Log.h"
+#include "Output.h"
+#include "TimerWheel.h"
+#include "Uring.h"
+
+#include <errno.h>          // Error numbers of the completions
+#include <stdint.h>         // Fixed width integers
+#include <linux/io_uring.h> // io_uring kernel interface
+#include <sys/mman.h>       // Memory mapping of the rings
+#include <sys/syscall.h>    // Raw system call numbers
+
+/**
+ * @file Uring.c
+ * @brief Implementation file for the io_uring backend of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The ring is driven through the raw system calls, so the backend needs nothing
+ * but the kernel headers.
+ */
+
+// The low bits of the user data tell which operation completed
+#define EVENT_ACCEPT 0          // Multishot accept (no pointer)
+#define EVENT_RECV 1            // Multishot recv of a UringClient
+#define EVENT_SEND 2            // Send of a UringReply
+#define EVENT_TIMEOUT 3         // Tick of the timing wheel (no pointer)
+#define EVENT_CANCEL 4          // Cancellation of a multishot recv (no pointer)
+#define EVENT_MASK 7
+
+#define BUFFER_GROUP 0          // Identifier of the provided buffer ring
+
+/**
+ * @brief The shared rings of an io_uring instance.
+ */
+struct Ring {
+    int fd;                         // io_uring instance descriptor
+    unsigned *sqHead;               // Submission queue head (advanced by the kernel)
+    unsigned *sqTail;               // Submission queue tail (advanced by us)
+    unsigned sqMask;                // Submission queue index mask
+    unsigned sqEntries;             // Submission queue size
+    unsigned sqLocalTail;           // Tail including the entries not published yet
+    struct io_uring_sqe *sqes;      // Submission queue entries
+    unsigned *cqHead;               // Completion queue head (advanced by us)
+    unsigned *cqTail;               // Completion queue tail (advanced by the kernel)
+    unsigned cqMask;                // Completion queue index mask
+    struct io_uring_cqe *cqes;      // Completion queue entries
+    struct io_uring_buf_ring *bufferRing; // Ring of the provided receive buffers
+    char *buffers;                  // Memory of the provided receive buffers
+    struct UringClient *dirty;      // Clients with replies to submit after this batch
+    struct Timeouts timeouts;       // Deadlines of the clients
+    struct TimerWheel wheel;        // Deadlines of the connected clients
+    struct __kernel_timespec tick;  // Time to the next tick of the wheel
+    int tickArmed;                  // 1 while the timeout of the next tick is submitted
+    int acceptDelayed;              // 1 while the accept waits for the next tick to be queued again
+    int acceptError;                // Error of the last failed accept, 0 once a client is accepted
+};
+
+/**
+ * @brief A batch of replies waiting to be sent or being sent with a single sendmsg.
+ */
+struct UringReply {
+    struct UringReply *next;        // Next batch of the same client
+    struct UringClient *client;     // Owner of the batch
+    struct msghdr message;          // Message submitted for the fragments of the batch
+    struct Output output;           // Fragments of the replies
+};
+
+/**
+ * @brief State kept for every connected client.
+ */
+struct UringClient {
+    int socket;                     // Socket descriptor of the client
+    struct sockaddr_in address;     // Address of the client
+    char addressString[INET_ADDRSTRLEN]; // Printable IP address of the client
+    struct Session session;         // Protocol state and received bytes
+    struct UringReply *queueHead;   // Replies not submitted yet
+    struct UringReply *queueTail;
+    int sendsInFlight;              // Sends submitted and not completed
+    int bytesInFlight;              // Bytes of the sends submitted and not completed
+    int paused;                     // 1 from the high watermark of the replies until the low one
+    char *backlog;                  // Input received while paused, consumed when resumed
+    int backlogOffset;              // First byte of the backlog not consumed
+    int backlogLength;              // Bytes used in the backlog
+    int backlogSize;                // Size of the backlog
+    int receiving;                  // 1 while the multishot recv is armed
+    int closing;                    // 1 once the client must not be read anymore
+    int isDirty;                    // 1 while the client is in the dirty list
+    struct UringClient *nextDirty;  // Next client of the dirty list
+    struct Ring *ring;              // Ring serving the client
+    struct Timer timer;             // Deadline of the client in the wheel of the ring
+    long long started;              // Time the connection was accepted
+};
+
+static void armAccept(struct Ring *ring, int my_socket);
+static void armRecv(struct Ring *ring, struct UringClient *client);
+static void armTick(struct Ring *ring);
+static int answerRequests(struct Ring *ring, struct UringClient *client);
+static int enterRing(struct Ring *ring, unsigned waitFor);
+static void expireClient(struct Timer *timer);
+static void flushReplies(struct Ring *ring, struct UringClient *client);
+static struct io_uring_sqe *getSqe(struct Ring *ring);
+static int handleAccept(struct Ring *ring, int my_socket, struct io_uring_cqe *cqe);
+static int handleData(struct Ring *ring, struct UringClient *client, const char *data, int length);
+static void handleRecv(struct Ring *ring, struct UringClient *client, struct io_uring_cqe *cqe);
+static void handleSend(struct Ring *ring, struct UringReply *reply, struct io_uring_cqe *cqe);
+static void pauseClient(struct Ring *ring, struct UringClient *client);
+static int pendingBytes(const struct UringClient *client);
+static int queueBinary(struct Ring *ring, struct UringClient *client, int type, const char *request, int length);
+static void queueReply(struct Ring *ring, struct UringClient *client, const char *text);
+static void recycleBuffer(struct Ring *ring, unsigned short bid);
+static struct UringReply *replySpace(struct Ring *ring, struct UringClient *client);
+static void resumeClient(struct Ring *ring, struct UringClient *client);
+static int setupRing(struct Ring *ring);
+static void stallInput(struct UringClient *client, const char *data, int length);
+static void stopClient(struct UringClient *client);
+static void tryRelease(struct UringClient *client);
+static void updateDeadline(struct UringClient *client);
+
+/**
+ * @brief Serves the clients through io_uring.
+ *
+ * Every loop iteration publishes the new submissions, waits for at least one
+ * completion with the same io_uring_enter() call, and then handles every completion
+ * available. The replies produced by the batch are submitted on the next iteration.
+ * While clients are connected, or an accept out of resources waits to be queued
+ * again, a timeout wakes the loop at every tick of the wheel.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return URING_UNAVAILABLE if the ring cannot be set up, -1 if it fails later.
+ */
+int runUringServer(int my_socket, const struct Timeouts *timeouts) {
+    static struct Ring ring; // The wheel is too large for the stack of the thread
+
+    if (setupRing(&ring) < 0) {
+        return URING_UNAVAILABLE;
+    }
+    ring.timeouts = *timeouts;
+    initWheel(&ring.wheel);
+
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Searching for a client...");
+    armAccept(&ring, my_socket);
+
+    while (1) {
+        if (!ring.tickArmed && (ring.wheel.count > 0 || ring.acceptDelayed)) {
+            armTick(&ring);
+        }
+        if (enterRing(&ring, 1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            errorhandler("io_uring_enter() failed.");
+            closesocket(ring.fd);
+            return -1;
+        }
+        ring.wheel.now = monotonicMs();
+
+        unsigned head = *ring.cqHead;
+        unsigned tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            struct io_uring_cqe *cqe = &ring.cqes[head & ring.cqMask];
+            void *source = (void*) (uintptr_t) (cqe->user_data & ~(uint64_t) EVENT_MASK);
+
+            switch (cqe->user_data & EVENT_MASK) {
+                case EVENT_ACCEPT:
+                    if (handleAccept(&ring, my_socket, cqe) < 0) {
+                        closesocket(ring.fd);
+                        return -1;
+                    }
+                    break;
+                case EVENT_RECV:
+                    handleRecv(&ring, source, cqe);
+                    break;
+                case EVENT_SEND:
+                    handleSend(&ring, source, cqe);
+                    break;
+                case EVENT_TIMEOUT:
+                    ring.tickArmed = 0;
+                    if (ring.acceptDelayed) {
+                        ring.acceptDelayed = 0;
+                        armAccept(&ring, my_socket);
+                    }
+                    break;
+            }
+        }
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+        advanceWheel(&ring.wheel, expireClient);
+
+        // Submit the replies of the batch, one linked chain per client
+        while (ring.dirty != NULL) {
+            struct UringClient *client = ring.dirty;
+            ring.dirty = client->nextDirty;
+            client->isDirty = 0;
+            flushReplies(&ring, client);
+            tryRelease(client);
+        }
+    }
+}
+
+/**
+ * @brief Creates the io_uring instance, maps its rings and registers the buffers.
+ *
+ * @param ring The ring to set up.
+ * @return 0 on success, -1 if the kernel does not support what the backend needs.
+ */
+static int setupRing(struct Ring *ring) {
+    struct io_uring_params params;
+
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SINGLE_ISSUER;
+    ring->fd = (int) syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    if (ring->fd < 0 && errno == EINVAL) {
+        // Older kernels reject the optional flags
+        memset(&params, 0, sizeof(params));
+        ring->fd = (int) syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    }
+    if (ring->fd < 0) {
+        errorhandler("io_uring_setup() failed.");
+        return -1;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        errorhandler("io_uring is too old for this backend.");
+        closesocket(ring->fd);
+        return -1;
+    }
+
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    size_t ringSize = sqSize > cqSize ? sqSize : cqSize;
+    char *rings = mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (rings == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        errorhandler("mmap() of the io_uring rings failed.");
+        closesocket(ring->fd);
+        return -1;
+    }
+
+    ring->sqHead = (unsigned*) (rings + params.sq_off.head);
+    ring->sqTail = (unsigned*) (rings + params.sq_off.tail);
+    ring->sqMask = *(unsigned*) (rings + params.sq_off.ring_mask);
+    ring->sqEntries = *(unsigned*) (rings + params.sq_off.ring_entries);
+    ring->sqLocalTail = *ring->sqTail;
+    ring->cqHead = (unsigned*) (rings + params.cq_off.head);
+    ring->cqTail = (unsigned*) (rings + params.cq_off.tail);
+    ring->cqMask = *(unsigned*) (rings + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*) (rings + params.cq_off.cqes);
+
+    // Submission slot i always holds entry i
+    unsigned *array = (unsigned*) (rings + params.sq_off.array);
+    for (unsigned i = 0; i < ring->sqEntries; i++) {
+        array[i] = i;
+    }
+
+    // Provided buffer ring: the kernel picks a free buffer for every received chunk
+    ring->bufferRing = mmap(NULL, URING_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ring->buffers = malloc((size_t) URING_BUFFERS * BUFFERSIZE);
+    if (ring->bufferRing == MAP_FAILED || ring->buffers == NULL) {
+        errorhandler("Out of memory for the io_uring buffers.");
+        closesocket(ring->fd);
+        return -1;
+    }
+
+    struct io_uring_buf_reg registration;
+    memset(&registration, 0, sizeof(registration));
+    registration.ring_addr = (uint64_t) (uintptr_t) ring->bufferRing;
+    registration.ring_entries = URING_BUFFERS;
+    registration.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        errorhandler("io_uring provided buffer rings are not supported.");
+        closesocket(ring->fd);
+        return -1;
+    }
+
+    ring->bufferRing->tail = 0;
+    for (unsigned short bid = 0; bid < URING_BUFFERS; bid++) {
+        recycleBuffer(ring, bid);
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns a receive buffer to the kernel.
+ *
+ * @param ring The ring owning the buffer.
+ * @param bid The identifier of the buffer.
+ */
+static void recycleBuffer(struct Ring *ring, unsigned short bid) {
+    unsigned short tail = ring->bufferRing->tail;
+    struct io_uring_buf *buffer = &ring->bufferRing->bufs[tail & (URING_BUFFERS - 1)];
+
+    buffer->addr = (uint64_t) (uintptr_t) (ring->buffers + (size_t) bid * BUFFERSIZE);
+    buffer->len = BUFFERSIZE;
+    buffer->bid = bid;
+    __atomic_store_n(&ring->bufferRing->tail, (unsigned short) (tail + 1), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Returns a cleared submission queue entry.
+ *
+ * When the queue is full the pending entries are submitted first.
+ *
+ * @param ring The ring.
+ * @return The entry, or NULL if the kernel does not consume the queue.
+ */
+static struct io_uring_sqe *getSqe(struct Ring *ring) {
+    if (ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries) {
+        enterRing(ring, 0);
+        if (ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries) {
+            errorhandler("io_uring submission queue is full.");
+            return NULL;
+        }
+    }
+
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sqLocalTail & ring->sqMask];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sqLocalTail++;
+    return sqe;
+}
+
+/**
+ * @brief Publishes the new submissions and optionally waits for completions.
+ *
+ * @param ring The ring.
+ * @param waitFor The number of completions to wait for.
+ * @return The number of entries submitted, -1 on failure.
+ */
+static int enterRing(struct Ring *ring, unsigned waitFor) {
+    __atomic_store_n(ring->sqTail, ring->sqLocalTail, __ATOMIC_RELEASE);
+    unsigned toSubmit = ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+
+    return (int) syscall(__NR_io_uring_enter, ring->fd, toSubmit, waitFor,
+                         waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+}
+
+/**
+ * @brief Queues a timeout that completes at the next tick of the wheel.
+ *
+ * With no client connected the timeout lasts a whole tick.
+ *
+ * @param ring The ring.
+ */
+static void armTick(struct Ring *ring) {
+    struct io_uring_sqe *sqe = getSqe(ring);
+    if (sqe == NULL) {
+        return;
+    }
+
+    int wait = wheelTimeout(&ring->wheel);
+    if (wait < 0) {
+        wait = WHEEL_TICK;
+    }
+    ring->tick.tv_sec = wait / 1000;
+    ring->tick.tv_nsec = (long long) (wait % 1000) * 1000000;
+
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = (uint64_t) (uintptr_t) &ring->tick;
+    sqe->len = 1;
+    sqe->user_data = EVENT_TIMEOUT;
+    ring->tickArmed = 1;
+}
+
+/**
+ * @brief Queues the multishot accept on the listening socket.
+ *
+ * @param ring The ring.
+ * @param my_socket The listening socket descriptor.
+ */
+static void armAccept(struct Ring *ring, int my_socket) {
+    struct io_uring_sqe *sqe = getSqe(ring);
+    if (sqe == NULL) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = my_socket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = EVENT_ACCEPT;
+}
+
+/**
+ * @brief Queues the multishot recv of a client on the provided buffer ring.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ */
+static void armRecv(struct Ring *ring, struct UringClient *client) {
+    struct io_uring_sqe *sqe = getSqe(ring);
+    if (sqe == NULL) {
+        stopClient(client);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = client->socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = (uint64_t) (uintptr_t) client | EVENT_RECV;
+    client->receiving = 1;
+}
+
+/**
+ * @brief Registers a client produced by the multishot accept.
+ *
+ * A terminated multishot accept is queued again at once after a client or an
+ * aborted connection. Out of descriptors or memory it is queued again at the next
+ * tick, as the dispatcher of WorkerPool.c backs off, and every other error stops
+ * the backend. Each failure is logged once, not at every completion.
+ *
+ * @param ring The ring.
+ * @param my_socket The listening socket descriptor.
+ * @param cqe The completion of the accept.
+ * @return 0 on success, -1 if the listening socket cannot accept anymore.
+ */
+static int handleAccept(struct Ring *ring, int my_socket, struct io_uring_cqe *cqe) {
+    char msgLog[BUFFERSIZE];
+    int terminated = !(cqe->flags & IORING_CQE_F_MORE);
+
+    if (cqe->res < 0) {
+        int error = -cqe->res;
+        if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+            if (ring->acceptError != error) {
+                errorhandler("accept() failed, out of resources.");
+                ring->acceptError = error;
+            }
+            ring->acceptDelayed = ring->acceptDelayed || terminated;
+            return 0;
+        }
+        if (error != ECONNABORTED && error != EINTR) {
+            errorhandler("accept() failed.");
+            return -1;
+        }
+        if (terminated) {
+            armAccept(ring, my_socket);
+        }
+        return 0;
+    }
+    ring->acceptError = 0;
+    if (terminated) {
+        armAccept(ring, my_socket); // The multishot accept has terminated
+    }
+
+    struct UringClient *client = calloc(1, sizeof(struct UringClient));
+    if (client == NULL) {
+        errorhandler("Out of memory, connection refused.");
+        closesocket(cqe->res);
+        return 0;
+    }
+    client->socket = cqe->res;
+    client->ring = ring;
+    client->started = ring->wheel.now;
+    initTimer(&client->timer, client);
+    initSession(&client->session);
+    socklen_t client_len = sizeof(client->address);
+    getpeername(client->socket, (struct sockaddr*) &client->address, &client_len);
+    inet_ntop(AF_INET, &client->address.sin_addr, client->addressString, sizeof(client->addressString));
+
+    if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+        snprintf(msgLog, sizeof(msgLog), "Connection established with %s:%d",
+                 client->addressString, ntohs(client->address.sin_port));
+        writeLog(msgLog);
+    }
+
+    struct UringReply *reply = replySpace(ring, client);
+    if (reply != NULL) {
+        queueStatic(&reply->output, welcomeBlock, BUFFERSIZE);
+    }
+    armRecv(ring, client);
+    updateDeadline(client);
+    return 0;
+}
+
+/**
+ * @brief Processes a request received by the multishot recv of a client.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ * @param cqe The completion of the recv.
+ */
+static void handleRecv(struct Ring *ring, struct UringClient *client, struct io_uring_cqe *cqe) {
+    if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+        unsigned short bid = (unsigned short) (cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        const char *data = ring->buffers + (size_t) bid * BUFFERSIZE;
+        int consumed = 0;
+        if (!client->closing && !client->paused && client->backlogLength == 0) {
+            consumed = handleData(ring, client, data, cqe->res);
+            updateDeadline(client);
+        }
+        if (consumed < cqe->res && !client->closing) {
+            stallInput(client, data + consumed, cqe->res - consumed);
+        }
+        recycleBuffer(ring, bid);
+    } else if (cqe->res == 0) {
+        if (!client->closing) {
+            LOG_MESSAGE(LOG_LEVEL_INFO, "Client has closed the connection.");
+        }
+        client->closing = 1;
+    } else if (cqe->res != -ENOBUFS && cqe->res != -ECANCELED) {
+        if (!client->closing) {
+            errorhandler("recv() failed or connection closed prematurely");
+        }
+        stopClient(client);
+    }
+
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        client->receiving = 0;
+        if (!client->closing && !client->paused) {
+            armRecv(ring, client); // Out of buffers for a moment: receive again
+        } else {
+            tryRelease(client);
+        }
+    }
+}
+
+/**
+ * @brief Feeds received bytes to the session of a client and answers every request.
+ *
+ * The requests already in the session are answered first; feeding stops when the
+ * client is paused, leaving the rest of the bytes to the caller.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ * @param data The received bytes.
+ * @param length The number of received bytes.
+ * @return The number of bytes consumed.
+ */
+static int handleData(struct Ring *ring, struct UringClient *client, const char *data, int length) {
+    int consumed = 0;
+
+    while (!client->closing && !client->paused) {
+        if (answerRequests(ring, client) < 0) {
+            errorhandler("Invalid frame received.");
+            stopClient(client);
+            break;
+        }
+        if (client->paused || consumed == length) {
+            break;
+        }
+        consumed += feedSession(&client->session, data + consumed, length - consumed);
+    }
+    return consumed;
+}
+
+/**
+ * @brief Answers the complete requests in the session of a client while it is not paused.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ * @return 0 on success, -1 on invalid frames.
+ */
+static int answerRequests(struct Ring *ring, struct UringClient *client) {
+    char request[BUFFERSIZE];
+    int requestLength;
+    int status = 0;
+
+    while (!client->closing && replySpace(ring, client) != NULL
+           && (status = nextRequest(&client->session, request, &requestLength)) > 0) {
+        if (status != REQUEST_TEXT) {
+            if (queueBinary(ring, client, status, request, requestLength) < 0) {
+                return -1;
+            }
+            if (status == REQUEST_BINARY && LOG_SAMPLED(LOG_LEVEL_DEBUG)) {
+                logEvent(LOG_EVENT_BINARY, &client->address, request, requestLength);
+            }
+            continue;
+        }
+
+        // A sampled request is logged together with its reply
+        int logged = LOG_SAMPLED(LOG_LEVEL_DEBUG);
+        if (logged) {
+            logEvent(LOG_EVENT_REQUEST, &client->address, request, requestLength);
+        }
+
+        // Process data according to the logic defined in the function
+        processData(request, requestLength, client->session.registers);
+
+        if (logged) {
+            logEvent(LOG_EVENT_REPLY, &client->address, request, (int) strlen(request));
+        }
+
+        queueReply(ring, client, request);
+
+        char *byeString = "Bye";
+        if (strcmp(request, byeString) == 0) {
+            stopClient(client);
+        }
+    }
+    return status < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Keeps received bytes that a paused client has not consumed.
+ *
+ * The multishot recv may still deliver input before its cancellation, so the bytes
+ * are copied out of the provided buffer, which goes back to the kernel at once
+ * instead of being held while the client does not read; the copy counts towards
+ * the memory of the replies.
+ *
+ * @param client The client.
+ * @param data The bytes.
+ * @param length The number of bytes.
+ */
+static void stallInput(struct UringClient *client, const char *data, int length) {
+    if (client->backlogLength + length > client->backlogSize) {
+        int size = client->backlogSize > 0 ? client->backlogSize : BUFFERSIZE;
+        while (size < client->backlogLength + length) {
+            size *= 2;
+        }
+
+        char *backlog = realloc(client->backlog, (size_t) size);
+        if (backlog == NULL) {
+            errorhandler("Out of memory for the input of a paused client.");
+            stopClient(client);
+            return;
+        }
+        reserveOutputMemory(size - client->backlogSize, 1);
+        client->backlog = backlog;
+        client->backlogSize = size;
+    }
+
+    memcpy(client->backlog + client->backlogLength, data, (size_t) length);
+    client->backlogLength += length;
+}
+
+/**
+ * @brief Stops reading from a client whose replies reached the high watermark.
+ *
+ * The multishot recv is cancelled; what it still delivers goes to the backlog.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ */
+static void pauseClient(struct Ring *ring, struct UringClient *client) {
+    client->paused = 1;
+    if (!client->receiving) {
+        return;
+    }
+
+    struct io_uring_sqe *sqe = getSqe(ring);
+    if (sqe == NULL) {
+        stopClient(client);
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (uint64_t) (uintptr_t) client | EVENT_RECV;
+    sqe->user_data = EVENT_CANCEL;
+}
+
+/**
+ * @brief Reads from a client again once its replies fell to the low watermark.
+ *
+ * The backlog is consumed first, so the requests are answered in the order they
+ * were received; the recv is armed again only once it is gone.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ */
+static void resumeClient(struct Ring *ring, struct UringClient *client) {
+    client->paused = 0;
+    if (client->backlog == NULL) {
+        handleData(ring, client, NULL, 0);
+    } else {
+        client->backlogOffset += handleData(ring, client, client->backlog + client->backlogOffset,
+                                            client->backlogLength - client->backlogOffset);
+        if (client->backlogOffset < client->backlogLength) {
+            return; // Paused again
+        }
+
+        free(client->backlog);
+        releaseOutputMemory(client->backlogSize);
+        client->backlog = NULL;
+        client->backlogOffset = 0;
+        client->backlogLength = 0;
+        client->backlogSize = 0;
+    }
+
+    if (!client->paused && !client->closing && !client->receiving) {
+        armRecv(ring, client);
+    }
+}
+
+/**
+ * @brief Accounts for a completed send and releases its reply.
+ *
+ * A short or failed send cancels the rest of the chain, so the client is dropped.
+ *
+ * @param ring The ring.
+ * @param reply The reply that was sent.
+ * @param cqe The completion of the send.
+ */
+static void handleSend(struct Ring *ring, struct UringReply *reply, struct io_uring_cqe *cqe) {
+    struct UringClient *client = reply->client;
+
+    if (cqe->res != reply->output.length && !client->closing) {
+        errorhandler("send() sent a different number of bytes than expected");
+        stopClient(client);
+    }
+    client->bytesInFlight -= reply->output.length;
+    free(reply);
+    releaseOutputMemory(sizeof(struct UringReply));
+
+    client->sendsInFlight--;
+    if (client->sendsInFlight == 0 && client->queueHead != NULL && !client->isDirty) {
+        // The previous chain is done: the queued replies can go
+        client->isDirty = 1;
+        client->nextDirty = ring->dirty;
+        ring->dirty = client;
+    }
+    if (client->paused && !client->closing && pendingBytes(client) <= OUTPUT_LOW_WATERMARK) {
+        resumeClient(ring, client);
+    }
+    if (!client->closing) {
+        updateDeadline(client);
+    }
+    tryRelease(client);
+}
+
+/**
+ * @brief Appends a reply to the queue of a client.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ * @param text The NUL-terminated reply.
+ */
+static void queueReply(struct Ring *ring, struct UringClient *client, const char *text) {
+    struct UringReply *reply = replySpace(ring, client);
+    if (reply != NULL) {
+        queueText(&reply->output, &client->session, text);
+    }
+}
+
+/**
+ * @brief Evaluates a binary, stream or linear request and appends its results to the queue of a client.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ * @param type REQUEST_BINARY, REQUEST_STREAM or REQUEST_LINEAR.
+ * @param request The payload of the frame.
+ * @param length The size of the payload.
+ * @return 0 on success, -1 if the payload is malformed.
+ */
+static int queueBinary(struct Ring *ring, struct UringClient *client, int type, const char *request, int length) {
+    struct UringReply *reply = replySpace(ring, client);
+    if (reply == NULL) {
+        return 0;
+    }
+
+    return queueBinaryReply(&reply->output, &client->session, type, request, length);
+}
+
+/**
+ * @brief Returns the batch of a client that receives the next reply.
+ *
+ * Replies produced before the next submission are packed into the last batch of
+ * the queue while it has room, so pipelined requests are answered by one send. A new
+ * batch is only added below the high watermark and within the memory limit,
+ * otherwise the client is paused.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ * @return A batch with room for MAXREPLYSIZE bytes, NULL if the client is paused or closed.
+ */
+static struct UringReply *replySpace(struct Ring *ring, struct UringClient *client) {
+    struct UringReply *reply = client->queueTail;
+
+    if (client->paused) {
+        return NULL;
+    }
+    if (reply == NULL || !outputHasRoom(&reply->output)) {
+        int pending = pendingBytes(client);
+        if (pending >= OUTPUT_HIGH_WATERMARK || !reserveOutputMemory(sizeof(struct UringReply), pending == 0)) {
+            pauseClient(ring, client);
+            return NULL;
+        }
+
+        reply = malloc(sizeof(struct UringReply));
+        if (reply == NULL) {
+            releaseOutputMemory(sizeof(struct UringReply));
+            errorhandler("Out of memory, reply dropped.");
+            stopClient(client);
+            return NULL;
+        }
+        reply->next = NULL;
+        reply->client = client;
+        resetOutput(&reply->output);
+
+        if (client->queueTail == NULL) {
+            client->queueHead = reply;
+        } else {
+            client->queueTail->next = reply;
+        }
+        client->queueTail = reply;
+    }
+
+    if (!client->isDirty) {
+        client->isDirty = 1;
+        client->nextDirty = ring->dirty;
+        ring->dirty = client;
+    }
+    return reply;
+}
+
+/**
+ * @brief Returns the bytes of the replies of a client that the client has not read.
+ *
+ * @param client The client.
+ * @return The bytes queued or being sent.
+ */
+static int pendingBytes(const struct UringClient *client) {
+    int length = client->bytesInFlight;
+
+    for (const struct UringReply *reply = client->queueHead; reply != NULL; reply = reply->next) {
+        length += reply->output.length;
+    }
+    return length;
+}
+
+/**
+ * @brief Submits the queued batches of a client as one chain of linked sendmsg.
+ *
+ * Only one chain per client is in flight, so the replies leave in order.
+ *
+ * @param ring The ring.
+ * @param client The client.
+ */
+static void flushReplies(struct Ring *ring, struct UringClient *client) {
+    if (client->sendsInFlight > 0) {
+        return; // handleSend() flushes again when the current chain is done
+    }
+
+    while (client->queueHead != NULL) {
+        struct UringReply *reply = client->queueHead;
+        if (reply->output.length == 0) {
+            // Room taken for a reply that no request needed
+            client->queueHead = reply->next;
+            free(reply);
+            releaseOutputMemory(sizeof(struct UringReply));
+            continue;
+        }
+
+        struct io_uring_sqe *sqe = getSqe(ring);
+        if (sqe == NULL) {
+            stopClient(client);
+            return;
+        }
+
+        client->queueHead = reply->next;
+        memset(&reply->message, 0, sizeof(reply->message));
+        reply->message.msg_iov = reply->output.iov;
+        reply->message.msg_iovlen = (size_t) reply->output.iovCount;
+
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = client->socket;
+        sqe->addr = (uint64_t) (uintptr_t) &reply->message;
+        sqe->len = 1;
+        sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+        sqe->flags = client->queueHead != NULL && client->queueHead->output.length > 0 ? IOSQE_IO_LINK : 0;
+        sqe->user_data = (uint64_t) (uintptr_t) reply | EVENT_SEND;
+        client->sendsInFlight++;
+        client->bytesInFlight += reply->output.length;
+    }
+    client->queueTail = NULL;
+}
+
+/**
+ * @brief Stops reading from a client; the queued replies are still sent.
+ *
+ * Shutting down the read side terminates the multishot recv.
+ *
+ * @param client The client.
+ */
+static void stopClient(struct UringClient *client) {
+    if (!client->closing) {
+        client->closing = 1;
+        shutdown(client->socket, SHUT_RD);
+    }
+}
+
+/**
+ * @brief Closes and frees a client once no operation refers to it anymore.
+ *
+ * @param client The client.
+ */
+static void tryRelease(struct UringClient *client) {
+    char msgLog[BUFFERSIZE];
+
+    if (!client->closing || client->receiving || client->sendsInFlight > 0 || client->isDirty) {
+        return;
+    }
+
+    cancelTimer(&client->ring->wheel, &client->timer);
+
+    // Replies that were never submitted are dropped with the client
+    while (client->queueHead != NULL) {
+        struct UringReply *reply = client->queueHead;
+        client->queueHead = reply->next;
+        free(reply);
+        releaseOutputMemory(sizeof(struct UringReply));
+    }
+    free(client->backlog);
+    releaseOutputMemory(client->backlogSize);
+    closeSession(&client->session);
+
+    closesocket(client->socket);
+    if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+        snprintf(msgLog, sizeof(msgLog), "Closing connection with %s:%d",
+                 client->addressString, ntohs(client->address.sin_port));
+        writeLog(msgLog);
+    }
+    free(client);
+}
+
+/**
+ * @brief Moves the deadline of a client after it made progress.
+ *
+ * A client in the middle of a request, or with replies still queued or in flight,
+ * gets the read timeout, an idle one the idle timeout; neither can go past the end
+ * of the session.
+ *
+ * @param client The client.
+ */
+static void updateDeadline(struct UringClient *client) {
+    struct Ring *ring = client->ring;
+    int waiting = client->session.inputLength > 0 || client->backlogLength > 0 || pendingBytes(client) > 0;
+    int timeout = waiting ? ring->timeouts.read : ring->timeouts.idle;
+    long long deadline = timeout > 0 ? ring->wheel.now + timeout : -1;
+
+    if (ring->timeouts.session > 0) {
+        long long end = client->started + ring->timeouts.session;
+        if (deadline < 0 || end < deadline) {
+            deadline = end;
+        }
+    }
+
+    if (deadline < 0) {
+        cancelTimer(&ring->wheel, &client->timer);
+    } else {
+        scheduleTimer(&ring->wheel, &client->timer, deadline);
+    }
+}
+
+/**
+ * @brief Disconnects a client whose deadline has passed.
+ *
+ * Shutting down both directions terminates the recv and fails the sends in
+ * flight, so the client is released once their completions arrive.
+ *
+ * @param timer The timer of the client.
+ */
+static void expireClient(struct Timer *timer) {
+    char msgLog[BUFFERSIZE];
+    struct UringClient *client = timer->owner;
+    struct Ring *ring = client->ring;
+    const char *reason = "Idle timeout";
+
+    if (ring->timeouts.session > 0 && ring->wheel.now >= client->started + ring->timeouts.session) {
+        reason = "Session timeout";
+    } else if (client->session.inputLength > 0 || client->backlogLength > 0 || pendingBytes(client) > 0) {
+        reason = "Read timeout";
+    }
+
+    if (LOG_ENABLED(LOG_LEVEL_INFO)) {
+        snprintf(msgLog, sizeof(msgLog), "%s of %s:%d", reason,
+                 client->addressString, ntohs(client->address.sin_port));
+        writeLog(msgLog);
+    }
+    client->closing = 1;
+    shutdown(client->socket, SHUT_RDWR);
+    tryRelease(client);
+}
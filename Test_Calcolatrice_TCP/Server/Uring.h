@@ -0,0 +1,29 @@
+#ifndef SERVER_URING_H_
+#define SERVER_URING_H_
+
+/**
+ * @file Uring.h
+ * @brief Header file for the io_uring backend of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define URING_ENTRIES 4096      // Submission queue entries of the ring
+#define URING_BUFFERS 4096      // Receive buffers provided to the kernel (power of two)
+#define URING_UNAVAILABLE (-2)  // Returned when the kernel does not support the backend
+
+/**
+ * @brief Serves the clients through io_uring.
+ *
+ * A multishot accept produces the clients, a multishot recv per client fills the
+ * buffers of a provided buffer ring, and the replies of a client are submitted as a
+ * chain of linked sendmsg over their fragments, so a busy server enters the kernel
+ * once per batch.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return URING_UNAVAILABLE if the ring cannot be set up, -1 if it fails later.
+ */
+int runUringServer(int my_socket, const struct Timeouts *timeouts);
+
+#endif /* SERVER_URING_H_ */
@@ -0,0 +1,375 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Vector.h"
+
+#if (defined __x86_64__ || defined __i386__) && defined __GNUC__
+#define VECTOR_X86 1            // The SIMD kernels are compiled
+#include <immintrin.h>  // SSE2, AVX2 and AVX-512 intrinsics
+#endif
+
+/**
+ * @file Vector.c
+ * @brief Implementation file for the operations of Calculator.c applied to arrays.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Every kernel of an instruction set is compiled for it with the target attribute
+ * and only called once CPUID reported it, the rest of the file keeps the flags of
+ * the build.
+ */
+
+/**
+ * @brief The kernels of an instruction set.
+ */
+struct Kernels {
+    void (*add)(const double *a, const double *b, double *result, int count);
+    void (*sub)(const double *a, const double *b, double *result, int count);
+    void (*mult)(const double *a, const double *b, double *result, int count);
+    int (*divide)(const double *a, const double *b, double *result, unsigned char *errors, int count);
+};
+
+static const char *levelNames[] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+static int vectorLevel = -1;    // VECTOR_ level in use, -1 until CPUID is read
+
+static int getSupportedLevel(void);
+static const struct Kernels *getKernels(void);
+static void addScalar(const double *a, const double *b, double *result, int count);
+static void subScalar(const double *a, const double *b, double *result, int count);
+static void multScalar(const double *a, const double *b, double *result, int count);
+static int divideScalar(const double *a, const double *b, double *result, unsigned char *errors, int count);
+
+#if defined VECTOR_X86
+/**
+ * @brief Defines the kernel of an operator for the instruction set of a vector type.
+ *
+ * The elements left after the last whole vector are done one at a time.
+ */
+#define ELEMENTWISE_KERNEL(name, isa, width, load, store, vectorOperation, operation) \
+    __attribute__((target(isa))) \
+    static void name(const double *a, const double *b, double *result, int count) { \
+        int i = 0; \
+        for (; i + (width) <= count; i += (width)) { \
+            store(result + i, vectorOperation(load(a + i), load(b + i))); \
+        } \
+        for (; i < count; i++) { \
+            result[i] = a[i] operation b[i]; \
+        } \
+    }
+
+/**
+ * @brief Defines the AVX-512 kernel of an operator.
+ *
+ * The elements left after the last whole vector are done with masked loads and
+ * stores, which never touch the memory past the arrays.
+ */
+#define MASKED_KERNEL(name, vectorOperation) \
+    __attribute__((target("avx512f"))) \
+    static void name(const double *a, const double *b, double *result, int count) { \
+        int i = 0; \
+        for (; i + 8 <= count; i += 8) { \
+            _mm512_storeu_pd(result + i, vectorOperation(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))); \
+        } \
+        if (i < count) { \
+            __mmask8 tail = (__mmask8) ((1u << (count - i)) - 1); \
+            _mm512_mask_storeu_pd(result + i, tail, vectorOperation(_mm512_maskz_loadu_pd(tail, a + i), \
+                                                                    _mm512_maskz_loadu_pd(tail, b + i))); \
+        } \
+    }
+
+ELEMENTWISE_KERNEL(addSse2, "sse2", 2, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, +)
+ELEMENTWISE_KERNEL(subSse2, "sse2", 2, _mm_loadu_pd, _mm_storeu_pd, _mm_sub_pd, -)
+ELEMENTWISE_KERNEL(multSse2, "sse2", 2, _mm_loadu_pd, _mm_storeu_pd, _mm_mul_pd, *)
+ELEMENTWISE_KERNEL(addAvx2, "avx2", 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd, +)
+ELEMENTWISE_KERNEL(subAvx2, "avx2", 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_sub_pd, -)
+ELEMENTWISE_KERNEL(multAvx2, "avx2", 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_mul_pd, *)
+MASKED_KERNEL(addAvx512, _mm512_add_pd)
+MASKED_KERNEL(subAvx512, _mm512_sub_pd)
+MASKED_KERNEL(multAvx512, _mm512_mul_pd)
+
+/**
+ * @brief Writes the lanes of a comparison mask as one byte each.
+ *
+ * @param errors Receives width bytes, 1 where the bit of the lane is set.
+ * @param mask The mask, lane 0 in bit 0.
+ * @param width The number of lanes.
+ */
+static inline void spreadMask(unsigned char *errors, unsigned int mask, int width) {
+    for (int lane = 0; lane < width; lane++) {
+        errors[lane] = (unsigned char) ((mask >> lane) & 1);
+    }
+}
+
+/**
+ * @brief Divides two arrays with SSE2, 2 doubles at a time.
+ */
+__attribute__((target("sse2")))
+static int divideSse2(const double *a, const double *b, double *result, unsigned char *errors, int count) {
+    const __m128d zero = _mm_setzero_pd();
+    int failures = 0;
+    int i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        __m128d divisor = _mm_loadu_pd(b + i);
+        __m128d isZero = _mm_cmpeq_pd(divisor, zero);
+        _mm_storeu_pd(result + i, _mm_andnot_pd(isZero, _mm_div_pd(_mm_loadu_pd(a + i), divisor)));
+        unsigned int mask = (unsigned int) _mm_movemask_pd(isZero);
+        spreadMask(errors + i, mask, 2);
+        failures += __builtin_popcount(mask);
+    }
+    return failures + divideScalar(a + i, b + i, result + i, errors + i, count - i);
+}
+
+/**
+ * @brief Divides two arrays with AVX2, 4 doubles at a time.
+ */
+__attribute__((target("avx2")))
+static int divideAvx2(const double *a, const double *b, double *result, unsigned char *errors, int count) {
+    const __m256d zero = _mm256_setzero_pd();
+    int failures = 0;
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256d divisor = _mm256_loadu_pd(b + i);
+        __m256d isZero = _mm256_cmp_pd(divisor, zero, _CMP_EQ_OQ);
+        _mm256_storeu_pd(result + i, _mm256_andnot_pd(isZero, _mm256_div_pd(_mm256_loadu_pd(a + i), divisor)));
+        unsigned int mask = (unsigned int) _mm256_movemask_pd(isZero);
+        spreadMask(errors + i, mask, 4);
+        failures += __builtin_popcount(mask);
+    }
+    return failures + divideScalar(a + i, b + i, result + i, errors + i, count - i);
+}
+
+/**
+ * @brief Divides two arrays with AVX-512, 8 doubles at a time.
+ *
+ * The lanes with a zero divisor are not divided at all: the masked division
+ * writes 0 in them.
+ */
+__attribute__((target("avx512f")))
+static int divideAvx512(const double *a, const double *b, double *result, unsigned char *errors, int count) {
+    const __m512d zero = _mm512_setzero_pd();
+    int failures = 0;
+
+    for (int i = 0; i < count; i += 8) {
+        __mmask8 lanes = count - i >= 8 ? (__mmask8) 0xFF : (__mmask8) ((1u << (count - i)) - 1);
+        __m512d divisor = _mm512_maskz_loadu_pd(lanes, b + i);
+        __mmask8 isZero = _mm512_mask_cmp_pd_mask(lanes, divisor, zero, _CMP_EQ_OQ);
+        __m512d quotient = _mm512_maskz_div_pd((__mmask8) (lanes & ~isZero), _mm512_maskz_loadu_pd(lanes, a + i), divisor);
+        _mm512_mask_storeu_pd(result + i, lanes, quotient);
+        spreadMask(errors + i, isZero, count - i >= 8 ? 8 : count - i);
+        failures += __builtin_popcount(isZero);
+    }
+    return failures;
+}
+#endif
+
+static const struct Kernels kernels[] = {
+    { addScalar, subScalar, multScalar, divideScalar },
+#if defined VECTOR_X86
+    { addSse2, subSse2, multSse2, divideSse2 },
+    { addAvx2, subAvx2, multAvx2, divideAvx2 },
+    { addAvx512, subAvx512, multAvx512, divideAvx512 },
+#endif
+};
+
+/**
+ * @brief Returns the instruction set the kernels use.
+ *
+ * @return The VECTOR_ level.
+ */
+int getVectorLevel(void) {
+    int level = __atomic_load_n(&vectorLevel, __ATOMIC_RELAXED);
+    if (level < 0) {
+        // Every thread that gets here reads the same answer from CPUID
+        level = getSupportedLevel();
+        __atomic_store_n(&vectorLevel, level, __ATOMIC_RELAXED);
+    }
+    return level;
+}
+
+/**
+ * @brief Selects the instruction set of the kernels, to compare them.
+ *
+ * @param level The VECTOR_ level wanted.
+ * @return The level used, lower than the wanted one if the processor lacks it.
+ */
+int setVectorLevel(int level) {
+    int supported = getSupportedLevel();
+    if (level > supported) {
+        level = supported;
+    }
+    if (level < VECTOR_SCALAR) {
+        level = VECTOR_SCALAR;
+    }
+    __atomic_store_n(&vectorLevel, level, __ATOMIC_RELAXED);
+    return level;
+}
+
+/**
+ * @brief Returns the name of an instruction set.
+ *
+ * @param level The VECTOR_ level.
+ * @return A static string such as "AVX2".
+ */
+const char *getVectorLevelName(int level) {
+    if (level < VECTOR_SCALAR || level > VECTOR_AVX512) {
+        return "unknown";
+    }
+    return levelNames[level];
+}
+
+/**
+ * @brief Adds two arrays: result[i] = a[i] + b[i].
+ *
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the sums, may be one of the operands.
+ * @param count The number of elements.
+ */
+void addVectors(const double *a, const double *b, double *result, int count) {
+    getKernels()->add(a, b, result, count);
+}
+
+/**
+ * @brief Subtracts two arrays: result[i] = a[i] - b[i].
+ *
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the differences, may be one of the operands.
+ * @param count The number of elements.
+ */
+void subVectors(const double *a, const double *b, double *result, int count) {
+    getKernels()->sub(a, b, result, count);
+}
+
+/**
+ * @brief Multiplies two arrays: result[i] = a[i] * b[i].
+ *
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the products, may be one of the operands.
+ * @param count The number of elements.
+ */
+void multVectors(const double *a, const double *b, double *result, int count) {
+    getKernels()->mult(a, b, result, count);
+}
+
+/**
+ * @brief Divides two arrays: result[i] = a[i] / b[i].
+ *
+ * @param a The numerators.
+ * @param b The denominators.
+ * @param result Receives the quotients, 0 where the divisor is zero.
+ * @param errors Receives one byte per lane, 1 where the divisor is zero.
+ * @param count The number of elements.
+ * @return The number of zero divisors.
+ */
+int divideVectors(const double *a, const double *b, double *result, unsigned char *errors, int count) {
+    return getKernels()->divide(a, b, result, errors, count);
+}
+
+/**
+ * @brief Applies one of the operators + - * / to two arrays.
+ *
+ * @param operator The operator.
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the results, may be one of the operands.
+ * @param errors Receives one byte per lane, 1 where the operation failed.
+ * @param count The number of elements.
+ * @return CALC_OK, or CALC_UNKNOWN_OPERATOR leaving the results unchanged.
+ */
+int calculateVectors(char operator, const double *a, const double *b, double *result,
+                     unsigned char *errors, int count) {
+    const struct Kernels *kernel = getKernels();
+
+    switch (operator) {
+        case '+':
+            kernel->add(a, b, result, count);
+            break;
+        case '-':
+            kernel->sub(a, b, result, count);
+            break;
+        case '*':
+            kernel->mult(a, b, result, count);
+            break;
+        case '/':
+            kernel->divide(a, b, result, errors, count);
+            return CALC_OK;
+        default:
+            return CALC_UNKNOWN_OPERATOR;
+    }
+    memset(errors, 0, count);
+    return CALC_OK;
+}
+
+/**
+ * @brief Reads the best instruction set of the processor with CPUID.
+ *
+ * @return The VECTOR_ level.
+ */
+static int getSupportedLevel(void) {
+#if defined VECTOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return VECTOR_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return VECTOR_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return VECTOR_SSE2;
+    }
+#endif
+    return VECTOR_SCALAR;
+}
+
+/**
+ * @brief Returns the kernels of the instruction set in use.
+ *
+ * @return The kernels.
+ */
+static const struct Kernels *getKernels(void) {
+    return &kernels[getVectorLevel()];
+}
+
+/**
+ * @brief Adds two arrays one element at a time.
+ */
+static void addScalar(const double *a, const double *b, double *result, int count) {
+    for (int i = 0; i < count; i++) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+/**
+ * @brief Subtracts two arrays one element at a time.
+ */
+static void subScalar(const double *a, const double *b, double *result, int count) {
+    for (int i = 0; i < count; i++) {
+        result[i] = a[i] - b[i];
+    }
+}
+
+/**
+ * @brief Multiplies two arrays one element at a time.
+ */
+static void multScalar(const double *a, const double *b, double *result, int count) {
+    for (int i = 0; i < count; i++) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+/**
+ * @brief Divides two arrays one element at a time.
+ */
+static int divideScalar(const double *a, const double *b, double *result, unsigned char *errors, int count) {
+    int failures = 0;
+
+    for (int i = 0; i < count; i++) {
+        errors[i] = b[i] == 0;
+        result[i] = errors[i] ? 0 : a[i] / b[i];
+        failures += errors[i];
+    }
+    return failures;
+}
@@ -0,0 +1,106 @@
+#ifndef SERVER_VECTOR_H_
+#define SERVER_VECTOR_H_
+
+/**
+ * @file Vector.h
+ * @brief Header file for the operations of Calculator.c applied to arrays.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Every function combines the elements of two arrays of doubles lane by lane,
+ * with the widest SIMD instructions the processor supports: SSE2, AVX2 or
+ * AVX-512 on x86, plain loops elsewhere. The instruction set is read with CPUID
+ * the first time a kernel runs, so a single binary runs on every processor.
+ * The results are the same at every level, a division included.
+ */
+
+#define VECTOR_SCALAR 0         // Plain C loops
+#define VECTOR_SSE2 1           // 2 doubles per instruction
+#define VECTOR_AVX2 2           // 4 doubles per instruction, with the fused multiply-add
+#define VECTOR_AVX512 3         // 8 doubles per instruction
+
+/**
+ * @brief Returns the instruction set the kernels use.
+ *
+ * @return The VECTOR_ level, the best one the processor supports unless lowered
+ *         with setVectorLevel().
+ */
+int getVectorLevel(void);
+
+/**
+ * @brief Selects the instruction set of the kernels, to compare them.
+ *
+ * @param level The VECTOR_ level wanted.
+ * @return The level used, lower than the wanted one if the processor lacks it.
+ */
+int setVectorLevel(int level);
+
+/**
+ * @brief Returns the name of an instruction set.
+ *
+ * @param level The VECTOR_ level.
+ * @return A static string such as "AVX2".
+ */
+const char *getVectorLevelName(int level);
+
+/**
+ * @brief Adds two arrays: result[i] = a[i] + b[i].
+ *
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the sums, may be one of the operands.
+ * @param count The number of elements.
+ */
+void addVectors(const double *a, const double *b, double *result, int count);
+
+/**
+ * @brief Subtracts two arrays: result[i] = a[i] - b[i].
+ *
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the differences, may be one of the operands.
+ * @param count The number of elements.
+ */
+void subVectors(const double *a, const double *b, double *result, int count);
+
+/**
+ * @brief Multiplies two arrays: result[i] = a[i] * b[i].
+ *
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the products, may be one of the operands.
+ * @param count The number of elements.
+ */
+void multVectors(const double *a, const double *b, double *result, int count);
+
+/**
+ * @brief Divides two arrays: result[i] = a[i] / b[i].
+ *
+ * Instead of a quotient, a zero divisor (of either sign) sets errors[i] to 1 and
+ * result[i] to 0; every other lane gets errors[i] = 0.
+ *
+ * @param a The numerators.
+ * @param b The denominators.
+ * @param result Receives the quotients, may be one of the operands.
+ * @param errors Receives one byte per lane, 1 where the divisor is zero.
+ * @param count The number of elements.
+ * @return The number of zero divisors.
+ */
+int divideVectors(const double *a, const double *b, double *result, unsigned char *errors, int count);
+
+/**
+ * @brief Applies one of the operators + - * / to two arrays.
+ *
+ * @param operator The operator.
+ * @param a The first operands.
+ * @param b The second operands.
+ * @param result Receives the results, may be one of the operands.
+ * @param errors Receives one byte per lane, 1 where the operation failed
+ *               (a zero divisor).
+ * @param count The number of elements.
+ * @return CALC_OK, or CALC_UNKNOWN_OPERATOR leaving the results unchanged.
+ */
+int calculateVectors(char operator, const double *a, const double *b, double *result,
+                     unsigned char *errors, int count);
+
+#endif /* SERVER_VECTOR_H_ */
@@ -0,0 +1,93 @@
+#define _GNU_SOURCE     // accept4()
+
+#include "Headers.h"
+#include "Server.h"
+#include "Log.h"
+#include "Session.h"
+#include "Output.h"
+#include "TimerWheel.h"
+#include "Reactor.h"
+#include "WorkerPool.h"
+
+#include <errno.h>      // Error numbers of the socket calls
+#include <pthread.h>    // POSIX threads
+
+/**
+ * @file WorkerPool.c
+ * @brief Implementation file for the multi-threaded mode of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+static void *workerMain(void *reactor);
+
+/**
+ * @brief Serves the clients with a pool of worker threads.
+ *
+ * The connections never move once dispatched, so each one is only ever touched by
+ * the thread of its reactor and needs no locking.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param workers The number of worker threads to start (1..MAXWORKERS).
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if the pool cannot be started or accept() fails.
+ */
+int runWorkerPool(int my_socket, int workers, const struct Timeouts *timeouts) {
+    char msgLog[BUFFERSIZE];
+    static struct Reactor reactors[MAXWORKERS];
+    pthread_t threads[MAXWORKERS];
+
+    if (workers < 1 || workers > MAXWORKERS) {
+        errorhandler("Invalid number of worker threads.");
+        return -1;
+    }
+
+    for (int i = 0; i < workers; i++) {
+        if (initReactor(&reactors[i], -1, 1, timeouts) < 0) {
+            return -1;
+        }
+        if (pthread_create(&threads[i], NULL, workerMain, &reactors[i]) != 0) {
+            errorhandler("pthread_create() failed.");
+            return -1;
+        }
+        pthread_detach(threads[i]);
+    }
+
+    snprintf(msgLog, sizeof(msgLog), "Started %d worker threads.", workers);
+    LOG_MESSAGE(LOG_LEVEL_INFO, msgLog);
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Searching for a client...");
+
+    int next = 0;
+    while (1) {
+        struct sockaddr_in cad;
+        socklen_t client_len = sizeof(cad);
+        int client_socket = accept4(my_socket, (struct sockaddr*) &cad, &client_len, SOCK_NONBLOCK);
+
+        if (client_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                errorhandler("accept() failed, out of resources.");
+                usleep(10000); // Give the workers time to release descriptors
+                continue;
+            }
+            errorhandler("accept() failed.");
+            return -1;
+        }
+
+        handOffClient(&reactors[next], client_socket, cad);
+        next = (next + 1) % workers;
+    }
+}
+
+/**
+ * @brief Body of a worker thread: runs the reactor it was given.
+ *
+ * @param reactor The reactor of the worker.
+ * @return Always NULL.
+ */
+static void *workerMain(void *reactor) {
+    runReactorLoop(reactor);
+    return NULL;
+}
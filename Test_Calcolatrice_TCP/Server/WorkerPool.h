@@ -0,0 +1,26 @@
+#ifndef SERVER_WORKERPOOL_H_
+#define SERVER_WORKERPOOL_H_
+
+/**
+ * @file WorkerPool.h
+ * @brief Header file for the multi-threaded mode of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define MAXWORKERS 256          // Maximum number of worker threads
+
+/**
+ * @brief Serves the clients with a pool of worker threads.
+ *
+ * Every worker runs its own reactor; the calling thread accepts the connections
+ * and dispatches them to the workers in round-robin order.
+ *
+ * @param my_socket The listening socket descriptor.
+ * @param workers The number of worker threads to start (1..MAXWORKERS).
+ * @param timeouts The deadlines after which a client is disconnected.
+ * @return -1 if the pool cannot be started or accept() fails.
+ */
+int runWorkerPool(int my_socket, int workers, const struct Timeouts *timeouts);
+
+#endif /* SERVER_WORKERPOOL_H_ */
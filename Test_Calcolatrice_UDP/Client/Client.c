@@ -72,6 +72,7 @@ int main(int argc, char *argv[]) {
         printf("%s\n",msgLog);
         writeLog(msgLog);
         closeConnection(c_socket);
+        return -1;
     }
 
     // 3) Bind the socket
@@ -211,7 +212,7 @@ void closeConnection(int c_socket) {
     system("pause");
 #else
     // Unix-like systems command
-    system("clear")
+    system("clear");
     printf("Press any key to close the process...");
     getchar();
 #endif
@@ -338,9 +339,11 @@ void inputString(char *msg) {
         sprintf(msgLog,"Closing the connection...");
         printf("%s\n",msgLog);
         writeLog(msgLog);
+    } else if (operator == BATCH_OPERATOR || operator == EXPRESSION_OPERATOR) {
+        // Batch of operations or expression: validated by the server
     } else {
         if (sscanf(msg, "%c %lf %lf", &operator, &num1, &num2) != 3|| strchr("+-*/", operator) == NULL) {
-            sprintf(msgLog,"Invalid input format. Please use the format: operator [+-*/] value value or = to close the connection");
+            sprintf(msgLog,"Invalid input format. Please use the format: operator [+-*/] value value..., B followed by operations separated by ;, X followed by an expression or = to close the connection");
             printf("%s\n",msgLog);
             writeLog(msgLog);
             inputString(msg); // Prompt the user to enter a valid input
@@ -351,47 +354,53 @@ void inputString(char *msg) {
 /**
  * @brief Write a log message to a file.
  *
- * This function opens a log file ("Log.txt") and appends a log message
- * along with a timestamp to the file. If the file cannot be opened,
- * an error message is printed to the console.
+ * This function opens a log file ("Log.txt") on its first call and keeps it open,
+ * appending every log message along with a timestamp that is formatted at most
+ * once per second. If the file cannot be opened, an error message is printed to
+ * the console.
  *
  * @param message The log message to be written to the file.
  */
 void writeLog(const char *message) {
-    char logFilePath[256];
-    FILE *file;
+    static FILE *file = NULL;           // Log file, opened by the first message
+    static time_t cachedSecond = -1;    // Second dateAndTime was formatted for
+    static char dateAndTime[20];        // Current date and time
+
+    if (file == NULL) {
+        char logFilePath[512];
 
-    // Get the path of the running program
-    char basePath[256];
+        // Get the path of the running program
+        char basePath[256];
 
 #ifdef _WIN32
-    GetModuleFileName(NULL, basePath, sizeof(basePath));
+        GetModuleFileName(NULL, basePath, sizeof(basePath));
 #else
-    readlink("/proc/self/exe", basePath, sizeof(basePath));
+        readlink("/proc/self/exe", basePath, sizeof(basePath));
 #endif
 
-    // Remove the executable name from the path
-    char *lastSlash = strrchr(basePath, '\\');
-    if (lastSlash != NULL) {
-        *lastSlash = '\0';
-    }
+        // Remove the executable name from the path
+        char *lastSlash = strrchr(basePath, '\\');
+        if (lastSlash != NULL) {
+            *lastSlash = '\0';
+        }
 
-    // Construct the full path to the log file
-    snprintf(logFilePath, sizeof(logFilePath), "%s\\Server_UDP\\Debug\\Log.txt", basePath);
-    file = fopen(logFilePath, "a");
+        // Construct the full path to the log file
+        snprintf(logFilePath, sizeof(logFilePath), "%s\\Server_UDP\\Debug\\Log.txt", basePath);
+        file = fopen(logFilePath, "a");
+    }
 
     if (file != NULL) {
         time_t timestamp = time(NULL);
-        struct tm *timeInfo = localtime(&timestamp);
-
-        // Get current date and time
-        char dateAndTime[20];
-        strftime(dateAndTime, sizeof(dateAndTime), "%H:%M:%S %d/%m/%Y", timeInfo);
+        if (timestamp != cachedSecond) {
+            // Get current date and time
+            struct tm *timeInfo = localtime(&timestamp);
+            strftime(dateAndTime, sizeof(dateAndTime), "%H:%M:%S %d/%m/%Y", timeInfo);
+            cachedSecond = timestamp;
+        }
 
         // Write the log message to the file
         fprintf(file, "CLIENT - [%s] - %s\n", dateAndTime, message);
-
-        fclose(file);
+        fflush(file);
     } else {
         printf("Error opening the log file.\n");
     }
@@ -11,6 +11,8 @@
 #define PROTOPORT "56700"        /**< Default Server Port */
 #define PROTO_ADDR "127.0.0.1"    /**< Default Server Address */
 #define BUFFERSIZE 256            /**< Default Buffer Size */
+#define BATCH_OPERATOR 'B'        /**< First character of a batch request: "B + 1 2; * 3 4" */
+#define EXPRESSION_OPERATOR 'X'   /**< First character of an expression request: "X (1 + 2) * -3" */
 
 char msg[BUFFERSIZE];    /**< Message Array */
 char msgLog[BUFFERSIZE]; /**< Message Log */
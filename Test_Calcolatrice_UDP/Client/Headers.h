@@ -24,6 +24,7 @@
 #include <sys/socket.h> /**< Socket functions */
 #include <arpa/inet.h>  /**< Definitions for internet operations */
 #include <netinet/in.h> /**< Internet address family */
+#include <netdb.h>      /**< Network database operations */
 #define closesocket close
 #endif
 
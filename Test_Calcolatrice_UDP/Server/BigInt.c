@@ -0,0 +1,749 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Scanner.h"
+#include "Number.h"
+#include "BigInt.h"
+
+/**
+ * @file BigInt.c
+ * @brief Implementation file for the arbitrary-precision integers.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The magnitudes are arrays of 32 bit limbs, so every product of two limbs and
+ * the carries fit in a uint64_t on any compiler. The functions on magnitudes take
+ * (limbs, length) pairs and leave the signs to the callers.
+ */
+
+#define CHUNK_DIGITS 9          // Decimal digits converted at a time
+#define CHUNK_BASE 1000000000u  // 10^CHUNK_DIGITS, the largest power of ten in a limb
+#define BIGINT_CHUNKS (BIGINT_LIMBS + BIGINT_LIMBS / 8 + 2) // Chunks of CHUNK_DIGITS digits in a number
+#define BIGINT_DIGITS (BIGINT_CHUNKS * CHUNK_DIGITS + 1)    // Characters of a number, sign included
+
+static int karatsubaThreshold = BIGINT_KARATSUBA; // Limbs of the smaller factor from which Karatsuba is used
+
+static int normalizeLimbs(const uint32_t *limbs, int length);
+static int compareMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB);
+static int addMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *sum);
+static int subMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *difference);
+static void addInto(uint32_t *target, int lengthTarget, const uint32_t *addend, int lengthAddend);
+static void multiplyMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *product);
+static void multiplySchoolbook(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *product);
+static void multiplyKaratsuba(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *product);
+static void divideMagnitudes(const uint32_t *u, int lengthU, const uint32_t *v, int lengthV,
+                             uint32_t *quotient, uint32_t *remainder);
+static int multiplyAdd(struct BigInt *number, uint32_t multiplier, uint32_t addend);
+static uint32_t divideSmall(uint32_t *limbs, int length, uint32_t divisor);
+static int addSigned(const struct BigInt *a, const struct BigInt *b, int negateB, struct BigInt *result);
+static int setBigInt(struct BigInt *number, const uint32_t *limbs, int length, int negative);
+static int writeText(char *buffer, int size, const char *text, int length);
+
+/**
+ * @brief Reads an integer at the start of a view: [+|-] digits.
+ *
+ * The digits are read CHUNK_DIGITS at a time, each chunk costing a single
+ * multiply-add over the limbs.
+ *
+ * @param text The first character of the view.
+ * @param length The number of characters of the view.
+ * @param number Receives the integer.
+ * @return The number of characters read, 0 if the view does not start with an
+ *         integer or it does not fit in BIGINT_LIMBS limbs.
+ */
+int parseBigInt(const char *text, int length, struct BigInt *number) {
+    int i = 0;
+    int negative = 0;
+
+    if (i < length && (text[i] == '+' || text[i] == '-')) {
+        negative = text[i] == '-';
+        i++;
+    }
+    int start = i;
+    while (i < length && text[i] >= '0' && text[i] <= '9') {
+        i++;
+    }
+    if (i == start) {
+        return 0;
+    }
+
+    number->negative = 0;
+    number->length = 0;
+    int chunkLength = (i - start) % CHUNK_DIGITS;
+    if (chunkLength == 0) {
+        chunkLength = CHUNK_DIGITS;
+    }
+    for (int position = start; position < i; position += chunkLength, chunkLength = CHUNK_DIGITS) {
+        uint32_t chunk = 0;
+        uint32_t multiplier = 1;
+        for (int j = 0; j < chunkLength; j++) {
+            chunk = chunk * 10 + (uint32_t) (text[position + j] - '0');
+            multiplier *= 10;
+        }
+        if (multiplyAdd(number, multiplier, chunk) < 0) {
+            return 0;
+        }
+    }
+    number->negative = negative && number->length > 0;
+    return i;
+}
+
+/**
+ * @brief Writes an integer in decimal.
+ *
+ * The limbs are divided by CHUNK_BASE until nothing is left, every division
+ * giving the next CHUNK_DIGITS digits from the right.
+ *
+ * @param number The integer.
+ * @param buffer Buffer receiving the terminated text, truncated if it is too small.
+ * @param size The size of the buffer.
+ * @return The length of the whole text, as snprintf().
+ */
+int formatBigInt(const struct BigInt *number, char *buffer, int size) {
+    uint32_t limbs[BIGINT_LIMBS];
+    uint32_t chunks[BIGINT_CHUNKS];
+    char text[BIGINT_DIGITS];
+    int length = number->length;
+    int numChunks = 0;
+    int textLength = 0;
+
+    memcpy(limbs, number->limbs, length * sizeof(uint32_t));
+    while (length > 0) {
+        chunks[numChunks++] = divideSmall(limbs, length, CHUNK_BASE);
+        length = normalizeLimbs(limbs, length);
+    }
+
+    if (number->negative) {
+        text[textLength++] = '-';
+    }
+    if (numChunks == 0) {
+        text[textLength++] = '0';
+    }
+    for (int i = numChunks - 1; i >= 0; i--) {
+        char digits[CHUNK_DIGITS];
+        uint32_t chunk = chunks[i];
+        int count = 0;
+        // The first chunk has no leading zeros, the others have all CHUNK_DIGITS digits
+        do {
+            digits[count++] = (char) ('0' + chunk % 10);
+            chunk /= 10;
+        } while (i == numChunks - 1 ? chunk != 0 : count < CHUNK_DIGITS);
+        while (count > 0) {
+            text[textLength++] = digits[--count];
+        }
+    }
+    return writeText(buffer, size, text, textLength);
+}
+
+/**
+ * @brief Adds two integers.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param sum Receives a + b, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+int addBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *sum) {
+    return addSigned(a, b, 0, sum);
+}
+
+/**
+ * @brief Subtracts two integers.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param difference Receives a - b, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+int subBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *difference) {
+    return addSigned(a, b, 1, difference);
+}
+
+/**
+ * @brief Multiplies two integers.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param product Receives a * b, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+int multBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *product) {
+    uint32_t limbs[2 * BIGINT_LIMBS];
+
+    if (a->length == 0 || b->length == 0) {
+        product->negative = 0;
+        product->length = 0;
+        return 0;
+    }
+    multiplyMagnitudes(a->limbs, a->length, b->limbs, b->length, limbs);
+    return setBigInt(product, limbs, a->length + b->length, a->negative != b->negative);
+}
+
+/**
+ * @brief Divides two integers, truncating toward zero like the C operators.
+ *
+ * @param a The dividend.
+ * @param b The divisor.
+ * @param quotient Receives a / b, may be NULL.
+ * @param remainder Receives a % b, with the sign of a, may be NULL.
+ * @return 0 on success, -1 if the divisor is zero.
+ */
+int divideBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *quotient, struct BigInt *remainder) {
+    uint32_t quotientLimbs[BIGINT_LIMBS];
+    uint32_t remainderLimbs[BIGINT_LIMBS];
+    int negativeQuotient = a->negative != b->negative;
+    int negativeRemainder = a->negative;
+
+    if (b->length == 0) {
+        return -1;
+    }
+    if (compareMagnitudes(a->limbs, a->length, b->limbs, b->length) < 0) {
+        if (remainder != NULL) {
+            setBigInt(remainder, a->limbs, a->length, negativeRemainder);
+        }
+        if (quotient != NULL) {
+            setBigInt(quotient, quotientLimbs, 0, 0);
+        }
+        return 0;
+    }
+
+    divideMagnitudes(a->limbs, a->length, b->limbs, b->length, quotientLimbs, remainderLimbs);
+    if (remainder != NULL) {
+        setBigInt(remainder, remainderLimbs, b->length, negativeRemainder);
+    }
+    if (quotient != NULL) {
+        setBigInt(quotient, quotientLimbs, a->length - b->length + 1, negativeQuotient);
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the fraction numerator / denominator with a fixed number of decimals.
+ *
+ * The fraction is scaled by 10^decimals and divided, then the quotient is rounded
+ * by comparing twice the remainder with the denominator.
+ *
+ * @param numerator The numerator.
+ * @param denominator The denominator, not zero, NULL for 1.
+ * @param precision The decimals, NUMBER_SHORTEST for the fewest exact ones.
+ * @param buffer Buffer receiving the terminated text, truncated if it is too small.
+ * @param size The size of the buffer.
+ * @return The length of the whole text, as snprintf().
+ */
+int formatBigFraction(const struct BigInt *numerator, const struct BigInt *denominator, int precision,
+                      char *buffer, int size) {
+    static const struct BigInt one = { 0, 1, { 1 } };
+    struct BigInt scaled, quotient, remainder;
+    char text[BIGINT_DIGITS + NUMBER_MAXPRECISION + 2];
+    char digits[BIGINT_DIGITS];
+
+    if (denominator == NULL) {
+        denominator = &one;
+    }
+    int decimals = precision;
+    if (precision == NUMBER_SHORTEST) {
+        divideBigInt(numerator, denominator, NULL, &remainder);
+        decimals = remainder.length == 0 ? 0 : NUMBER_MAXPRECISION;
+    } else if (decimals > NUMBER_MAXPRECISION) {
+        decimals = NUMBER_MAXPRECISION;
+    }
+
+    uint32_t power = 1;
+    for (int i = 0; i < decimals; i++) {
+        power *= 10;
+    }
+    scaled = *numerator;
+    scaled.negative = 0;
+    if (multiplyAdd(&scaled, power, 0) < 0) {
+        return writeText(buffer, size, "", 0);
+    }
+    divideBigInt(&scaled, denominator, &quotient, &remainder);
+    quotient.negative = 0;
+
+    // Round half to even: compare 2 * remainder with the denominator
+    if (remainder.length > 0) {
+        remainder.negative = 0;
+        addBigInt(&remainder, &remainder, &remainder);
+        int comparison = compareMagnitudes(remainder.limbs, remainder.length, denominator->limbs, denominator->length);
+        if (comparison > 0 || (comparison == 0 && quotient.length > 0 && (quotient.limbs[0] & 1))) {
+            addBigInt(&quotient, &one, &quotient);
+        }
+    }
+
+    int numDigits = formatBigInt(&quotient, digits, sizeof(digits));
+    if (precision == NUMBER_SHORTEST) {
+        if (quotient.length == 0) {
+            decimals = 0;
+        }
+        while (decimals > 0 && digits[numDigits - 1] == '0') {
+            numDigits--;
+            decimals--;
+        }
+    }
+
+    int textLength = 0;
+    int negative = numerator->negative != denominator->negative && numerator->length > 0;
+    if (negative && (precision != NUMBER_SHORTEST || quotient.length > 0)) {
+        text[textLength++] = '-'; // As printf(), a negative value rounded to zero keeps its sign
+    }
+    int integerDigits = numDigits - decimals;
+    if (integerDigits <= 0) {
+        text[textLength++] = '0';
+    } else {
+        memcpy(text + textLength, digits, integerDigits);
+        textLength += integerDigits;
+    }
+    if (decimals > 0) {
+        text[textLength++] = '.';
+        for (int i = integerDigits; i < 0; i++) {
+            text[textLength++] = '0';
+        }
+        int first = integerDigits > 0 ? integerDigits : 0;
+        memcpy(text + textLength, digits + first, numDigits - first);
+        textLength += numDigits - first;
+    }
+    return writeText(buffer, size, text, textLength);
+}
+
+/**
+ * @brief Calculates exactly an operation read by parseOperation() with wide set.
+ *
+ * A division is folded into a single fraction, the first operand over the product
+ * of the others, so it is rounded once.
+ *
+ * @param scanner The scanner the operation was read with.
+ * @param operation The operation.
+ * @param precision The decimals of the result, as formatBigFraction().
+ * @param buffer Buffer receiving the terminated result.
+ * @param size The size of the buffer.
+ * @return CALC_OK or the CALC_ error code.
+ */
+int calculateBig(const struct Scanner *scanner, const struct Operation *operation, int precision,
+                 char *buffer, int size) {
+    struct Scanner operands = *scanner;
+    struct BigInt result, operand;
+    struct BigInt denominator = { 0, 1, { 1 } };
+
+    if (operation->numOperands < 2) {
+        return CALC_MISSING_OPERANDS;
+    }
+
+    operands.position = operation->operandsPosition;
+    for (int i = 0; i < operation->numOperands; i++) {
+        skipSpaces(&operands);
+        int used = parseBigInt(operands.text + operands.position, operands.length - operands.position,
+                               i == 0 ? &result : &operand);
+        if (used == 0) {
+            return CALC_TOO_MANY_OPERANDS;
+        }
+        operands.position += used;
+        if (i == 0) {
+            continue;
+        }
+
+        int fits;
+        switch (operation->operator) {
+            case '+':
+                fits = addBigInt(&result, &operand, &result);
+                break;
+            case '-':
+                fits = subBigInt(&result, &operand, &result);
+                break;
+            case '*':
+                fits = multBigInt(&result, &operand, &result);
+                break;
+            case '/':
+                if (operand.length == 0) {
+                    return CALC_DIVISION_BY_ZERO;
+                }
+                fits = multBigInt(&denominator, &operand, &denominator);
+                break;
+            default:
+                return CALC_UNKNOWN_OPERATOR;
+        }
+        if (fits < 0) {
+            return CALC_TOO_MANY_OPERANDS;
+        }
+    }
+
+    formatBigFraction(&result, &denominator, precision, buffer, size);
+    return CALC_OK;
+}
+
+/**
+ * @brief Changes the number of limbs from which the products use Karatsuba, to compare them.
+ *
+ * @param limbs The limbs of the smaller factor, at least 2.
+ * @return The previous threshold.
+ */
+int setKaratsubaThreshold(int limbs) {
+    int previous = karatsubaThreshold;
+    karatsubaThreshold = limbs < 2 ? 2 : limbs;
+    return previous;
+}
+
+/**
+ * @brief Adds or subtracts two integers from the signs and the order of their magnitudes.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param negateB 1 to subtract b, 0 to add it.
+ * @param result Receives the result, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+static int addSigned(const struct BigInt *a, const struct BigInt *b, int negateB, struct BigInt *result) {
+    uint32_t limbs[BIGINT_LIMBS + 1];
+    int negativeB = b->negative != negateB && b->length > 0;
+    int length;
+    int negative;
+
+    if (a->negative == negativeB) {
+        length = addMagnitudes(a->limbs, a->length, b->limbs, b->length, limbs);
+        negative = a->negative;
+    } else if (compareMagnitudes(a->limbs, a->length, b->limbs, b->length) >= 0) {
+        length = subMagnitudes(a->limbs, a->length, b->limbs, b->length, limbs);
+        negative = a->negative;
+    } else {
+        length = subMagnitudes(b->limbs, b->length, a->limbs, a->length, limbs);
+        negative = negativeB;
+    }
+    return setBigInt(result, limbs, length, negative);
+}
+
+/**
+ * @brief Stores a magnitude and a sign into an integer.
+ *
+ * @param number The integer.
+ * @param limbs The magnitude, possibly with leading zero limbs.
+ * @param length The limbs of the magnitude.
+ * @param negative 1 for a negative integer.
+ * @return 0 on success, -1 if the magnitude has more than BIGINT_LIMBS limbs.
+ */
+static int setBigInt(struct BigInt *number, const uint32_t *limbs, int length, int negative) {
+    length = normalizeLimbs(limbs, length);
+    if (length > BIGINT_LIMBS) {
+        return -1;
+    }
+    memmove(number->limbs, limbs, length * sizeof(uint32_t));
+    number->length = length;
+    number->negative = negative && length > 0;
+    return 0;
+}
+
+/**
+ * @brief Drops the leading zero limbs of a magnitude.
+ *
+ * @param limbs The magnitude.
+ * @param length The limbs of the magnitude.
+ * @return The limbs without the leading zeros.
+ */
+static int normalizeLimbs(const uint32_t *limbs, int length) {
+    while (length > 0 && limbs[length - 1] == 0) {
+        length--;
+    }
+    return length;
+}
+
+/**
+ * @brief Compares two normalized magnitudes.
+ *
+ * @return -1, 0 or 1 as a is below, equal to or above b.
+ */
+static int compareMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB) {
+    if (lengthA != lengthB) {
+        return lengthA < lengthB ? -1 : 1;
+    }
+    for (int i = lengthA - 1; i >= 0; i--) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Adds two magnitudes.
+ *
+ * @param sum Receives max(lengthA, lengthB) + 1 limbs, may be one of the operands.
+ * @return The limbs of the sum.
+ */
+static int addMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *sum) {
+    if (lengthA < lengthB) {
+        const uint32_t *swap = a;
+        a = b;
+        b = swap;
+        int swapLength = lengthA;
+        lengthA = lengthB;
+        lengthB = swapLength;
+    }
+
+    uint64_t carry = 0;
+    int i = 0;
+    for (; i < lengthB; i++) {
+        carry += (uint64_t) a[i] + b[i];
+        sum[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    for (; i < lengthA; i++) {
+        carry += a[i];
+        sum[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    sum[lengthA] = (uint32_t) carry;
+    return lengthA + (carry != 0);
+}
+
+/**
+ * @brief Subtracts two magnitudes, a not below b.
+ *
+ * @param difference Receives lengthA limbs, may be one of the operands.
+ * @return The limbs of the difference, normalized.
+ */
+static int subMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *difference) {
+    uint64_t borrow = 0;
+    int i = 0;
+
+    for (; i < lengthB; i++) {
+        uint64_t value = (uint64_t) a[i] - b[i] - borrow;
+        difference[i] = (uint32_t) value;
+        borrow = value >> 63;
+    }
+    for (; i < lengthA; i++) {
+        uint64_t value = (uint64_t) a[i] - borrow;
+        difference[i] = (uint32_t) value;
+        borrow = value >> 63;
+    }
+    return normalizeLimbs(difference, lengthA);
+}
+
+/**
+ * @brief Adds a magnitude into a longer one, which has room for the carry.
+ */
+static void addInto(uint32_t *target, int lengthTarget, const uint32_t *addend, int lengthAddend) {
+    uint64_t carry = 0;
+    int i = 0;
+
+    for (; i < lengthAddend; i++) {
+        carry += (uint64_t) target[i] + addend[i];
+        target[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    for (; carry != 0 && i < lengthTarget; i++) {
+        carry += target[i];
+        target[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+}
+
+/**
+ * @brief Multiplies two magnitudes with the method suited to their sizes.
+ *
+ * Below the threshold the schoolbook method is faster. A factor at least twice
+ * as long as the other is cut in slices as long as the other, so Karatsuba always
+ * splits factors of comparable size.
+ *
+ * @param product Receives lengthA + lengthB limbs, distinct from the factors.
+ */
+static void multiplyMagnitudes(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *product) {
+    if (lengthA < lengthB) {
+        const uint32_t *swap = a;
+        a = b;
+        b = swap;
+        int swapLength = lengthA;
+        lengthA = lengthB;
+        lengthB = swapLength;
+    }
+
+    if (lengthB < karatsubaThreshold) {
+        multiplySchoolbook(a, lengthA, b, lengthB, product);
+    } else if (lengthA >= 2 * lengthB) {
+        uint32_t slice[2 * BIGINT_LIMBS];
+        memset(product, 0, (lengthA + lengthB) * sizeof(uint32_t));
+        for (int i = 0; i < lengthA; i += lengthB) {
+            int length = lengthA - i < lengthB ? lengthA - i : lengthB;
+            multiplyMagnitudes(a + i, length, b, lengthB, slice);
+            addInto(product + i, lengthA + lengthB - i, slice, length + lengthB);
+        }
+    } else {
+        multiplyKaratsuba(a, lengthA, b, lengthB, product);
+    }
+}
+
+/**
+ * @brief Multiplies two magnitudes one limb by one limb.
+ *
+ * @param product Receives lengthA + lengthB limbs, distinct from the factors.
+ */
+static void multiplySchoolbook(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *product) {
+    memset(product, 0, (lengthA + lengthB) * sizeof(uint32_t));
+    for (int i = 0; i < lengthA; i++) {
+        uint64_t carry = 0;
+        uint64_t limb = a[i];
+        // limb * b[j] + product[i + j] + carry never exceeds 2^64 - 1
+        for (int j = 0; j < lengthB; j++) {
+            carry += limb * b[j] + product[i + j];
+            product[i + j] = (uint32_t) carry;
+            carry >>= 32;
+        }
+        product[i + lengthB] = (uint32_t) carry;
+    }
+}
+
+/**
+ * @brief Multiplies two magnitudes of comparable size with Karatsuba's method.
+ *
+ * With a = a1 * B^h + a0 and b = b1 * B^h + b0, the product takes three half-size
+ * products instead of four: a0 * b0, a1 * b1 and (a0 + a1) * (b0 + b1), from which
+ * the middle term a0 * b1 + a1 * b0 is found by subtraction.
+ *
+ * @param product Receives lengthA + lengthB limbs, distinct from the factors.
+ */
+static void multiplyKaratsuba(const uint32_t *a, int lengthA, const uint32_t *b, int lengthB, uint32_t *product) {
+    uint32_t sumA[BIGINT_LIMBS + 1];
+    uint32_t sumB[BIGINT_LIMBS + 1];
+    uint32_t middle[2 * BIGINT_LIMBS + 2];
+    int half = lengthA / 2; // lengthB is above half, so both factors have a high part
+
+    // The low and the high products go straight to their place in the result
+    multiplyMagnitudes(a, half, b, half, product);
+    multiplyMagnitudes(a + half, lengthA - half, b + half, lengthB - half, product + 2 * half);
+
+    int lengthSumA = addMagnitudes(a, normalizeLimbs(a, half), a + half, lengthA - half, sumA);
+    int lengthSumB = addMagnitudes(b, normalizeLimbs(b, half), b + half, lengthB - half, sumB);
+    multiplyMagnitudes(sumA, lengthSumA, sumB, lengthSumB, middle);
+    int lengthMiddle = normalizeLimbs(middle, lengthSumA + lengthSumB);
+    lengthMiddle = subMagnitudes(middle, lengthMiddle, product, normalizeLimbs(product, 2 * half), middle);
+    lengthMiddle = subMagnitudes(middle, lengthMiddle, product + 2 * half,
+                                 normalizeLimbs(product + 2 * half, lengthA + lengthB - 2 * half), middle);
+    addInto(product + half, lengthA + lengthB - half, middle, lengthMiddle);
+}
+
+/**
+ * @brief Divides two magnitudes with Knuth's algorithm D, u not below v.
+ *
+ * Both are shifted so the top limb of v has its high bit set; then every limb of
+ * the quotient is estimated from the top two limbs of the remainder, corrected at
+ * most twice, and rarely once more after the multiply and subtract.
+ *
+ * @param quotient Receives lengthU - lengthV + 1 limbs.
+ * @param remainder Receives lengthV limbs.
+ */
+static void divideMagnitudes(const uint32_t *u, int lengthU, const uint32_t *v, int lengthV,
+                             uint32_t *quotient, uint32_t *remainder) {
+    if (lengthV == 1) {
+        for (int i = 0; i < lengthU; i++) {
+            quotient[i] = u[i];
+        }
+        remainder[0] = divideSmall(quotient, lengthU, v[0]);
+        return;
+    }
+
+    uint32_t shiftedU[BIGINT_LIMBS + 1];
+    uint32_t shiftedV[BIGINT_LIMBS];
+    int shift = 0;
+    while (!((v[lengthV - 1] << shift) & 0x80000000u)) {
+        shift++;
+    }
+    for (int i = lengthV - 1; i > 0; i--) {
+        shiftedV[i] = shift ? (v[i] << shift) | (v[i - 1] >> (32 - shift)) : v[i];
+    }
+    shiftedV[0] = v[0] << shift;
+    shiftedU[lengthU] = shift ? u[lengthU - 1] >> (32 - shift) : 0;
+    for (int i = lengthU - 1; i > 0; i--) {
+        shiftedU[i] = shift ? (u[i] << shift) | (u[i - 1] >> (32 - shift)) : u[i];
+    }
+    shiftedU[0] = u[0] << shift;
+
+    for (int j = lengthU - lengthV; j >= 0; j--) {
+        uint64_t top = ((uint64_t) shiftedU[j + lengthV] << 32) | shiftedU[j + lengthV - 1];
+        uint64_t estimate = top / shiftedV[lengthV - 1];
+        uint64_t rest = top % shiftedV[lengthV - 1];
+        while (estimate >> 32 || estimate * shiftedV[lengthV - 2] > ((rest << 32) | shiftedU[j + lengthV - 2])) {
+            estimate--;
+            rest += shiftedV[lengthV - 1];
+            if (rest >> 32) {
+                break;
+            }
+        }
+
+        // Multiply and subtract; k carries the high half of the product and the borrow
+        int64_t k = 0;
+        int64_t t;
+        for (int i = 0; i < lengthV; i++) {
+            uint64_t p = estimate * shiftedV[i];
+            t = (int64_t) shiftedU[i + j] - k - (int64_t) (p & 0xFFFFFFFFu);
+            shiftedU[i + j] = (uint32_t) t;
+            k = (int64_t) (p >> 32) - (t >> 32);
+        }
+        t = (int64_t) shiftedU[j + lengthV] - k;
+        shiftedU[j + lengthV] = (uint32_t) t;
+
+        quotient[j] = (uint32_t) estimate;
+        if (t < 0) {
+            // The estimate was one too large: add the divisor back
+            uint64_t carry = 0;
+            quotient[j]--;
+            for (int i = 0; i < lengthV; i++) {
+                carry += (uint64_t) shiftedU[i + j] + shiftedV[i];
+                shiftedU[i + j] = (uint32_t) carry;
+                carry >>= 32;
+            }
+            shiftedU[j + lengthV] += (uint32_t) carry;
+        }
+    }
+
+    for (int i = 0; i < lengthV; i++) {
+        remainder[i] = shift ? (shiftedU[i] >> shift) | (shiftedU[i + 1] << (32 - shift)) : shiftedU[i];
+    }
+}
+
+/**
+ * @brief Multiplies an integer by a limb and adds another: number = number * multiplier + addend.
+ *
+ * @return 0 on success, -1 if the result does not fit.
+ */
+static int multiplyAdd(struct BigInt *number, uint32_t multiplier, uint32_t addend) {
+    uint64_t carry = addend;
+
+    for (int i = 0; i < number->length; i++) {
+        carry += (uint64_t) number->limbs[i] * multiplier;
+        number->limbs[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    if (carry != 0) {
+        if (number->length == BIGINT_LIMBS) {
+            return -1;
+        }
+        number->limbs[number->length++] = (uint32_t) carry;
+    }
+    return 0;
+}
+
+/**
+ * @brief Divides a magnitude by a limb in place.
+ *
+ * @return The remainder.
+ */
+static uint32_t divideSmall(uint32_t *limbs, int length, uint32_t divisor) {
+    uint64_t rest = 0;
+
+    for (int i = length - 1; i >= 0; i--) {
+        rest = (rest << 32) | limbs[i];
+        limbs[i] = (uint32_t) (rest / divisor);
+        rest %= divisor;
+    }
+    return (uint32_t) rest;
+}
+
+/**
+ * @brief Copies a text into a buffer, truncating it like snprintf().
+ *
+ * @return The length of the whole text.
+ */
+static int writeText(char *buffer, int size, const char *text, int length) {
+    if (size > 0) {
+        int copied = length < size - 1 ? length : size - 1;
+        memcpy(buffer, text, copied);
+        buffer[copied] = '\0';
+    }
+    return length;
+}
@@ -0,0 +1,138 @@
+#ifndef SERVER_BIGINT_H_
+#define SERVER_BIGINT_H_
+
+/**
+ * @file BigInt.h
+ * @brief Header file for the arbitrary-precision integers.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * An operation whose operands are all integers, one of them outside the range of
+ * a 64 bit integer, is calculated exactly on integers made of 32 bit limbs instead
+ * of doubles. Sums, differences and products are integers; a division is kept as
+ * a fraction and rounded only when it is written, to the decimals of the replies.
+ * The products switch from the schoolbook method to Karatsuba's once both factors
+ * have BIGINT_KARATSUBA limbs, and the decimal text is converted nine digits at a
+ * time.
+ */
+
+#include <stdint.h>     // Fixed width integers
+
+#define BIGINT_LIMBS 256        // Limbs of a number: 8192 bits, 2466 digits, more than a request holds
+#define BIGINT_KARATSUBA 32     // Limbs of the smaller factor from which Karatsuba is faster
+
+/**
+ * @brief A signed integer of up to BIGINT_LIMBS limbs.
+ */
+struct BigInt {
+    int negative;                   // 1 if the number is below zero, never for zero
+    int length;                     // Limbs used, 0 for zero; the last one is never 0
+    uint32_t limbs[BIGINT_LIMBS];   // Magnitude, least significant limb first
+};
+
+/**
+ * @brief Reads an integer at the start of a view: [+|-] digits.
+ *
+ * @param text The first character of the view.
+ * @param length The number of characters of the view.
+ * @param number Receives the integer.
+ * @return The number of characters read, 0 if the view does not start with an
+ *         integer or it does not fit in BIGINT_LIMBS limbs.
+ */
+int parseBigInt(const char *text, int length, struct BigInt *number);
+
+/**
+ * @brief Writes an integer in decimal.
+ *
+ * @param number The integer.
+ * @param buffer Buffer receiving the terminated text, truncated if it is too small.
+ * @param size The size of the buffer.
+ * @return The length of the whole text, as snprintf().
+ */
+int formatBigInt(const struct BigInt *number, char *buffer, int size);
+
+/**
+ * @brief Adds two integers.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param sum Receives a + b, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+int addBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *sum);
+
+/**
+ * @brief Subtracts two integers.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param difference Receives a - b, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+int subBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *difference);
+
+/**
+ * @brief Multiplies two integers.
+ *
+ * @param a The first integer.
+ * @param b The second integer.
+ * @param product Receives a * b, may be one of the operands.
+ * @return 0 on success, -1 if the result does not fit.
+ */
+int multBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *product);
+
+/**
+ * @brief Divides two integers, truncating toward zero like the C operators.
+ *
+ * @param a The dividend.
+ * @param b The divisor.
+ * @param quotient Receives a / b, may be NULL.
+ * @param remainder Receives a % b, with the sign of a, may be NULL.
+ * @return 0 on success, -1 if the divisor is zero.
+ */
+int divideBigInt(const struct BigInt *a, const struct BigInt *b, struct BigInt *quotient, struct BigInt *remainder);
+
+/**
+ * @brief Writes the fraction numerator / denominator with a fixed number of decimals.
+ *
+ * The last decimal is rounded half to even, as printf("%.*f") rounds the exact
+ * value of a double.
+ *
+ * @param numerator The numerator.
+ * @param denominator The denominator, not zero, NULL for 1.
+ * @param precision The decimals; NUMBER_SHORTEST writes an integer without decimals
+ *                  and any other fraction with NUMBER_MAXPRECISION decimals, less
+ *                  the trailing zeros.
+ * @param buffer Buffer receiving the terminated text, truncated if it is too small.
+ * @param size The size of the buffer.
+ * @return The length of the whole text, as snprintf().
+ */
+int formatBigFraction(const struct BigInt *numerator, const struct BigInt *denominator, int precision,
+                      char *buffer, int size);
+
+/**
+ * @brief Calculates exactly an operation read by parseOperation() with wide set.
+ *
+ * The operands are read again from the text, so the doubles of the operation are
+ * not used.
+ *
+ * @param scanner The scanner the operation was read with.
+ * @param operation The operation.
+ * @param precision The decimals of the result, as formatBigFraction().
+ * @param buffer Buffer receiving the terminated result.
+ * @param size The size of the buffer.
+ * @return CALC_OK, CALC_DIVISION_BY_ZERO, CALC_UNKNOWN_OPERATOR or CALC_TOO_MANY_OPERANDS
+ *         if an intermediate result does not fit in BIGINT_LIMBS limbs.
+ */
+int calculateBig(const struct Scanner *scanner, const struct Operation *operation, int precision,
+                 char *buffer, int size);
+
+/**
+ * @brief Changes the number of limbs from which the products use Karatsuba, to compare them.
+ *
+ * @param limbs The limbs of the smaller factor, at least 2.
+ * @return The previous threshold.
+ */
+int setKaratsubaThreshold(int limbs);
+
+#endif /* SERVER_BIGINT_H_ */
@@ -0,0 +1,283 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Binary.h"
+#include "Vector.h"
+#include "Statistics.h"
+#include "Matrix.h"
+
+#include <stdint.h>     // Fixed width integers
+
+/**
+ * @file Binary.c
+ * @brief Implementation file for the binary encoding of the operations.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+static int readOperands(const unsigned char *in, int count, double *values);
+static uint64_t readUint64(const unsigned char *bytes);
+static void writeUint64(unsigned char *bytes, uint64_t value);
+
+/**
+ * @brief Evaluates every operation of a binary payload.
+ *
+ * @param request The binary payload.
+ * @param length The size of the payload.
+ * @param reply Buffer receiving BINARY_REPLYSIZE bytes per operation.
+ * @return The size of the reply, -1 if the payload is not a whole number of operations.
+ */
+int processBinary(const char *request, int length, char *reply) {
+    if (length <= 0 || length % BINARY_REQUESTSIZE != 0) {
+        return -1;
+    }
+
+    int count = length / BINARY_REQUESTSIZE;
+    for (int first = 0; first < count; first += BINARY_CHUNK) {
+        int chunk = count - first < BINARY_CHUNK ? count - first : BINARY_CHUNK;
+        double operands[BINARY_OPERANDS][BINARY_CHUNK];
+        double results[BINARY_CHUNK];
+        unsigned char errors[BINARY_CHUNK];
+        int statuses[BINARY_CHUNK];
+
+        // Decode the operands of the chunk into one array per position
+        for (int i = 0; i < chunk; i++) {
+            const unsigned char *in = (const unsigned char*) request + (first + i) * BINARY_REQUESTSIZE;
+            statuses[i] = CALC_OK;
+            for (int j = 0; j < BINARY_OPERANDS; j++) {
+                uint64_t bits = readUint64(in + 4 + 8 * j);
+                if (in[1] == BINARY_INT64) {
+                    operands[j][i] = (double) (int64_t) bits;
+                } else if (in[1] == BINARY_DOUBLE) {
+                    memcpy(&operands[j][i], &bits, sizeof(double));
+                } else {
+                    operands[j][i] = 0;
+                    statuses[i] = CALC_INVALID_OPERAND;
+                }
+            }
+        }
+
+        // Every run of operations with the same operator is one call to the vector kernels
+        for (int start = 0, end; start < chunk; start = end) {
+            char operator = request[(first + start) * BINARY_REQUESTSIZE];
+            for (end = start + 1; end < chunk && request[(first + end) * BINARY_REQUESTSIZE] == operator; end++) {
+            }
+            int status = calculateVectors(operator, operands[0] + start, operands[1] + start, results + start,
+                                          errors + start, end - start);
+            for (int i = start; i < end; i++) {
+                if (statuses[i] == CALC_OK && status != CALC_OK) {
+                    statuses[i] = status;
+                } else if (statuses[i] == CALC_OK && errors[i]) {
+                    statuses[i] = CALC_DIVISION_BY_ZERO;
+                }
+            }
+        }
+
+        for (int i = 0; i < chunk; i++) {
+            unsigned char *out = (unsigned char*) reply + (first + i) * BINARY_REPLYSIZE;
+            double result = statuses[i] == CALC_OK ? results[i] : 0;
+            uint64_t bits;
+            memcpy(&bits, &result, sizeof(double));
+            out[0] = (unsigned char) statuses[i];
+            out[1] = BINARY_DOUBLE;
+            out[2] = 0;
+            out[3] = 0;
+            writeUint64(out + 4, bits);
+        }
+    }
+    return count * BINARY_REPLYSIZE;
+}
+
+/**
+ * @brief Evaluates the command of a stream payload.
+ *
+ * @param stream The statistics of the stream.
+ * @param request The stream payload.
+ * @param length The size of the payload.
+ * @param reply Buffer receiving the reply.
+ * @return The size of the reply, -1 if the payload is not a whole number of operands.
+ */
+int processStream(struct Statistics *stream, const char *request, int length, char *reply) {
+    if (length < STREAM_HEADERSIZE || (length - STREAM_HEADERSIZE) % 8 != 0) {
+        return -1;
+    }
+
+    const unsigned char *in = (const unsigned char*) request;
+    int count = (length - STREAM_HEADERSIZE) / 8;
+    double values[BUFFERSIZE / 8];
+    double results[BUFFERSIZE / 8 + STREAM_SUMMARYSIZE];
+    int resultCount = 0;
+    int status = readOperands(in, count, values);
+
+    if (status == CALC_OK) {
+        switch (in[0]) {
+            case STREAM_FOLD:
+                foldStatistics(stream, values, count);
+                results[resultCount++] = (double) stream->count;
+                break;
+            case STREAM_SCAN:
+                scanStatistics(stream, values, results, count);
+                resultCount = count;
+                break;
+            case STREAM_SUMMARY:
+                foldStatistics(stream, values, count);
+                if (stream->count == 0) {
+                    status = CALC_MISSING_OPERANDS;
+                    break;
+                }
+                results[resultCount++] = (double) stream->count;
+                results[resultCount++] = getStatisticsSum(stream);
+                results[resultCount++] = getStatisticsMean(stream);
+                results[resultCount++] = getStatisticsVariance(stream);
+                results[resultCount++] = stream->min;
+                results[resultCount++] = stream->max;
+                initStatistics(stream);
+                break;
+            default:
+                status = CALC_UNKNOWN_OPERATOR;
+                break;
+        }
+    }
+
+    unsigned char *out = (unsigned char*) reply;
+    out[0] = (unsigned char) status;
+    out[1] = BINARY_DOUBLE;
+    out[2] = 0;
+    out[3] = 0;
+    for (int i = 0; i < resultCount; i++) {
+        uint64_t bits;
+        memcpy(&bits, &results[i], sizeof(double));
+        writeUint64(out + STREAM_HEADERSIZE + 8 * i, bits);
+    }
+    return STREAM_HEADERSIZE + 8 * resultCount;
+}
+
+/**
+ * @brief Evaluates the command of a linear payload.
+ *
+ * @param request The linear payload.
+ * @param length The size of the payload.
+ * @param reply Buffer receiving the reply, LINEAR_HEADERSIZE + 8 * LINEAR_MAXRESULTS bytes.
+ * @return The size of the reply, -1 if the payload is not a whole number of operands.
+ */
+int processLinear(const char *request, int length, char *reply) {
+    if (length < LINEAR_HEADERSIZE || (length - LINEAR_HEADERSIZE) % 8 != 0) {
+        return -1;
+    }
+
+    const unsigned char *in = (const unsigned char*) request;
+    int count = (length - LINEAR_HEADERSIZE) / 8;
+    double values[BUFFERSIZE / 8];
+    double results[LINEAR_MAXRESULTS];
+    int resultCount = 0;
+    int rows = 0, columns = 0;
+    int status = readOperands(in, count, values);
+
+    if (status == CALC_OK) {
+        switch (in[0]) {
+            case LINEAR_DOT:
+                if (count == 0 || count % 2 != 0) {
+                    status = CALC_MISSING_OPERANDS;
+                    break;
+                }
+                results[resultCount++] = dotVectors(values, values + count / 2, count / 2);
+                break;
+            case LINEAR_AXPY:
+                if (count < 3 || count % 2 == 0) {
+                    status = CALC_MISSING_OPERANDS;
+                    break;
+                }
+                resultCount = (count - 1) / 2;
+                memcpy(results, values + 1 + resultCount, sizeof(double) * resultCount);
+                axpyVectors(values[0], values + 1, results, resultCount);
+                break;
+            case LINEAR_NORM:
+                if (count == 0) {
+                    status = CALC_MISSING_OPERANDS;
+                    break;
+                }
+                results[resultCount++] = normVector(values, count);
+                break;
+            case LINEAR_MULT:
+                rows = in[2];
+                columns = in[3];
+                if (rows == 0 || columns == 0 || count == 0 || count % (rows + columns) != 0) {
+                    status = CALC_MISSING_OPERANDS;
+                } else if (rows * columns > LINEAR_MAXRESULTS) {
+                    status = CALC_TOO_MANY_OPERANDS;
+                } else {
+                    int depth = count / (rows + columns);
+                    multMatrices(values, values + rows * depth, results, rows, depth, columns);
+                    resultCount = rows * columns;
+                }
+                break;
+            default:
+                status = CALC_UNKNOWN_OPERATOR;
+                break;
+        }
+    }
+    if (status != CALC_OK) {
+        rows = columns = 0;
+    }
+
+    unsigned char *out = (unsigned char*) reply;
+    out[0] = (unsigned char) status;
+    out[1] = BINARY_DOUBLE;
+    out[2] = (unsigned char) rows;
+    out[3] = (unsigned char) columns;
+    for (int i = 0; i < resultCount; i++) {
+        uint64_t bits;
+        memcpy(&bits, &results[i], sizeof(double));
+        writeUint64(out + LINEAR_HEADERSIZE + 8 * i, bits);
+    }
+    return LINEAR_HEADERSIZE + 8 * resultCount;
+}
+
+/**
+ * @brief Decodes the operands of a stream or linear payload.
+ *
+ * @param in The payload, whose second byte is the operand type.
+ * @param count The number of operands after the 4 byte header.
+ * @param values Receives the operands as doubles.
+ * @return CALC_OK, CALC_INVALID_OPERAND if the operand type is unknown.
+ */
+static int readOperands(const unsigned char *in, int count, double *values) {
+    if (in[1] != BINARY_INT64 && in[1] != BINARY_DOUBLE) {
+        return CALC_INVALID_OPERAND;
+    }
+    for (int i = 0; i < count; i++) {
+        uint64_t bits = readUint64(in + 4 + 8 * i);
+        if (in[1] == BINARY_INT64) {
+            values[i] = (double) (int64_t) bits;
+        } else {
+            memcpy(&values[i], &bits, sizeof(double));
+        }
+    }
+    return CALC_OK;
+}
+
+/**
+ * @brief Reads a big-endian 64 bit field.
+ *
+ * @param bytes The first byte of the field.
+ * @return The value of the field.
+ */
+static uint64_t readUint64(const unsigned char *bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Writes a big-endian 64 bit field.
+ *
+ * @param bytes The first byte of the field.
+ * @param value The value to write.
+ */
+static void writeUint64(unsigned char *bytes, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        bytes[i] = (unsigned char) (value & 0xFF);
+        value >>= 8;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef SERVER_BINARY_H_
+#define SERVER_BINARY_H_
+
+/**
+ * @file Binary.h
+ * @brief Header file for the binary encoding of the operations.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * A binary payload is a sequence of fixed-size operations, all multi-byte fields
+ * big-endian:
+ *
+ *     request: opcode (+ - * /), operand type, 2 reserved bytes, two 8 byte operands
+ *     reply:   CALC_ status, result type, 2 reserved bytes, 8 byte result
+ *
+ * Nothing is tokenized or printed, so a binary operation costs a few loads and stores.
+ *
+ * A stream payload folds an array of operands into the statistics of a stream
+ * (see Statistics.h), so arrays longer than a payload are sent a chunk at a time:
+ *
+ *     request: command, operand type, 2 reserved bytes, any number of 8 byte operands
+ *     reply:   CALC_ status, result type, 2 reserved bytes, 8 byte results
+ *
+ * STREAM_FOLD answers with the number of values folded so far, STREAM_SCAN with
+ * the sum of the stream after every operand, STREAM_SUMMARY with the count, sum,
+ * mean, variance, minimum and maximum of the stream and then empties it. A failed
+ * command folds nothing and is answered without results.
+ *
+ * A linear payload has the same layout; its operands are split into the arrays of
+ * an operation of Matrix.h, all of the same length:
+ *
+ *     LINEAR_DOT:  x, y          -> x . y
+ *     LINEAR_AXPY: a, x, y       -> a * x + y
+ *     LINEAR_NORM: x             -> the Euclidean norm of x
+ *     LINEAR_MULT: a, b          -> a * b, the rows of a and the columns of b in the
+ *                                   reserved bytes of the request and of the reply
+ *
+ * The matrices are stored by rows; the depth of a product is the number of operands
+ * divided by the rows of a plus the columns of b. A reply holds at most
+ * LINEAR_MAXRESULTS results.
+ */
+
+#define BINARY_INT64 1          // Operands or result are two's complement 64 bit integers
+#define BINARY_DOUBLE 2         // Operands or result are IEEE-754 doubles
+#define BINARY_OPERANDS 2       // Operands of an encoded operation
+#define BINARY_REQUESTSIZE 20   // Size of an encoded operation
+#define BINARY_REPLYSIZE 12     // Size of an encoded result
+#define BINARY_CHUNK 32         // Operations decoded and evaluated together, more than a frame holds
+
+#define STREAM_FOLD 'F'         // Command: fold the operands
+#define STREAM_SCAN 'C'         // Command: fold the operands and answer with the running sums
+#define STREAM_SUMMARY 'S'      // Command: fold the operands, answer with the summary and empty the stream
+#define STREAM_HEADERSIZE 4     // Size of the command and status fields of a stream payload
+#define STREAM_SUMMARYSIZE 6    // Results of STREAM_SUMMARY
+
+#define LINEAR_DOT 'D'          // Command: dot product of two arrays
+#define LINEAR_AXPY 'A'         // Command: a multiple of an array added to another
+#define LINEAR_NORM 'N'         // Command: Euclidean norm of an array
+#define LINEAR_MULT 'M'         // Command: product of two matrices
+#define LINEAR_HEADERSIZE 4     // Size of the command and status fields of a linear payload
+#define LINEAR_MAXRESULTS ((BUFFERSIZE - FRAME_HEADERSIZE - LINEAR_HEADERSIZE) / 8) // Results a reply holds
+
+/**
+ * @brief Evaluates every operation of a binary payload.
+ *
+ * Integer operands are converted to doubles, the result is always a double; a
+ * failed operation is answered with its CALC_ status and a zero result. The
+ * operations are decoded BINARY_CHUNK at a time and every run with the same
+ * operator is evaluated by the vector kernels of Vector.h.
+ *
+ * @param request The binary payload.
+ * @param length The size of the payload.
+ * @param reply Buffer receiving BINARY_REPLYSIZE bytes per operation.
+ * @return The size of the reply, -1 if the payload is not a whole number of operations.
+ */
+int processBinary(const char *request, int length, char *reply);
+
+struct Statistics;
+
+/**
+ * @brief Evaluates the command of a stream payload.
+ *
+ * Integer operands are converted to doubles, the results are always doubles. The
+ * reply is no larger than the request, or than STREAM_SUMMARYSIZE results.
+ *
+ * @param stream The statistics of the stream.
+ * @param request The stream payload.
+ * @param length The size of the payload.
+ * @param reply Buffer receiving the reply.
+ * @return The size of the reply, -1 if the payload is not a whole number of operands.
+ */
+int processStream(struct Statistics *stream, const char *request, int length, char *reply);
+
+/**
+ * @brief Evaluates the command of a linear payload.
+ *
+ * Integer operands are converted to doubles, the results are always doubles.
+ * Operands that do not split into the arrays of the command are answered with
+ * CALC_MISSING_OPERANDS, a product of more than LINEAR_MAXRESULTS elements with
+ * CALC_TOO_MANY_OPERANDS.
+ *
+ * @param request The linear payload.
+ * @param length The size of the payload.
+ * @param reply Buffer receiving the reply, LINEAR_HEADERSIZE + 8 * LINEAR_MAXRESULTS bytes.
+ * @return The size of the reply, -1 if the payload is not a whole number of operands.
+ */
+int processLinear(const char *request, int length, char *reply);
+
+#endif /* SERVER_BINARY_H_ */
@@ -0,0 +1,356 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Calculator.h"
+#include "Scanner.h"
+#include "Expression.h"
+
+/**
+ * @file Expression.c
+ * @brief Implementation file for the infix expressions compiled to bytecode.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+// Instructions of the stack machine
+#define OP_RETURN 0             // Ends the program with the value on top
+#define OP_PUSH 1               // Pushes the constant whose index follows
+#define OP_ADD 2                // Replaces the two values on top with their sum
+#define OP_SUB 3                // Replaces the two values on top with their difference
+#define OP_MULT 4               // Replaces the two values on top with their product
+#define OP_DIV 5                // Replaces the two values on top with their quotient
+#define OP_NEGATE 6             // Changes the sign of the value on top
+
+#define INTEGER_INEXACT (-1)    // An integer operation whose result is not an int64_t
+
+/**
+ * @brief State of the compilation of an expression.
+ */
+struct Compiler {
+    struct Scanner *scanner;    // Text being compiled
+    struct Program *program;    // Program being written
+    int depth;                  // Values the program has pending at this point
+    int nesting;                // Parentheses open at this point
+};
+
+static int compileSum(struct Compiler *compiler);
+static int compileProduct(struct Compiler *compiler);
+static int compileUnary(struct Compiler *compiler);
+static int compilePrimary(struct Compiler *compiler);
+static int emit(struct Compiler *compiler, unsigned char instruction);
+static int emitConstant(struct Compiler *compiler, double value);
+static int calculateInteger(char operator, const int64_t *operands, int numOperands, int64_t *result);
+
+/**
+ * @brief Compiles an expression up to the end of the view or the next BATCH_SEPARATOR.
+ *
+ * @param scanner The scanner, positioned after EXPRESSION_OPERATOR.
+ * @param program Receives the compiled expression.
+ * @return CALC_OK, CALC_SYNTAX_ERROR or CALC_TOO_MANY_OPERANDS when a limit of the program is exceeded.
+ */
+int compileExpression(struct Scanner *scanner, struct Program *program) {
+    struct Compiler compiler = { scanner, program, 0, 0 };
+
+    program->length = 0;
+    program->numConstants = 0;
+
+    int status = compileSum(&compiler);
+    if (status != CALC_OK) {
+        return status;
+    }
+    char c = skipSpaces(scanner);
+    if (c != '\0' && c != BATCH_SEPARATOR) {
+        return CALC_SYNTAX_ERROR; // Something left after a complete expression
+    }
+    return emit(&compiler, OP_RETURN);
+}
+
+/**
+ * @brief Evaluates the prefix operation or the expression at the position of the scanner.
+ *
+ * @param scanner The scanner, positioned before the operator.
+ * @param operation Receives the operator, the operands and the position of an error.
+ * @param result Receives the result when the evaluation succeeds.
+ * @return CALC_OK on success, otherwise the CALC_ error code.
+ */
+int evaluateOperation(struct Scanner *scanner, struct Operation *operation, double *result) {
+    if (skipSpaces(scanner) != EXPRESSION_OPERATOR) {
+        int status = parseOperation(scanner, operation);
+        if (status == CALC_OK && operation->integer) {
+            // Integers stay exact in 64 bits while every partial result fits
+            status = calculateInteger(operation->operator, operation->integers, operation->numOperands,
+                                      &operation->integerResult);
+            if (status != INTEGER_INEXACT) {
+                *result = (double) operation->integerResult;
+                return status;
+            }
+            // An overflow is calculated again by BigInt.c, a division with a remainder on doubles
+            operation->integer = 0;
+            operation->wide = operation->operator != '/';
+            status = CALC_OK;
+        }
+        if (status == CALC_OK) {
+            status = calculate(operation->operator, operation->operands, operation->numOperands, result);
+        }
+        return status;
+    }
+
+    struct Program program;
+    operation->operator = EXPRESSION_OPERATOR;
+    operation->numOperands = 0;
+    operation->integer = 0;
+    operation->wide = 0;
+    scanner->position++;
+    int status = compileExpression(scanner, &program);
+    if (status != CALC_OK) {
+        operation->errorPosition = scanner->position;
+        operation->errorLength = 0;
+        return status;
+    }
+    return runProgram(&program, result);
+}
+
+/**
+ * @brief Applies an operator to integer operands from left to right, with checked arithmetic.
+ *
+ * A division stays exact only when it has no remainder.
+ *
+ * @param operator The operator, one of + - * /.
+ * @param operands The operands.
+ * @param numOperands The number of operands.
+ * @param result Receives the result when the calculation succeeds.
+ * @return CALC_OK on success, INTEGER_INEXACT if a partial result overflows or has
+ *         a remainder, otherwise the CALC_ error code of calculate().
+ */
+static int calculateInteger(char operator, const int64_t *operands, int numOperands, int64_t *result) {
+    if (numOperands < 2) {
+        return CALC_MISSING_OPERANDS;
+    }
+
+    int64_t value = operands[0];
+    for (int i = 1; i < numOperands; i++) {
+        int overflow;
+        switch (operator) {
+            case '+':
+                overflow = __builtin_add_overflow(value, operands[i], &value);
+                break;
+            case '-':
+                overflow = __builtin_sub_overflow(value, operands[i], &value);
+                break;
+            case '*':
+                overflow = __builtin_mul_overflow(value, operands[i], &value);
+                break;
+            case '/':
+                if (operands[i] == 0) {
+                    return CALC_DIVISION_BY_ZERO;
+                }
+                // INT64_MIN / -1 is the one quotient that overflows
+                overflow = (operands[i] == -1 && value == INT64_MIN) || value % operands[i] != 0;
+                if (!overflow) {
+                    value /= operands[i];
+                }
+                break;
+            default:
+                return CALC_UNKNOWN_OPERATOR;
+        }
+        if (overflow) {
+            return INTEGER_INEXACT;
+        }
+    }
+
+    *result = value;
+    return CALC_OK;
+}
+
+/**
+ * @brief Runs a compiled expression.
+ *
+ * The compiler guarantees that the stack never holds more than EXPRESSION_STACK
+ * values and never underflows, so the loop does not check it.
+ *
+ * @param program The program.
+ * @param result Receives the value of the expression.
+ * @return CALC_OK or CALC_DIVISION_BY_ZERO.
+ */
+int runProgram(const struct Program *program, double *result) {
+    double stack[EXPRESSION_STACK];
+    double *top = stack - 1;
+    const unsigned char *pc = program->code;
+
+    while (1) {
+        switch (*pc++) {
+            case OP_PUSH:
+                *++top = program->constants[*pc++];
+                break;
+            case OP_ADD:
+                top--;
+                *top = add(top[0], top[1]);
+                break;
+            case OP_SUB:
+                top--;
+                *top = sub(top[0], top[1]);
+                break;
+            case OP_MULT:
+                top--;
+                *top = mult(top[0], top[1]);
+                break;
+            case OP_DIV:
+                if (top[0] == 0) {
+                    return CALC_DIVISION_BY_ZERO;
+                }
+                top--;
+                *top = division(top[0], top[1]);
+                break;
+            case OP_NEGATE:
+                *top = -*top;
+                break;
+            default: // OP_RETURN
+                *result = *top;
+                return CALC_OK;
+        }
+    }
+}
+
+/**
+ * @brief Compiles a sum: products separated by + and -.
+ *
+ * @param compiler The compiler.
+ * @return CALC_OK or the error of the compilation.
+ */
+static int compileSum(struct Compiler *compiler) {
+    int status = compileProduct(compiler);
+    char c;
+
+    while (status == CALC_OK && ((c = skipSpaces(compiler->scanner)) == '+' || c == '-')) {
+        compiler->scanner->position++;
+        status = compileProduct(compiler);
+        if (status == CALC_OK) {
+            status = emit(compiler, c == '+' ? OP_ADD : OP_SUB);
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Compiles a product: unary terms separated by * and /.
+ *
+ * @param compiler The compiler.
+ * @return CALC_OK or the error of the compilation.
+ */
+static int compileProduct(struct Compiler *compiler) {
+    int status = compileUnary(compiler);
+    char c;
+
+    while (status == CALC_OK && ((c = skipSpaces(compiler->scanner)) == '*' || c == '/')) {
+        compiler->scanner->position++;
+        status = compileUnary(compiler);
+        if (status == CALC_OK) {
+            status = emit(compiler, c == '*' ? OP_MULT : OP_DIV);
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Compiles a term preceded by any number of signs.
+ *
+ * @param compiler The compiler.
+ * @return CALC_OK or the error of the compilation.
+ */
+static int compileUnary(struct Compiler *compiler) {
+    int negative = 0;
+    char c;
+
+    while ((c = skipSpaces(compiler->scanner)) == '+' || c == '-') {
+        negative ^= c == '-';
+        compiler->scanner->position++;
+    }
+    int status = compilePrimary(compiler);
+    if (status == CALC_OK && negative) {
+        status = emit(compiler, OP_NEGATE);
+    }
+    return status;
+}
+
+/**
+ * @brief Compiles a number or a sum in parentheses.
+ *
+ * @param compiler The compiler.
+ * @return CALC_OK or the error of the compilation.
+ */
+static int compilePrimary(struct Compiler *compiler) {
+    struct Scanner *scanner = compiler->scanner;
+    char c = skipSpaces(scanner);
+
+    if (c == '(') {
+        if (compiler->nesting == EXPRESSION_STACK) {
+            return CALC_TOO_MANY_OPERANDS;
+        }
+        scanner->position++;
+        compiler->nesting++;
+        int status = compileSum(compiler);
+        compiler->nesting--;
+        if (status != CALC_OK) {
+            return status;
+        }
+        if (skipSpaces(scanner) != ')') {
+            return CALC_SYNTAX_ERROR;
+        }
+        scanner->position++;
+        return CALC_OK;
+    }
+
+    if ((c >= '0' && c <= '9') || c == '.') {
+        double value;
+        int used = scanNumber(scanner->text + scanner->position, scanner->length - scanner->position, &value);
+        if (used == 0) {
+            return CALC_SYNTAX_ERROR;
+        }
+        int status = emitConstant(compiler, value);
+        if (status == CALC_OK) {
+            scanner->position += used;
+        }
+        return status;
+    }
+    return CALC_SYNTAX_ERROR;
+}
+
+/**
+ * @brief Appends an instruction without operand and tracks the pending values.
+ *
+ * @param compiler The compiler.
+ * @param instruction The instruction.
+ * @return CALC_OK, or CALC_TOO_MANY_OPERANDS if the code is full.
+ */
+static int emit(struct Compiler *compiler, unsigned char instruction) {
+    struct Program *program = compiler->program;
+
+    if (program->length == EXPRESSION_CODE) {
+        return CALC_TOO_MANY_OPERANDS;
+    }
+    program->code[program->length++] = instruction;
+    if (instruction >= OP_ADD && instruction <= OP_DIV) {
+        compiler->depth--;
+    }
+    return CALC_OK;
+}
+
+/**
+ * @brief Appends the push of a number.
+ *
+ * @param compiler The compiler.
+ * @param value The number.
+ * @return CALC_OK, or CALC_TOO_MANY_OPERANDS if the code, the constants or the stack are full.
+ */
+static int emitConstant(struct Compiler *compiler, double value) {
+    struct Program *program = compiler->program;
+
+    if (program->length + 2 > EXPRESSION_CODE || program->numConstants == EXPRESSION_CONSTANTS
+        || compiler->depth == EXPRESSION_STACK) {
+        return CALC_TOO_MANY_OPERANDS;
+    }
+    program->constants[program->numConstants] = value;
+    program->code[program->length++] = OP_PUSH;
+    program->code[program->length++] = (unsigned char) program->numConstants++;
+    compiler->depth++;
+    return CALC_OK;
+}
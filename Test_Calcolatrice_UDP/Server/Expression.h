@@ -0,0 +1,71 @@
+#ifndef SERVER_EXPRESSION_H_
+#define SERVER_EXPRESSION_H_
+
+/**
+ * @file Expression.h
+ * @brief Header file for the infix expressions compiled to bytecode.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * An expression request is EXPRESSION_OPERATOR followed by an infix formula,
+ * "X (1 + 2) * -3 / 4". The formula is compiled once into a program for a stack
+ * machine, then run by a loop that applies the primitives of Calculator.c:
+ *
+ *     sum:     product { (+|-) product }
+ *     product: unary { (*|/) unary }
+ *     unary:   (+|-) unary | primary
+ *     primary: number | ( sum )
+ */
+
+#define EXPRESSION_CODE 512     // Bytes of bytecode a program can hold
+#define EXPRESSION_CONSTANTS 128 // Numbers a program can hold
+#define EXPRESSION_STACK 32     // Values pending at once, also the deepest nesting
+
+/**
+ * @brief A compiled expression.
+ *
+ * Every instruction is one byte, the push of a number is followed by the index
+ * of the number in the constants.
+ */
+struct Program {
+    unsigned char code[EXPRESSION_CODE];     // Instructions, ended by the one returning the result
+    double constants[EXPRESSION_CONSTANTS];  // Numbers pushed by the instructions
+    int length;                              // Bytes of code used
+    int numConstants;                        // Numbers used
+};
+
+/**
+ * @brief Compiles an expression up to the end of the view or the next BATCH_SEPARATOR.
+ *
+ * The separator is not consumed. On an error the scanner stops at the character
+ * that was rejected.
+ *
+ * @param scanner The scanner, positioned after EXPRESSION_OPERATOR.
+ * @param program Receives the compiled expression.
+ * @return CALC_OK, CALC_SYNTAX_ERROR or CALC_TOO_MANY_OPERANDS when a limit of the program is exceeded.
+ */
+int compileExpression(struct Scanner *scanner, struct Program *program);
+
+/**
+ * @brief Evaluates the prefix operation or the expression at the position of the scanner.
+ *
+ * An expression is compiled and run, any other operation is parsed and calculated.
+ *
+ * @param scanner The scanner, positioned before the operator.
+ * @param operation Receives the operator (EXPRESSION_OPERATOR for an expression),
+ *                  the operands of an operation and the position of an error.
+ * @param result Receives the result when the evaluation succeeds.
+ * @return CALC_OK on success, otherwise the CALC_ error code.
+ */
+int evaluateOperation(struct Scanner *scanner, struct Operation *operation, double *result);
+
+/**
+ * @brief Runs a compiled expression.
+ *
+ * @param program The program.
+ * @param result Receives the value of the expression.
+ * @return CALC_OK or CALC_DIVISION_BY_ZERO.
+ */
+int runProgram(const struct Program *program, double *result);
+
+#endif /* SERVER_EXPRESSION_H_ */
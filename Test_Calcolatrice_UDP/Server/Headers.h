@@ -16,11 +16,13 @@
 #if defined WIN32
 #include <winsock.h>    /**< Windows Sockets API */
 #include <ws2tcpip.h>   /**< Windows Sockets 2 API */
+#define strtok_r strtok_s       /**< Re-entrant tokenizer has the same signature */
 #else
 #include <unistd.h>     /**< Symbolic constants and types for POSIX */
 #include <sys/socket.h> /**< Socket functions */
 #include <arpa/inet.h>  /**< Definitions for internet operations */
 #include <netinet/in.h> /**< Internet address family */
+#include <netdb.h>      /**< Network database operations */
 #define closesocket close
 #endif
 
@@ -0,0 +1,373 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Log.h"
+
+#include <stdint.h>     // Signed distance between ring positions
+#if !defined WIN32
+#include <pthread.h>    // Writer thread
+#endif
+#if defined __linux__
+#include "LogSegments.h"
+#endif
+
+/**
+ * @file Log.c
+ * @brief Implementation file for the asynchronous log of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The ring is a bounded multi-producer queue: every slot carries the position it is
+ * ready for, so a request thread claims a position with a single compare-and-swap
+ * and publishes its record by advancing the sequence of the slot, while the only
+ * consumer, the writer thread, takes the records in order and appends them to the
+ * file with one write per batch. A full ring never blocks a request: the record is
+ * dropped and counted, and the writer reports the count.
+ */
+
+#define LOG_MASK (LOG_RECORDS - 1)
+#define LOG_LINE (BUFFERSIZE + 40)  // Longest formatted line
+
+/**
+ * @brief A slot of the ring.
+ */
+struct LogRecord {
+    size_t sequence;            // Position + 1 once the record is published, position while free
+    time_t timestamp;           // Second the record was written
+    int length;                 // Length of the message
+    char text[BUFFERSIZE];      // Message, not terminated
+};
+
+static struct LogRecord records[LOG_RECORDS]; // Ring of the records
+static size_t enqueuePosition;  // Next position claimed by a request thread
+static size_t dequeuePosition;  // Next position read by the writer
+static unsigned long dropped;   // Records dropped because the ring was full
+static int writerRunning;       // 1 while the writer thread consumes the ring
+static FILE *logFile;           // Log file, open for the whole run
+static int sinkOpen;            // 1 once the log file or the segments are open
+static int logSegments;         // Number of rotating segments, 0 to append to a single file
+static size_t logSegmentSize = (size_t) LOG_SEGMENT_SIZE << 20; // Size of a segment in bytes
+static time_t cachedSecond = -1; // Second cachedDate was formatted for
+static char cachedDate[20];     // Date and time of cachedSecond
+
+int logLevel = LOG_LEVEL_DEBUG; // Messages above this level are skipped at run time
+int logSampling = 1;            // Only 1 request in logSampling is logged
+
+#if !defined WIN32
+static pthread_t writerThread;  // Thread writing the records
+static pthread_mutex_t logMutex = PTHREAD_MUTEX_INITIALIZER; // Serializes the writes to the log file
+
+static void pushRecord(const char *message);
+static void *runWriter(void *unused);
+#endif
+static int formatLine(char *line, time_t timestamp, const char *text, int length);
+static int openSink(void);
+static int messageLength(const char *message);
+static void writeBatch(const char *batch, int length);
+
+/**
+ * @brief Opens the log file and starts the thread writing the records.
+ *
+ * @return 0 on success, -1 if the records are written synchronously.
+ */
+int openLog(void) {
+    sinkOpen = openSink() == 0;
+    if (!sinkOpen) {
+        printf("Error opening the log file.\n");
+        return -1;
+    }
+
+#if defined WIN32
+    return -1;
+#else
+    for (size_t i = 0; i < LOG_RECORDS; i++) {
+        records[i].sequence = i;
+    }
+
+    __atomic_store_n(&writerRunning, 1, __ATOMIC_RELEASE);
+    if (pthread_create(&writerThread, NULL, runWriter, NULL) != 0) {
+        __atomic_store_n(&writerRunning, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
+    atexit(closeLog);
+    return 0;
+#endif
+}
+
+/**
+ * @brief Writes the records still in the ring and stops the writer thread.
+ */
+void closeLog(void) {
+#if !defined WIN32
+    if (__atomic_exchange_n(&writerRunning, 0, __ATOMIC_ACQ_REL)) {
+        pthread_join(writerThread, NULL);
+    }
+#endif
+#if defined __linux__
+    if (logSegments > 0) {
+        closeSegments();
+        return;
+    }
+#endif
+    if (logFile != NULL) {
+        fflush(logFile);
+    }
+}
+
+/**
+ * @brief Keeps the log in rotating, memory-mapped segments instead of a single file.
+ *
+ * @param count The number of segments kept, 0 to append to a single file.
+ * @param size The size of a segment in MiB.
+ */
+void setLogSegments(int count, int size) {
+    logSegments = count > 0 ? count : 0;
+    if (size > 0) {
+        logSegmentSize = (size_t) size << 20;
+    }
+}
+
+/**
+ * @brief Sets the level of the messages kept at run time and the request sampling.
+ *
+ * @param level The highest LOG_LEVEL_ value kept.
+ * @param sampling Log 1 request in sampling (1 logs all of them).
+ */
+void setLogLevel(int level, int sampling) {
+    logLevel = level;
+    logSampling = sampling < 1 ? 1 : sampling;
+}
+
+/**
+ * @brief Converts the name of a level (error, warn, info, debug, trace) to its value.
+ *
+ * @param name The name of the level.
+ * @return The LOG_LEVEL_ value, -1 for an unknown name.
+ */
+int parseLogLevel(const char *name) {
+    static const char *names[] = { "error", "warn", "info", "debug", "trace" };
+
+    for (int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_TRACE; level++) {
+        if (strcmp(name, names[level]) == 0) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Decides whether the current request of the calling thread is logged.
+ *
+ * @return 1 for 1 request in logSampling, 0 for the others.
+ */
+int sampleRequest(void) {
+    static _Thread_local unsigned int requests; // Requests seen by the calling thread
+
+    return logSampling <= 1 || requests++ % (unsigned int) logSampling == 0;
+}
+
+/**
+ * @brief Writes a log message to the log file.
+ *
+ * While the writer thread runs the message is only copied into the ring, so no
+ * request thread waits for the file; otherwise it is written immediately.
+ *
+ * @param message The log message to be written.
+ */
+void writeLog(const char* message) {
+    char line[LOG_LINE];
+
+#if !defined WIN32
+    if (__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+        pushRecord(message);
+        return;
+    }
+    pthread_mutex_lock(&logMutex);
+#endif
+    if (!sinkOpen) {
+        sinkOpen = openSink() == 0;
+    }
+    if (sinkOpen) {
+        writeBatch(line, formatLine(line, time(NULL), message, messageLength(message)));
+    } else {
+        printf("Error opening the log file.\n");
+    }
+#if !defined WIN32
+    pthread_mutex_unlock(&logMutex);
+#endif
+}
+
+#if !defined WIN32
+/**
+ * @brief Copies a message into the next free slot of the ring.
+ *
+ * @param message The log message.
+ */
+static void pushRecord(const char *message) {
+    size_t position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+    struct LogRecord *record;
+
+    while (1) {
+        record = &records[position & LOG_MASK];
+        size_t sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+        intptr_t distance = (intptr_t) (sequence - position);
+
+        if (distance == 0) {
+            // The slot is free: claim it (a failed exchange reloads the position)
+            if (__atomic_compare_exchange_n(&enqueuePosition, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (distance < 0) {
+            // The writer is a whole ring behind
+            __atomic_add_fetch(&dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+
+    record->timestamp = time(NULL);
+    record->length = messageLength(message);
+    memcpy(record->text, message, (size_t) record->length);
+    __atomic_store_n(&record->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Body of the writer thread: drains the ring into the file in batches.
+ *
+ * When the ring is empty the thread sleeps for LOG_IDLE_MS, so the request threads
+ * never have to wake it up. It exits once closeLog() is called and the ring is empty.
+ *
+ * @param unused Not used.
+ * @return NULL.
+ */
+static void *runWriter(void *unused) {
+    static char batch[LOG_BATCH];
+    const struct timespec idle = { 0, LOG_IDLE_MS * 1000000L };
+
+    (void) unused;
+    while (1) {
+        int length = 0;
+        int count = 0;
+        size_t position = dequeuePosition;
+        struct LogRecord *record = &records[position & LOG_MASK];
+
+        pthread_mutex_lock(&logMutex);
+        while (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) == position + 1) {
+            if (length + LOG_LINE > LOG_BATCH) {
+                writeBatch(batch, length);
+                length = 0;
+            }
+            length += formatLine(batch + length, record->timestamp, record->text, record->length);
+
+            // Free the slot for the producer one ring ahead
+            __atomic_store_n(&record->sequence, position + LOG_RECORDS, __ATOMIC_RELEASE);
+            position++;
+            count++;
+            record = &records[position & LOG_MASK];
+        }
+        dequeuePosition = position;
+
+        unsigned long lost = __atomic_exchange_n(&dropped, 0, __ATOMIC_RELAXED);
+        if (lost > 0) {
+            char note[BUFFERSIZE];
+            snprintf(note, sizeof(note), "%lu log records dropped, the log ring was full", lost);
+            if (length + LOG_LINE > LOG_BATCH) {
+                writeBatch(batch, length);
+                length = 0;
+            }
+            length += formatLine(batch + length, time(NULL), note, messageLength(note));
+        }
+        if (length > 0) {
+            writeBatch(batch, length);
+        }
+#if defined __linux__
+        if (count == 0 && logSegments > 0) {
+            syncSegments(); // Write back the end of the last burst
+        }
+#endif
+        pthread_mutex_unlock(&logMutex);
+
+        if (count == 0) {
+            if (!__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+                return NULL;
+            }
+            nanosleep(&idle, NULL);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Opens the segments of the log, or its file when they are not used.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+static int openSink(void) {
+#if defined __linux__
+    if (logSegments > 0) {
+        return openSegments(LOG_FILE, logSegments, logSegmentSize, NULL, 0);
+    }
+#endif
+    logFile = fopen(LOG_FILE, "a");
+    return logFile != NULL ? 0 : -1;
+}
+
+/**
+ * @brief Formats a record as a line of the log file.
+ *
+ * The date is formatted once per second and reused for every record of that second.
+ *
+ * @param line Buffer of LOG_LINE bytes receiving the line.
+ * @param timestamp The second the record was written.
+ * @param text The message.
+ * @param length The length of the message.
+ * @return The length of the line.
+ */
+static int formatLine(char *line, time_t timestamp, const char *text, int length) {
+    if (timestamp != cachedSecond) {
+        struct tm timeInfo;
+#if defined WIN32
+        localtime_s(&timeInfo, &timestamp);
+#else
+        localtime_r(&timestamp, &timeInfo);
+#endif
+        // Get current date and time
+        strftime(cachedDate, sizeof(cachedDate), "%H:%M:%S %d/%m/%Y", &timeInfo);
+        cachedSecond = timestamp;
+    }
+
+    return snprintf(line, LOG_LINE, "SERVER - [%s] - %.*s\n", cachedDate, length, text);
+}
+
+/**
+ * @brief Returns the length of a message, at most BUFFERSIZE.
+ *
+ * @param message The NUL-terminated message.
+ * @return The number of characters stored for it.
+ */
+static int messageLength(const char *message) {
+    int length = 0;
+
+    while (length < BUFFERSIZE && message[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief Appends formatted lines to the log file.
+ *
+ * @param batch The lines.
+ * @param length The number of bytes.
+ */
+static void writeBatch(const char *batch, int length) {
+#if defined __linux__
+    if (logSegments > 0) {
+        writeSegments(batch, length);
+        return;
+    }
+#endif
+    fwrite(batch, 1, (size_t) length, logFile);
+    fflush(logFile);
+}
@@ -0,0 +1,90 @@
+#ifndef SERVER_LOG_H_
+#define SERVER_LOG_H_
+
+/**
+ * @file Log.h
+ * @brief Header file for the asynchronous log of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define LOG_FILE "Log.txt"      // File the records are appended to
+#define LOG_RECORDS 4096        // Records the ring can hold (power of two)
+#define LOG_BATCH 65536         // Bytes the writer gathers before each write to the file
+#define LOG_IDLE_MS 1           // Time the writer sleeps when the ring is empty
+#define LOG_SEGMENT_SIZE 16     // Default size of a log segment in MiB
+
+// Levels of the messages: a message is kept if its level is at most both the level
+// compiled in and the level chosen at run time
+#define LOG_LEVEL_ERROR 0       // The server or a client cannot go on
+#define LOG_LEVEL_WARN 1        // Something unexpected the server recovered from
+#define LOG_LEVEL_INFO 2        // Connections and state of the server
+#define LOG_LEVEL_DEBUG 3       // Every request and reply, 1 in logSampling
+#define LOG_LEVEL_TRACE 4       // Even more detail about the sampled requests
+
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LOG_LEVEL_TRACE // Messages above this level are compiled out
+#endif
+
+extern int logLevel;            // Messages above this level are skipped at run time
+extern int logSampling;         // Only 1 request in logSampling is logged
+
+// True if messages of the level are kept; a constant false when compiled out
+#define LOG_ENABLED(level) ((level) <= LOG_COMPILED_LEVEL && (level) <= logLevel)
+// True if the current request is logged at the level
+#define LOG_SAMPLED(level) (LOG_ENABLED(level) && sampleRequest())
+// Writes a message if its level is kept
+#define LOG_MESSAGE(level, message) do { if (LOG_ENABLED(level)) writeLog(message); } while (0)
+
+/**
+ * @brief Opens the log file and starts the thread writing the records.
+ *
+ * From then on writeLog() only copies the message into a lock-free ring; if the
+ * thread cannot be started the records are written synchronously instead. The
+ * remaining records are written when the process exits.
+ *
+ * @return 0 on success, -1 if the records are written synchronously.
+ */
+int openLog(void);
+
+/**
+ * @brief Writes the records still in the ring and stops the writer thread.
+ */
+void closeLog(void);
+
+/**
+ * @brief Keeps the log in rotating, memory-mapped segments instead of a single file.
+ *
+ * Must be called before openLog(); the segments are only available on Linux.
+ *
+ * @param count The number of segments kept, 0 to append to a single file.
+ * @param size The size of a segment in MiB.
+ */
+void setLogSegments(int count, int size);
+
+/**
+ * @brief Sets the level of the messages kept at run time and the request sampling.
+ *
+ * @param level The highest LOG_LEVEL_ value kept.
+ * @param sampling Log 1 request in sampling (1 logs all of them).
+ */
+void setLogLevel(int level, int sampling);
+
+/**
+ * @brief Converts the name of a level (error, warn, info, debug, trace) to its value.
+ *
+ * @param name The name of the level.
+ * @return The LOG_LEVEL_ value, -1 for an unknown name.
+ */
+int parseLogLevel(const char *name);
+
+/**
+ * @brief Decides whether the current request of the calling thread is logged.
+ *
+ * Every thread counts its own requests, so the decision takes no shared state.
+ *
+ * @return 1 for 1 request in logSampling, 0 for the others.
+ */
+int sampleRequest(void);
+
+#endif /* SERVER_LOG_H_ */
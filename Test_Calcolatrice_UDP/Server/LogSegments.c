@@ -0,0 +1,189 @@
+#include "Headers.h"
+#include "LogSegments.h"
+
+#include <fcntl.h>      // File control options
+#include <sys/mman.h>   // Memory mapping of the segments
+#include <sys/stat.h>   // Modification time of the segments
+
+/**
+ * @file LogSegments.c
+ * @brief Implementation file for the memory-mapped, rotating segments of the log.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Only the writer of the log calls these functions, so the state is not locked.
+ */
+
+static char segmentName[256];   // Name the segments are numbered after
+static int segmentCount;        // Number of segments kept
+static size_t segmentSize;      // Size of every segment
+static const char *segmentHeader; // Bytes every segment starts with
+static int segmentHeaderLength; // Number of bytes of segmentHeader
+static int segmentIndex;        // Segment being written
+static int segmentFd = -1;      // Descriptor of the segment being written
+static char *segmentMap;        // Mapping of the segment being written
+static size_t segmentUsed;      // Bytes written to the segment
+static int segmentDirty;        // 1 if bytes were written since the last msync()
+static long long lastSync;      // Time of the last msync() in milliseconds
+
+static int mapSegment(int index);
+static void unmapSegment(int flags);
+static long long elapsedMs(void);
+
+/**
+ * @brief Opens the segment after the most recently written one.
+ *
+ * @param name The name of the log file the segments are named after.
+ * @param count The number of segments kept.
+ * @param size The size of a segment in bytes.
+ * @param header Bytes every segment starts with, NULL for none.
+ * @param headerLength The number of bytes of the header.
+ * @return 0 on success, -1 on failure.
+ */
+int openSegments(const char *name, int count, size_t size, const char *header, int headerLength) {
+    char path[sizeof(segmentName) + 16];
+    struct stat info;
+    struct timespec newest = { 0, 0 };
+    int next = 0;
+
+    snprintf(segmentName, sizeof(segmentName), "%s", name);
+    segmentCount = count;
+    segmentSize = size;
+    segmentHeader = header;
+    segmentHeaderLength = header != NULL ? headerLength : 0;
+
+    // Continue after the segment written last by a previous run
+    for (int i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s.%d", segmentName, i);
+        if (stat(path, &info) == 0 && (info.st_mtim.tv_sec > newest.tv_sec
+            || (info.st_mtim.tv_sec == newest.tv_sec && info.st_mtim.tv_nsec > newest.tv_nsec))) {
+            newest = info.st_mtim;
+            next = (i + 1) % count;
+        }
+    }
+
+    lastSync = elapsedMs();
+    return mapSegment(next);
+}
+
+/**
+ * @brief Appends a batch to the current segment, moving to the next one when it is full.
+ *
+ * @param data The bytes to append.
+ * @param length The number of bytes, at most the size of a segment minus the header.
+ * @return 0 on success, -1 if no segment could be mapped.
+ */
+int writeSegments(const char *data, int length) {
+    if (segmentMap != NULL && segmentUsed + (size_t) length > segmentSize) {
+        int next = (segmentIndex + 1) % segmentCount;
+        unmapSegment(MS_ASYNC);
+        mapSegment(next);
+    }
+    if (segmentMap == NULL) {
+        return -1;
+    }
+
+    memcpy(segmentMap + segmentUsed, data, (size_t) length);
+    segmentUsed += (size_t) length;
+    segmentDirty = 1;
+    syncSegments();
+    return 0;
+}
+
+/**
+ * @brief Schedules the write-back of the current segment if LOG_SYNC_MS have passed.
+ *
+ * The pages are only queued for writing, the writer of the log never waits for the disk.
+ */
+void syncSegments(void) {
+    if (segmentMap == NULL || !segmentDirty) {
+        return;
+    }
+
+    long long now = elapsedMs();
+    if (now - lastSync >= LOG_SYNC_MS) {
+        msync(segmentMap, segmentUsed, MS_ASYNC);
+        segmentDirty = 0;
+        lastSync = now;
+    }
+}
+
+/**
+ * @brief Waits for the write-back of the current segment, truncates and closes it.
+ */
+void closeSegments(void) {
+    unmapSegment(MS_SYNC);
+}
+
+/**
+ * @brief Creates a segment at its full size and maps it.
+ *
+ * @param index The number of the segment.
+ * @return 0 on success, -1 on failure.
+ */
+static int mapSegment(int index) {
+    char path[sizeof(segmentName) + 16];
+
+    snprintf(path, sizeof(path), "%s.%d", segmentName, index);
+    segmentFd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segmentFd < 0) {
+        return -1;
+    }
+
+    // Reserve the blocks now, so writing to the mapping never allocates them
+    if (posix_fallocate(segmentFd, 0, (off_t) segmentSize) != 0
+        && ftruncate(segmentFd, (off_t) segmentSize) < 0) {
+        close(segmentFd);
+        segmentFd = -1;
+        return -1;
+    }
+
+    void *map = mmap(NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, segmentFd, 0);
+    if (map == MAP_FAILED) {
+        close(segmentFd);
+        segmentFd = -1;
+        return -1;
+    }
+
+    segmentMap = map;
+    segmentIndex = index;
+    segmentUsed = 0;
+    if (segmentHeaderLength > 0) {
+        memcpy(segmentMap, segmentHeader, (size_t) segmentHeaderLength);
+        segmentUsed = (size_t) segmentHeaderLength;
+        segmentDirty = 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes back the current segment and cuts it to the bytes it holds.
+ *
+ * @param flags MS_ASYNC to only queue the write-back, MS_SYNC to wait for it.
+ */
+static void unmapSegment(int flags) {
+    if (segmentMap == NULL) {
+        return;
+    }
+
+    msync(segmentMap, segmentUsed, flags);
+    munmap(segmentMap, segmentSize);
+    segmentMap = NULL;
+    segmentDirty = 0;
+    if (ftruncate(segmentFd, (off_t) segmentUsed) < 0) {
+        printf("Error truncating the log segment.\n");
+    }
+    close(segmentFd);
+    segmentFd = -1;
+}
+
+/**
+ * @brief Returns a monotonic time in milliseconds.
+ *
+ * @return The current time.
+ */
+static long long elapsedMs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
@@ -0,0 +1,573 @@
+#include "Headers.h"
+#include "Number.h"
+
+#include <math.h>       // HUGE_VAL, signbit(), isfinite()
+
+/**
+ * @file Number.c
+ * @brief Implementation file for the conversions between doubles and decimal text.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define POWER_OF_FIVE_MIN (-342)    // Exponent of the first entry of powersOfFive
+#define POWER_OF_FIVE_MAX 308       // Exponent of the last entry of powersOfFive
+#define POWER_OF_TEN_MIN (-324)     // Exponent of the first entry of scaledPowersOfTen
+#define MANTISSA_BITS 52            // Explicit bits of the mantissa of a double
+#define EXPONENT_BIAS 1023          // Bias of the exponent of a double
+#define EXPONENT_INFINITE 0x7FF     // Biased exponent of infinity
+#define LOWEST_EXPONENT (-1074)     // Exponent of the unit of the subnormals
+#define MASK_63 0x7FFFFFFFFFFFFFFFULL
+
+// Defined in NumberTables.c
+extern const uint64_t powersOfFive[][2];
+extern const uint64_t scaledPowersOfTen[][2];
+
+// Powers of ten that a double holds exactly
+static const double exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Powers of ten that a uint64_t holds
+static const uint64_t integerPowersOfTen[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// The two digits of every number below 100, written two at a time
+static const char digitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static uint64_t multiplyHigh(uint64_t a, uint64_t b, uint64_t *low);
+static int leadingZeros(uint64_t value);
+static double fromBits(uint64_t bits);
+static uint64_t toBits(double value);
+static uint64_t roundOdd(uint64_t g1, uint64_t g0, uint64_t cp);
+static void shortestDigits(uint64_t bits, uint64_t *digits, int *exponent);
+static int writeDigits(char *buffer, uint64_t digits, int count);
+static int countDigits(uint64_t value);
+static int copyText(char *buffer, int size, const char *text, int length);
+
+/**
+ * @brief Converts a decimal mantissa and exponent to the nearest double.
+ *
+ * Values of up to 15 digits with a small exponent are exact after a single
+ * multiplication or division. The others are multiplied by a 128 bit truncated
+ * power of five: the top bits of the product are the mantissa unless they sit
+ * right on a rounding boundary, which the original algorithm leaves to a slower path.
+ *
+ * @param mantissa The decimal digits of the number, without the sign.
+ * @param exponent The power of ten the mantissa is multiplied by.
+ * @param value Receives the nearest double (0 or infinity out of range).
+ * @return 0 on success, -1 in the rare cases the caller must convert the text itself.
+ */
+int decimalToDouble(uint64_t mantissa, int exponent, double *value) {
+    if (mantissa == 0 || exponent < POWER_OF_FIVE_MIN) {
+        *value = 0;
+        return 0;
+    }
+    if (mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        // Both factors are exact, so the single rounding gives the nearest double
+        *value = exponent < 0 ? (double) mantissa / exactPowersOfTen[-exponent]
+                              : (double) mantissa * exactPowersOfTen[exponent];
+        return 0;
+    }
+    if (exponent > POWER_OF_FIVE_MAX) {
+        *value = HUGE_VAL;
+        return 0;
+    }
+
+    int zeros = leadingZeros(mantissa);
+    uint64_t w = mantissa << zeros;
+    const uint64_t *power = powersOfFive[exponent - POWER_OF_FIVE_MIN];
+
+    // The top 55 bits of the product decide the mantissa; refine them with the
+    // low half of the power only when they could still carry
+    uint64_t low;
+    uint64_t high = multiplyHigh(w, power[0], &low);
+    if ((high & 0x1FF) == 0x1FF) {
+        uint64_t ignored;
+        uint64_t second = multiplyHigh(w, power[1], &ignored);
+        low += second;
+        if (second > low) {
+            high++;
+        }
+    }
+    if (low == UINT64_MAX && (exponent < -27 || exponent > 55)) {
+        return -1;
+    }
+
+    int upper = (int) (high >> 63);
+    int shift = upper + 64 - MANTISSA_BITS - 3;
+    uint64_t bits = high >> shift;
+    int power2 = (int) (((217706LL * exponent) >> 16) + 63) + upper - zeros + EXPONENT_BIAS;
+
+    if (power2 <= 0) {
+        // Subnormal: shift the mantissa down to the lowest exponent and round
+        if (-power2 + 1 >= 64) {
+            *value = 0;
+            return 0;
+        }
+        bits >>= -power2 + 1;
+        bits += bits & 1;
+        bits >>= 1;
+        power2 = bits < (1ULL << MANTISSA_BITS) ? 0 : 1;
+        *value = fromBits(bits | (uint64_t) power2 << MANTISSA_BITS);
+        return 0;
+    }
+
+    // A product that is exactly halfway rounds to even
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (bits & 3) == 1 && (bits << shift) == high) {
+        bits &= ~1ULL;
+    }
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >= (2ULL << MANTISSA_BITS)) {
+        bits = 1ULL << MANTISSA_BITS;
+        power2++;
+    }
+    bits &= ~(1ULL << MANTISSA_BITS);
+    if (power2 >= EXPONENT_INFINITE) {
+        *value = HUGE_VAL;
+        return 0;
+    }
+    *value = fromBits(bits | (uint64_t) power2 << MANTISSA_BITS);
+    return 0;
+}
+
+/**
+ * @brief Writes the shortest decimal that reads back to exactly the value.
+ *
+ * Infinities and NaN are written as printf() does.
+ *
+ * @param buffer Buffer of NUMBER_SIZE bytes receiving the terminated text.
+ * @param value The value.
+ * @return The length of the text.
+ */
+int formatShortest(char *buffer, double value) {
+    uint64_t bits = toBits(value);
+    int length = 0;
+
+    if (!isfinite(value)) {
+        return snprintf(buffer, NUMBER_SIZE, "%f", value);
+    }
+    if (bits >> 63) {
+        buffer[length++] = '-';
+    }
+    if ((bits & MASK_63) == 0) {
+        buffer[length++] = '0';
+        buffer[length] = '\0';
+        return length;
+    }
+
+    uint64_t digits;
+    int exponent;
+    shortestDigits(bits, &digits, &exponent);
+    if ((bits & MASK_63) < (1ULL << MANTISSA_BITS)) {
+        // Schubfach drops at most one digit, the widely spaced subnormals may lose more
+        double back;
+        while (digits >= 10 && decimalToDouble((digits + 5) / 10, exponent + 1, &back) == 0
+               && toBits(back) == (bits & MASK_63)) {
+            digits = (digits + 5) / 10;
+            exponent++;
+        }
+    }
+    while (digits % 10 == 0) {
+        digits /= 10;
+        exponent++;
+    }
+
+    // Same layout as the numbers of JavaScript: point is the position of the
+    // decimal point counted from the first digit
+    int count = countDigits(digits);
+    int point = count + exponent;
+    if (count <= point && point <= 21) {
+        // 1500
+        length += writeDigits(buffer + length, digits, count);
+        memset(buffer + length, '0', point - count);
+        length += point - count;
+    } else if (0 < point && point <= 21) {
+        // 1.5
+        writeDigits(buffer + length, digits / integerPowersOfTen[count - point], point);
+        buffer[length + point] = '.';
+        writeDigits(buffer + length + point + 1, digits % integerPowersOfTen[count - point], count - point);
+        length += count + 1;
+    } else if (-6 < point && point <= 0) {
+        // 0.0015
+        buffer[length++] = '0';
+        buffer[length++] = '.';
+        memset(buffer + length, '0', -point);
+        length += -point;
+        length += writeDigits(buffer + length, digits, count);
+    } else {
+        // 1.5e+300
+        uint64_t first = digits / integerPowersOfTen[count - 1];
+        buffer[length++] = (char) ('0' + first);
+        if (count > 1) {
+            buffer[length++] = '.';
+            length += writeDigits(buffer + length, digits - first * integerPowersOfTen[count - 1], count - 1);
+        }
+        length += sprintf(buffer + length, "e%c%d", point > 0 ? '+' : '-', abs(point - 1));
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Writes the value with a fixed number of decimals, exactly as printf("%.*f").
+ *
+ * The value times 10^precision is rounded to an integer with a 128 bit product,
+ * halfway cases to even as printf() does, and the point is put back in. Values
+ * too large for the product, infinities and NaN are left to snprintf().
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param value The value.
+ * @param precision The number of decimals.
+ * @return The length of the text, as snprintf().
+ */
+int formatFixed(char *buffer, int size, double value, int precision) {
+    uint64_t bits = toBits(value);
+    uint64_t mantissa = bits & ((1ULL << MANTISSA_BITS) - 1);
+    int biased = (int) (bits >> MANTISSA_BITS) & EXPONENT_INFINITE;
+
+    // Past 2^60 / 10^precision the scaled value no longer fits in 64 bits
+    if (precision < 0 || precision > NUMBER_MAXPRECISION || !isfinite(value)
+        || fromBits(bits & MASK_63) >= (double) (1ULL << 60) / (double) integerPowersOfTen[precision]) {
+        return snprintf(buffer, size, "%.*f", precision, value);
+    }
+
+    // value = mantissa * 2^exponent exactly
+    int exponent = biased == 0 ? LOWEST_EXPONENT : biased - EXPONENT_BIAS - MANTISSA_BITS;
+    if (biased != 0) {
+        mantissa |= 1ULL << MANTISSA_BITS;
+    }
+
+    uint64_t scaled;
+    if (exponent >= 0) {
+        scaled = (mantissa << exponent) * integerPowersOfTen[precision];
+    } else {
+        // mantissa * 10^precision takes at most 53 + 30 bits: keep it as high:low
+        uint64_t low;
+        uint64_t high = multiplyHigh(mantissa, integerPowersOfTen[precision], &low);
+        int shift = -exponent;
+        uint64_t remainderHigh, remainderLow, halfHigh, halfLow;
+
+        if (shift >= 128) {
+            scaled = 0;
+            remainderHigh = high;
+            remainderLow = low;
+            halfHigh = 1ULL << 63;
+            halfLow = 0;
+        } else if (shift >= 64) {
+            scaled = shift == 64 ? high : high >> (shift - 64);
+            remainderHigh = shift == 64 ? 0 : high & ((1ULL << (shift - 64)) - 1);
+            remainderLow = low;
+            halfHigh = shift == 64 ? 0 : 1ULL << (shift - 65);
+            halfLow = shift == 64 ? 1ULL << 63 : 0;
+        } else {
+            scaled = (low >> shift) | (shift == 0 ? 0 : high << (64 - shift));
+            remainderHigh = 0;
+            remainderLow = low & ((1ULL << shift) - 1);
+            halfHigh = 0;
+            halfLow = 1ULL << (shift - 1);
+        }
+
+        int above = remainderHigh > halfHigh || (remainderHigh == halfHigh && remainderLow > halfLow);
+        int halfway = remainderHigh == halfHigh && remainderLow == halfLow;
+        if (above || (halfway && (scaled & 1))) {
+            scaled++;
+        }
+    }
+
+    // Integer part, then the decimals padded with zeros
+    char text[NUMBER_SIZE + NUMBER_MAXPRECISION];
+    int length = 0;
+    if (signbit(value)) {
+        text[length++] = '-';
+    }
+    uint64_t integer = scaled / integerPowersOfTen[precision];
+    uint64_t decimals = scaled % integerPowersOfTen[precision];
+    length += writeDigits(text + length, integer, countDigits(integer));
+    if (precision > 0) {
+        text[length++] = '.';
+        length += writeDigits(text + length, decimals, precision);
+    }
+    return copyText(buffer, size, text, length);
+}
+
+/**
+ * @brief Writes the value with formatFixed() or formatShortest().
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param value The value.
+ * @param precision The number of decimals, NUMBER_SHORTEST for the shortest exact digits.
+ * @return The length of the text, as snprintf().
+ */
+int formatNumber(char *buffer, int size, double value, int precision) {
+    if (precision != NUMBER_SHORTEST) {
+        return formatFixed(buffer, size, value, precision);
+    }
+    char text[NUMBER_SIZE];
+    return copyText(buffer, size, text, formatShortest(text, value));
+}
+
+/**
+ * @brief Writes an integer with a fixed number of zero decimals.
+ *
+ * The integer is never converted to a double, so it is exact over the whole
+ * range of an int64_t.
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param value The integer.
+ * @param precision The number of decimals, NUMBER_SHORTEST for none.
+ * @return The length of the text, as snprintf().
+ */
+int formatInteger(char *buffer, int size, int64_t value, int precision) {
+    if (precision > NUMBER_MAXPRECISION) {
+        return snprintf(buffer, size, "%lld.%0*d", (long long) value, precision, 0);
+    }
+
+    char text[NUMBER_SIZE + NUMBER_MAXPRECISION];
+    int length = 0;
+    uint64_t magnitude = (uint64_t) value;
+    if (value < 0) {
+        text[length++] = '-';
+        magnitude = 0 - magnitude; // Also right for INT64_MIN
+    }
+    length += writeDigits(text + length, magnitude, countDigits(magnitude));
+    if (precision > 0) {
+        text[length++] = '.';
+        memset(text + length, '0', precision);
+        length += precision;
+    }
+    return copyText(buffer, size, text, length);
+}
+
+/**
+ * @brief Finds the shortest decimal in the rounding interval of a finite, non-zero double.
+ *
+ * This is Schubfach by Raffaello Giulietti: the bounds of the interval are
+ * multiplied by a 126 bit power of ten rounded to odd, which is enough to decide
+ * whether a shorter decimal lies inside it.
+ *
+ * @param bits The bits of the double; the sign is ignored.
+ * @param digits Receives the decimal digits, possibly with trailing zeros.
+ * @param exponent Receives the power of ten the digits are multiplied by.
+ */
+static void shortestDigits(uint64_t bits, uint64_t *digits, int *exponent) {
+    uint64_t fraction = bits & ((1ULL << MANTISSA_BITS) - 1);
+    int biased = (int) (bits >> MANTISSA_BITS) & EXPONENT_INFINITE;
+    uint64_t c;
+    int q;
+
+    if (biased != 0) {
+        int mq = -LOWEST_EXPONENT + 1 - biased;
+        c = (1ULL << MANTISSA_BITS) | fraction;
+        if (0 < mq && mq < MANTISSA_BITS + 1 && ((c >> mq) << mq) == c) {
+            // A small integer is its own shortest decimal
+            *digits = c >> mq;
+            *exponent = 0;
+            return;
+        }
+        q = -mq;
+    } else {
+        c = fraction;
+        q = LOWEST_EXPONENT;
+    }
+
+    uint64_t out = c & 1;
+    uint64_t cb = c << 2;
+    uint64_t cbr = cb + 2;
+    uint64_t cbl;
+    int k;
+    if (c != (1ULL << MANTISSA_BITS) || q == LOWEST_EXPONENT) {
+        cbl = cb - 2;
+        k = (int) (((int64_t) q * 661971961083LL) >> 41);
+    } else {
+        // The power of two below a binade is closer than the next value up
+        cbl = cb - 1;
+        k = (int) (((int64_t) q * 661971961083LL - 274743187321LL) >> 41);
+    }
+    int h = q + (int) (((int64_t) -k * 913124641741LL) >> 38) + 2;
+
+    const uint64_t *g = scaledPowersOfTen[k - POWER_OF_TEN_MIN];
+    uint64_t vb = roundOdd(g[0], g[1], cb << h);
+    uint64_t vbl = roundOdd(g[0], g[1], cbl << h);
+    uint64_t vbr = roundOdd(g[0], g[1], cbr << h);
+
+    uint64_t s = vb >> 2;
+    if (s >= 100) {
+        // Try one digit less first
+        uint64_t sp10 = s / 10 * 10;
+        uint64_t tp10 = sp10 + 10;
+        int upin = vbl + out <= sp10 << 2;
+        int wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin) {
+            *digits = upin ? sp10 : tp10;
+            *exponent = k;
+            return;
+        }
+    }
+    uint64_t t = s + 1;
+    int uin = vbl + out <= s << 2;
+    int win = (t << 2) + out <= vbr;
+    if (uin != win) {
+        *digits = uin ? s : t;
+    } else {
+        // Both neighbours are inside: take the closer one, the even one on a tie
+        int64_t cmp = (int64_t) vb - (int64_t) ((s + t) << 1);
+        *digits = cmp < 0 || (cmp == 0 && (s & 1) == 0) ? s : t;
+    }
+    *exponent = k;
+}
+
+/**
+ * @brief Multiplies by a power of ten of scaledPowersOfTen and rounds to odd.
+ *
+ * @param g1 The upper 63 bits of the power.
+ * @param g0 The lower 63 bits of the power.
+ * @param cp The factor.
+ * @return The upper bits of the product, the lowest one set if any bit below was.
+ */
+static uint64_t roundOdd(uint64_t g1, uint64_t g0, uint64_t cp) {
+    uint64_t ignored, y0;
+    uint64_t x1 = multiplyHigh(g0, cp, &ignored);
+    uint64_t y1 = multiplyHigh(g1, cp, &y0);
+    uint64_t z = (y0 >> 1) + x1;
+    uint64_t vbp = y1 + (z >> 63);
+    return vbp | (((z & MASK_63) + MASK_63) >> 63);
+}
+
+/**
+ * @brief Multiplies two 64 bit integers into 128 bits.
+ *
+ * @param a The first factor.
+ * @param b The second factor.
+ * @param low Receives the lower 64 bits of the product.
+ * @return The upper 64 bits of the product.
+ */
+static uint64_t multiplyHigh(uint64_t a, uint64_t b, uint64_t *low) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128) a * b;
+    *low = (uint64_t) product;
+    return (uint64_t) (product >> 64);
+#else
+    uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+    uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+    *low = (middle << 32) | (lowLow & 0xFFFFFFFF);
+    return aHigh * bHigh + (highLow >> 32) + (middle >> 32);
+#endif
+}
+
+/**
+ * @brief Counts the zero bits above the highest set bit.
+ *
+ * @param value A non-zero value.
+ * @return The number of leading zero bits.
+ */
+static int leadingZeros(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    int zeros = 0;
+    while (!(value & (1ULL << 63))) {
+        value <<= 1;
+        zeros++;
+    }
+    return zeros;
+#endif
+}
+
+/**
+ * @brief Reinterprets 64 bits as a double.
+ *
+ * @param bits The bits.
+ * @return The double.
+ */
+static double fromBits(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Reinterprets a double as 64 bits.
+ *
+ * @param value The double.
+ * @return The bits.
+ */
+static uint64_t toBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Counts the decimal digits of an integer.
+ *
+ * @param value The integer.
+ * @return The number of digits, 1 for 0.
+ */
+static int countDigits(uint64_t value) {
+    int count = 1;
+    while (count < 20 && value >= integerPowersOfTen[count]) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Writes the lowest digits of an integer, padded with zeros.
+ *
+ * The digits are produced two at a time from digitPairs, halving the divisions.
+ *
+ * @param buffer Buffer receiving the digits, not terminated.
+ * @param digits The integer.
+ * @param count The number of digits written.
+ * @return count.
+ */
+static int writeDigits(char *buffer, uint64_t digits, int count) {
+    int i = count;
+    for (; i >= 2; i -= 2) {
+        const char *pair = digitPairs + 2 * (digits % 100);
+        buffer[i - 2] = pair[0];
+        buffer[i - 1] = pair[1];
+        digits /= 100;
+    }
+    if (i == 1) {
+        buffer[0] = (char) ('0' + digits % 10);
+    }
+    return count;
+}
+
+/**
+ * @brief Copies a text into a buffer, truncating it as snprintf() does.
+ *
+ * @param buffer Buffer receiving the terminated text.
+ * @param size The size of the buffer.
+ * @param text The text.
+ * @param length The length of the text.
+ * @return length.
+ */
+static int copyText(char *buffer, int size, const char *text, int length) {
+    if (size > 0) {
+        int copied = length < size ? length : size - 1;
+        memcpy(buffer, text, copied);
+        buffer[copied] = '\0';
+    }
+    return length;
+}
@@ -0,0 +1,156 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Scanner.h"
+#include "Registers.h"
+#include "RegisterTable.h"
+
+/**
+ * @file RegisterTable.c
+ * @brief Implementation file for the registers of the UDP clients.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL // Spreads the address over the sets
+
+/**
+ * @brief The registers of a client.
+ */
+struct ClientRegisters {
+    uint32_t address;           // IPv4 address of the client, in network order
+    uint16_t port;              // Port of the client, in network order
+    time_t lastUsed;            // Time of the last request, 0 while the entry is free
+    struct Registers registers;
+};
+
+/**
+ * @brief A set of clients sharing a lock.
+ *
+ * The lock is held from acquireRegisters() to releaseRegisters(), while a request
+ * of one of the clients is evaluated.
+ */
+struct RegisterSet {
+    unsigned char lock;                 // 1 while a thread works on the set
+    struct ClientRegisters clients[REGISTER_WAYS];
+};
+
+static struct RegisterSet *sets = NULL; // The table, NULL when it is disabled
+static uint64_t setMask = 0;            // Number of sets minus one
+static int timeToLive = REGISTER_TTL;   // Seconds after which the registers of a silent client are dropped
+
+static struct RegisterSet *findSet(const struct sockaddr_in *address);
+static void lockSet(struct RegisterSet *set);
+static void unlockSet(struct RegisterSet *set);
+
+/**
+ * @brief Allocates the table of the registers.
+ *
+ * @param clients The clients the table can hold, rounded up to a power of two sets.
+ * @param ttl The seconds after which the registers of a silent client are dropped.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ */
+int createRegisterTable(int clients, int ttl) {
+    if (clients <= 0 || sets != NULL) {
+        return 0;
+    }
+
+    uint64_t count = 1;
+    while (count * REGISTER_WAYS < (uint64_t) clients) {
+        count <<= 1;
+    }
+    sets = calloc(count, sizeof(struct RegisterSet));
+    if (sets == NULL) {
+        return -1;
+    }
+    setMask = count - 1;
+    timeToLive = ttl;
+    return 0;
+}
+
+/**
+ * @brief Finds the registers of a client, or gives it empty ones, and locks them.
+ *
+ * @param address The address of the client.
+ * @return The registers, to be released with releaseRegisters(), NULL if the table is disabled.
+ */
+struct Registers *acquireRegisters(const struct sockaddr_in *address) {
+    if (sets == NULL) {
+        return NULL;
+    }
+
+    struct RegisterSet *set = findSet(address);
+    time_t now = time(NULL);
+    struct ClientRegisters *client = NULL;
+
+    lockSet(set);
+    for (int i = 0; i < REGISTER_WAYS && client == NULL; i++) {
+        struct ClientRegisters *candidate = &set->clients[i];
+        if (candidate->lastUsed != 0 && candidate->address == address->sin_addr.s_addr
+            && candidate->port == address->sin_port) {
+            client = candidate;
+        }
+    }
+
+    if (client != NULL && now - client->lastUsed > timeToLive) {
+        clearRegisters(&client->registers); // Silent for too long
+    } else if (client == NULL) {
+        // A new client takes a free entry or that of the client silent for the longest time
+        client = &set->clients[0];
+        for (int i = 1; i < REGISTER_WAYS && client->lastUsed != 0; i++) {
+            if (set->clients[i].lastUsed < client->lastUsed) {
+                client = &set->clients[i];
+            }
+        }
+        client->address = address->sin_addr.s_addr;
+        client->port = address->sin_port;
+        clearRegisters(&client->registers);
+    }
+    client->lastUsed = now;
+    return &client->registers;
+}
+
+/**
+ * @brief Unlocks the registers returned by acquireRegisters().
+ *
+ * @param address The address of the client.
+ */
+void releaseRegisters(const struct sockaddr_in *address) {
+    if (sets != NULL) {
+        unlockSet(findSet(address));
+    }
+}
+
+/**
+ * @brief Finds the set a client belongs to.
+ *
+ * @param address The address of the client.
+ * @return The set.
+ */
+static struct RegisterSet *findSet(const struct sockaddr_in *address) {
+    uint64_t key = ((uint64_t) address->sin_addr.s_addr << 16) | address->sin_port;
+    return &sets[((key * HASH_MULTIPLIER) >> 32) & setMask];
+}
+
+/**
+ * @brief Takes the lock of a set, spinning while another thread holds it.
+ *
+ * The lock is held for the evaluation of one request, a few microseconds, and
+ * only the threads serving clients of the same set wait on it.
+ *
+ * @param set The set.
+ */
+static void lockSet(struct RegisterSet *set) {
+    while (__atomic_exchange_n(&set->lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&set->lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+/**
+ * @brief Releases the lock of a set.
+ *
+ * @param set The set.
+ */
+static void unlockSet(struct RegisterSet *set) {
+    __atomic_store_n(&set->lock, 0, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,48 @@
+#ifndef SERVER_REGISTERTABLE_H_
+#define SERVER_REGISTERTABLE_H_
+
+/**
+ * @file RegisterTable.h
+ * @brief Header file for the registers of the UDP clients.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Datagrams have no connection to keep a session in, so the registers of a
+ * client (see Registers.h) are found by its address and port in a table split in
+ * sets of REGISTER_WAYS clients. A client silent for longer than the time to
+ * live starts again from $1, and a full set gives the entry of the client silent
+ * for the longest time to a new one. A lost or repeated datagram shifts the
+ * numbering, so the clients read it from a reference such as "$last" rather than
+ * counting their requests.
+ */
+
+#define REGISTER_WAYS 4         // Clients of a set, looked up together
+#define REGISTER_TTL 300        // Default seconds after which the registers of a silent client are dropped
+
+/**
+ * @brief Allocates the table of the registers.
+ *
+ * Until it is called, or when it is called with 0 clients, no client has registers.
+ *
+ * @param clients The clients the table can hold, rounded up to a power of two sets.
+ * @param ttl The seconds after which the registers of a silent client are dropped.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ */
+int createRegisterTable(int clients, int ttl);
+
+/**
+ * @brief Finds the registers of a client, or gives it empty ones, and locks them.
+ *
+ * @param address The address of the client.
+ * @return The registers, to be released with releaseRegisters(), NULL if the table is disabled.
+ */
+struct Registers *acquireRegisters(const struct sockaddr_in *address);
+
+/**
+ * @brief Unlocks the registers returned by acquireRegisters().
+ *
+ * @param address The address of the client.
+ */
+void releaseRegisters(const struct sockaddr_in *address);
+
+#endif /* SERVER_REGISTERTABLE_H_ */
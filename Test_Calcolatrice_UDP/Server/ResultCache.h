@@ -0,0 +1,88 @@
+#ifndef SERVER_RESULTCACHE_H_
+#define SERVER_RESULTCACHE_H_
+
+/**
+ * @file ResultCache.h
+ * @brief Header file for the cache of the replies to repeated requests.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The replies are kept by the request they answer, normalized by trimming the
+ * whitespace and turning every run of it into a single space, so "/ 1  3" finds
+ * the reply of "/ 1 3". The cache is split in sets of CACHE_WAYS entries chosen by
+ * the hash of the request, each with its own lock and its own CLOCK hand: threads
+ * only contend when they look up the same set, and a full set replaces the first
+ * entry not used since the hand last passed over it.
+ */
+
+#include <stdint.h>     // Fixed width integers
+
+#define CACHE_WAYS 8            // Entries of a set, looked up together
+#define CACHE_KEY 64            // Longest normalized request that is cached
+#define CACHE_REPLY 64          // Longest reply that is cached, terminator included
+#define CACHE_REPORT 65536      // Lookups of a thread between two logs of the counters
+
+/**
+ * @brief A normalized request and its hash.
+ */
+struct CacheKey {
+    uint64_t hash;              // FNV-1a hash of the text
+    int length;                 // Characters of the text
+    int exact;                  // 1 if only the whitespace around the request was removed
+    char text[CACHE_KEY];       // Normalized request, not terminated
+};
+
+/**
+ * @brief Allocates the cache.
+ *
+ * Until it is called, or when it is called with 0 entries, every lookup misses
+ * and nothing is stored. The counters are logged when the program exits.
+ *
+ * @param entries The entries the cache can hold, rounded up to a power of two sets.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ */
+int createResultCache(int entries);
+
+/**
+ * @brief Normalizes a request into the key of its reply.
+ *
+ * @param msg The request.
+ * @param length The characters of the request.
+ * @param key Receives the normalized request.
+ * @return 0 on success, -1 if the cache is disabled or the request is too long.
+ */
+int makeCacheKey(const char *msg, int length, struct CacheKey *key);
+
+/**
+ * @brief Copies the reply cached for a request.
+ *
+ * @param key The normalized request.
+ * @param reply Receives the terminated reply.
+ * @return The length of the reply, -1 if it is not cached.
+ */
+int lookupResult(const struct CacheKey *key, char *reply);
+
+/**
+ * @brief Caches the reply to a request, replacing an entry of its set if it is full.
+ *
+ * Replies of CACHE_REPLY characters or more are not cached.
+ *
+ * @param key The normalized request.
+ * @param reply The terminated reply.
+ */
+void storeResult(const struct CacheKey *key, const char *reply);
+
+/**
+ * @brief Reads the counters of the cache.
+ *
+ * @param hits Receives the lookups that found a reply.
+ * @param misses Receives the lookups that did not.
+ */
+void getResultCacheStats(unsigned long long *hits, unsigned long long *misses);
+
+/**
+ * @brief Writes the counters of the cache to the log.
+ */
+void logResultCacheStats(void);
+
+#endif /* SERVER_RESULTCACHE_H_ */
@@ -0,0 +1,126 @@
+#define _GNU_SOURCE     // pthread_setaffinity_np()
+
+#include "Headers.h"
+#include "Server.h"
+#include "Log.h"
+#include "ReusePort.h"
+
+#include <linux/filter.h>   // Classic BPF programs
+#include <pthread.h>        // POSIX threads
+#include <sched.h>          // CPU sets
+
+/**
+ * @file ReusePort.c
+ * @brief Implementation file for the SO_REUSEPORT sharded mode of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+/**
+ * @brief A datagram socket with its own thread.
+ */
+struct Shard {
+    int socket;     // Datagram socket of the shard
+    int cpu;        // CPU the thread is pinned to, -1 if not pinned
+};
+
+static int attachSteeringProgram(int my_socket, int shards);
+static void *shardMain(void *shard);
+
+/**
+ * @brief Serves the clients with independent sockets sharing the server port.
+ *
+ * The sockets are created and bound in order before any thread starts, so the index
+ * of a socket inside the reuseport group is the index of its shard.
+ *
+ * @param shards The number of sockets to bind (1..MAXSHARDS).
+ * @param pinThreads 1 to pin the thread of shard i to CPU i, 0 otherwise.
+ * @param steering 1 to attach a BPF program that keeps a flow on the receiving CPU.
+ * @return -1 if the shards cannot be started.
+ */
+int runReusePortShards(int shards, int pinThreads, int steering) {
+    char msgLog[BUFFERSIZE];
+    static struct Shard list[MAXSHARDS];
+    pthread_t threads[MAXSHARDS];
+    int cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    struct sockaddr_in sad;
+
+    if (shards < 1 || shards > MAXSHARDS) {
+        errorhandler("Invalid number of shards.");
+        return -1;
+    }
+
+    for (int i = 0; i < shards; i++) {
+        list[i].socket = createSocket(-1);
+        if (list[i].socket < 0 || enableReusePort(list[i].socket) < 0) {
+            errorhandler("setsockopt(SO_REUSEPORT) failed.");
+            return -1;
+        }
+        sad = bindSocket(list[i].socket, sad, PROTO_ADDR, PROTOPORT);
+        list[i].cpu = pinThreads ? i % cpus : -1;
+    }
+
+    if (steering && attachSteeringProgram(list[0].socket, shards) < 0) {
+        errorhandler("setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed, using the kernel hash.");
+    }
+
+    for (int i = 0; i < shards; i++) {
+        if (pthread_create(&threads[i], NULL, shardMain, &list[i]) != 0) {
+            errorhandler("pthread_create() failed.");
+            return -1;
+        }
+    }
+
+    snprintf(msgLog, sizeof(msgLog), "Started %d reuseport shards%s%s.", shards,
+             pinThreads ? ", pinned" : "", steering ? ", CPU steering" : "");
+    LOG_MESSAGE(LOG_LEVEL_INFO, msgLog);
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Searching for a client...");
+
+    for (int i = 0; i < shards; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return -1;
+}
+
+/**
+ * @brief Attaches to the reuseport group a program choosing the socket by CPU.
+ *
+ * The program returns "current CPU % shards", so a datagram is queued on the socket
+ * whose thread is pinned to the CPU that received it.
+ *
+ * @param my_socket Any socket of the reuseport group.
+ * @param shards The number of sockets in the group.
+ * @return 0 on success, -1 on failure.
+ */
+static int attachSteeringProgram(int my_socket, int shards) {
+    struct sock_filter code[] = {
+            { BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU },   // A = current CPU
+            { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (unsigned) shards },        // A = A % shards
+            { BPF_RET | BPF_A, 0, 0, 0 }                                   // Socket index = A
+    };
+    struct sock_fprog program = { sizeof(code) / sizeof(code[0]), code };
+
+    return setsockopt(my_socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program));
+}
+
+/**
+ * @brief Body of a shard thread: pins itself if requested and serves its socket.
+ *
+ * @param shard The shard served by the thread.
+ * @return Always NULL.
+ */
+static void *shardMain(void *shard) {
+    struct Shard *self = shard;
+
+    if (self->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(self->cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            errorhandler("pthread_setaffinity_np() failed.");
+        }
+    }
+
+    serveDatagrams(self->socket);
+    return NULL;
+}
@@ -0,0 +1,26 @@
+#ifndef SERVER_REUSEPORT_H_
+#define SERVER_REUSEPORT_H_
+
+/**
+ * @file ReusePort.h
+ * @brief Header file for the SO_REUSEPORT sharded mode of the server.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define MAXSHARDS 256           // Maximum number of datagram sockets
+
+/**
+ * @brief Serves the clients with independent sockets sharing the server port.
+ *
+ * Every shard owns a datagram socket bound with SO_REUSEPORT and a thread running
+ * serveDatagrams() on it, so the kernel spreads the flows with no shared lock.
+ *
+ * @param shards The number of sockets to bind (1..MAXSHARDS).
+ * @param pinThreads 1 to pin the thread of shard i to CPU i, 0 otherwise.
+ * @param steering 1 to attach a BPF program that keeps a flow on the receiving CPU.
+ * @return -1 if the shards cannot be started.
+ */
+int runReusePortShards(int shards, int pinThreads, int steering);
+
+#endif /* SERVER_REUSEPORT_H_ */
@@ -0,0 +1,297 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Scanner.h"
+#include "Number.h"
+
+/**
+ * @file Scanner.c
+ * @brief Implementation file for the single-pass scanner of the text requests.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ */
+
+#define MAXDIGITS 19            // Significant digits that always fit in a uint64_t
+
+static int isSpace(char c);
+static int endsToken(char c);
+static int isDigit(char c);
+static int classifyInteger(const char *text, int length, int64_t *value);
+static double convertSlowly(const char *text, int length);
+
+/**
+ * @brief Starts scanning a view.
+ *
+ * @param scanner The scanner.
+ * @param text The first character of the view.
+ * @param length The number of characters of the view.
+ */
+void initScanner(struct Scanner *scanner, const char *text, int length) {
+    scanner->text = text;
+    scanner->length = length;
+    scanner->position = 0;
+}
+
+/**
+ * @brief Moves past any whitespace.
+ *
+ * A '\0' in the view ends the text like the end of the view.
+ *
+ * @param scanner The scanner.
+ * @return The next character, '\0' at the end of the text.
+ */
+char skipSpaces(struct Scanner *scanner) {
+    while (scanner->position < scanner->length && isSpace(scanner->text[scanner->position])) {
+        scanner->position++;
+    }
+    return scanner->position < scanner->length ? scanner->text[scanner->position] : '\0';
+}
+
+/**
+ * @brief Reads an operation up to the end of the view or the next BATCH_SEPARATOR.
+ *
+ * @param scanner The scanner.
+ * @param operation Receives the operator and the operands.
+ * @return CALC_OK, CALC_INVALID_OPERAND or CALC_TOO_MANY_OPERANDS.
+ */
+int parseOperation(struct Scanner *scanner, struct Operation *operation) {
+    const char *text = scanner->text;
+    int length = scanner->length;
+
+    operation->numOperands = 0;
+    operation->errorPosition = 0;
+    operation->errorLength = 0;
+    operation->integer = 0;
+    operation->wide = 0;
+
+    char c = skipSpaces(scanner);
+    if (c == '\0' || c == BATCH_SEPARATOR) {
+        operation->operator = '\0'; // calculate() reports the missing operands
+        return CALC_OK;
+    }
+    operation->operator = c;
+    scanner->position++;
+    operation->operandsPosition = scanner->position;
+
+    int integers = 1;           // 1 while every operand is an integer
+    int outside = 0;            // 1 once an integer does not fit in 64 bits
+    while ((c = skipSpaces(scanner)) != '\0' && c != BATCH_SEPARATOR) {
+        int start = scanner->position;
+        double value;
+        int used = scanNumber(text + start, length - start, &value);
+
+        // A number must be followed by a space, a separator or the end of the text
+        int end = start + used;
+        if (used == 0 || (end < length && !endsToken(text[end]))) {
+            while (end < length && !endsToken(text[end])) {
+                end++;
+            }
+            operation->errorPosition = start;
+            operation->errorLength = end - start;
+            return CALC_INVALID_OPERAND;
+        }
+        if (operation->numOperands == MAXOPERANDS) {
+            operation->errorPosition = start;
+            operation->errorLength = used;
+            return CALC_TOO_MANY_OPERANDS;
+        }
+
+        int kind = classifyInteger(text + start, used, &operation->integers[operation->numOperands]);
+        integers &= kind >= 0;
+        outside |= kind > 0;
+        operation->operands[operation->numOperands++] = value;
+        scanner->position = end;
+    }
+    operation->integer = integers && !outside;
+    operation->wide = integers && outside;
+    return CALC_OK;
+}
+
+/**
+ * @brief Moves past the current operation and the BATCH_SEPARATOR that ends it.
+ *
+ * @param scanner The scanner.
+ */
+void skipOperation(struct Scanner *scanner) {
+    while (scanner->position < scanner->length && scanner->text[scanner->position] != BATCH_SEPARATOR
+           && scanner->text[scanner->position] != '\0') {
+        scanner->position++;
+    }
+    if (scanner->position < scanner->length) {
+        scanner->position++;
+    }
+}
+
+/**
+ * @brief Reads a decimal number at the start of a view.
+ *
+ * Up to MAXDIGITS significant digits are kept in an integer and converted by
+ * decimalToDouble(). Longer numbers are converted the same way when their first
+ * MAXDIGITS digits and those digits plus one give the same double; the rare
+ * others are handed to strtod() once their extent is known.
+ *
+ * @param text The first character of the view.
+ * @param length The number of characters of the view.
+ * @param value Receives the value of the number.
+ * @return The number of characters of the number, 0 if the view does not start with one.
+ */
+int scanNumber(const char *text, int length, double *value) {
+    int i = 0;
+    int negative = 0;
+    uint64_t mantissa = 0;
+    int digits = 0;             // Significant digits kept in the mantissa
+    int exponent = 0;           // Power of ten the mantissa is scaled by
+    int seen = 0;               // Digits read, significant or not
+    int truncated = 0;          // 1 if a non-zero digit did not fit in the mantissa
+
+    if (i < length && (text[i] == '+' || text[i] == '-')) {
+        negative = text[i] == '-';
+        i++;
+    }
+
+    for (; i < length && isDigit(text[i]); i++, seen++) {
+        if (digits < MAXDIGITS) {
+            mantissa = mantissa * 10 + (uint64_t) (text[i] - '0');
+            digits += mantissa != 0;
+        } else {
+            exponent++; // Digits past the precision only scale the value
+            truncated |= text[i] != '0';
+        }
+    }
+    if (i < length && text[i] == '.') {
+        int point = i++;
+        for (; i < length && isDigit(text[i]); i++, seen++) {
+            if (digits < MAXDIGITS) {
+                mantissa = mantissa * 10 + (uint64_t) (text[i] - '0');
+                digits += mantissa != 0;
+                exponent--;
+            } else {
+                truncated |= text[i] != '0';
+            }
+        }
+        if (seen == 0) {
+            i = point; // A lone point is not a number
+        }
+    }
+    if (seen == 0) {
+        return 0;
+    }
+
+    if (i < length && (text[i] == 'e' || text[i] == 'E')) {
+        int j = i + 1;
+        int exponentSign = 1;
+        int written = 0;
+
+        if (j < length && (text[j] == '+' || text[j] == '-')) {
+            exponentSign = text[j] == '-' ? -1 : 1;
+            j++;
+        }
+        if (j < length && isDigit(text[j])) {
+            for (; j < length && isDigit(text[j]); j++) {
+                if (written < 10000) {
+                    written = written * 10 + (text[j] - '0');
+                }
+            }
+            exponent += exponentSign * written;
+            i = j;
+        }
+    }
+
+    double result, above;
+    if (decimalToDouble(mantissa, exponent, &result) < 0
+        || (truncated && (decimalToDouble(mantissa + 1, exponent, &above) < 0 || above != result))) {
+        result = convertSlowly(text, i);
+    }
+    *value = negative ? -result : result;
+    return i;
+}
+
+/**
+ * @brief Tells whether a character separates the tokens.
+ *
+ * @param c The character.
+ * @return 1 for a space, a tab, a line or page break, 0 otherwise.
+ */
+static int isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Tells whether a character ends a token.
+ *
+ * @param c The character.
+ * @return 1 for a space, a BATCH_SEPARATOR or a terminator, 0 otherwise.
+ */
+static int endsToken(char c) {
+    return isSpace(c) || c == BATCH_SEPARATOR || c == '\0';
+}
+
+/**
+ * @brief Tells whether a character is a decimal digit.
+ *
+ * @param c The character.
+ * @return 1 for '0' to '9', 0 otherwise.
+ */
+static int isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Tells whether a number is an integer and whether it fits in an int64_t.
+ *
+ * @param text The first character of the number.
+ * @param length The number of characters of the number.
+ * @param value Receives the integer when it fits.
+ * @return -1 if the number has a point or an exponent, 1 if it is an integer
+ *         outside the range of an int64_t, 0 if it is one inside.
+ */
+static int classifyInteger(const char *text, int length, int64_t *value) {
+    int i = 0;
+    int negative = 0;
+    uint64_t magnitude = 0;
+
+    if (text[0] == '+' || text[0] == '-') {
+        negative = text[0] == '-';
+        i++;
+    }
+    while (i < length && text[i] == '0') {
+        i++;
+    }
+    int first = i;
+    for (; i < length; i++) {
+        if (!isDigit(text[i])) {
+            return -1;
+        }
+        magnitude = magnitude * 10 + (uint64_t) (text[i] - '0'); // Wraps only past 19 digits
+    }
+    if (length - first > 19 || (length - first == 19
+        && memcmp(text + first, negative ? "9223372036854775808" : "9223372036854775807", 19) > 0)) {
+        return 1;
+    }
+    *value = (int64_t) (negative ? 0 - magnitude : magnitude);
+    return 0;
+}
+
+/**
+ * @brief Converts a number the fast path cannot round correctly.
+ *
+ * The view is copied on the stack because it is not terminated; the number has
+ * already been validated, so strtod() reads all of it.
+ *
+ * @param text The first character of the number.
+ * @param length The number of characters of the number.
+ * @return The nearest double, without the sign.
+ */
+static double convertSlowly(const char *text, int length) {
+    char number[BUFFERSIZE];
+
+    if (text[0] == '+' || text[0] == '-') {
+        text++;
+        length--;
+    }
+    if (length >= BUFFERSIZE) {
+        length = BUFFERSIZE - 1;
+    }
+    memcpy(number, text, length);
+    number[length] = '\0';
+    return strtod(number, NULL);
+}
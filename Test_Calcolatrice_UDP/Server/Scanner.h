@@ -0,0 +1,92 @@
+#ifndef SERVER_SCANNER_H_
+#define SERVER_SCANNER_H_
+
+/**
+ * @file Scanner.h
+ * @brief Header file for the single-pass scanner of the text requests.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * The scanner reads a (pointer, length) view, so it runs directly on a receive
+ * buffer: it never writes to the text, never needs a terminator (a '\0' ends the
+ * text too) and keeps all its state in the caller's struct Scanner. Any whitespace separates the tokens and
+ * numbers are read without the C library, so the locale does not matter:
+ *
+ *     operation: [space] operator [space] operand { space operand } [space]
+ *     operand:   [+|-] digits [. digits] [e|E [+|-] digits]  (or . digits)
+ */
+
+#include <stdint.h>     // Fixed width integers
+
+/**
+ * @brief A view over the text of a request and the position reached in it.
+ */
+struct Scanner {
+    const char *text;   // First character of the view
+    int length;         // Number of characters of the view
+    int position;       // Offset of the next character to read
+};
+
+/**
+ * @brief An operation read by parseOperation().
+ */
+struct Operation {
+    char operator;                  // Operator of the operation, '\0' if there is none
+    int numOperands;                // Number of operands read
+    double operands[MAXOPERANDS];   // Values of the operands
+    int operandsPosition;           // Offset in the view of the first operand
+    int64_t integers[MAXOPERANDS];  // Exact values of the operands when integer is set
+    int integer;                    // 1 if the operands are integers that all fit in 64 bits
+    int64_t integerResult;          // Exact result, when integer is still set after the evaluation
+    int wide;                       // 1 if the operands are integers and one does not fit in 64 bits
+    int errorPosition;              // Offset in the view of the token that was rejected
+    int errorLength;                // Length of the rejected token
+};
+
+/**
+ * @brief Starts scanning a view.
+ *
+ * @param scanner The scanner.
+ * @param text The first character of the view.
+ * @param length The number of characters of the view.
+ */
+void initScanner(struct Scanner *scanner, const char *text, int length);
+
+/**
+ * @brief Moves past any whitespace.
+ *
+ * @param scanner The scanner.
+ * @return The next character, '\0' at the end of the text.
+ */
+char skipSpaces(struct Scanner *scanner);
+
+/**
+ * @brief Reads an operation up to the end of the view or the next BATCH_SEPARATOR.
+ *
+ * The separator is not consumed. On an error the scanner stops at the rejected
+ * token, whose position is stored in the operation.
+ *
+ * @param scanner The scanner.
+ * @param operation Receives the operator and the operands.
+ * @return CALC_OK, CALC_INVALID_OPERAND or CALC_TOO_MANY_OPERANDS.
+ */
+int parseOperation(struct Scanner *scanner, struct Operation *operation);
+
+/**
+ * @brief Moves past the current operation and the BATCH_SEPARATOR that ends it.
+ *
+ * @param scanner The scanner.
+ */
+void skipOperation(struct Scanner *scanner);
+
+/**
+ * @brief Reads a decimal number at the start of a view.
+ *
+ * @param text The first character of the view.
+ * @param length The number of characters of the view.
+ * @param value Receives the value of the number.
+ * @return The number of characters of the number, 0 if the view does not start with one.
+ */
+int scanNumber(const char *text, int length, double *value);
+
+#endif /* SERVER_SCANNER_H_ */
@@ -1,6 +1,21 @@
 #include "Headers.h"
 #include "Server.h"
 #include "Calculator.h"
+#include "Binary.h"
+#include "Statistics.h"
+#include "Scanner.h"
+#include "Expression.h"
+#include "Number.h"
+#include "BigInt.h"
+#include "ResultCache.h"
+#include "Registers.h"
+#include "RegisterTable.h"
+#include "Log.h"
+#if defined __linux__
+#include "ReusePort.h"
+#endif
+
+static int resultPrecision = RESULT_PRECISION; // Decimals of the results in the text replies
 
 /**
  * @file Server.c
@@ -16,6 +31,7 @@
  * creates a socket, binds it to the specified address and port, and then enters
  * a loop to receive and process data from clients. It processes each client request,
  * logs the operations, and sends back the processed data to the client.
+ * With "--reuseport[=N]" N threads serve N sockets bound to the same port instead.
  *
  * @param argc The number of command-line arguments.
  * @param argv An array of strings containing the command-line arguments.
@@ -23,56 +39,193 @@
  */
 int main(int argc, char *argv[]) {
     printf("Look at the log file!\n\n");
+    struct ServerOptions options;
+    parseOptions(argc, argv, &options);
+    setLogLevel(options.logLevel, options.logSampling);
+    resultPrecision = options.precision;
+    setLogSegments(options.logSegments, options.logSegmentSize);
+    openLog();
+    if (createResultCache(options.cacheEntries) != 0) {
+        LOG_MESSAGE(LOG_LEVEL_WARN, "The result cache cannot be allocated, requests are computed every time.");
+    }
+    if (createRegisterTable(options.registerClients, options.registerTtl) != 0) {
+        LOG_MESSAGE(LOG_LEVEL_WARN, "The register table cannot be allocated, the clients keep no registers.");
+    }
+
     // 0) Initialize the WSA library in case we are on Windows
     checkWindowDevice();
 
+#if defined __linux__
+    if (options.mode == MODE_REUSEPORT) {
+        // 1-6) Every shard creates and binds its own socket and serves it
+        return runReusePortShards(options.shards, options.pinThreads, options.steering);
+    }
+#endif
+
     // 1) Create a socket
     int my_socket = -1;
     my_socket = createSocket(my_socket);
-    sprintf(msgLog,"Server socket created successfully!");
-    writeLog(msgLog);
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Server socket created successfully!");
 
     // 2) Bind the socket
     struct sockaddr_in sad = bindSocket(my_socket, sad, PROTO_ADDR, PROTOPORT);
-    sprintf(msgLog,"Server socket binded successfully!");
-    writeLog(msgLog);
-    struct sockaddr_in cad;	// Structure for the client's address
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Server socket binded successfully!");
+
+    LOG_MESSAGE(LOG_LEVEL_INFO, "Searching for a client...");
+
+    return serveDatagrams(my_socket);
+}
 
-    sprintf(msgLog,"Searching for a client...");
-    writeLog(msgLog);
+/**
+ * @brief Parses the command line into the server options.
+ *
+ * "--reuseport[=N]" binds N sockets to the server port with SO_REUSEPORT, each served
+ * by its own thread (one per online CPU if N is omitted). "--pin" pins those threads
+ * to the CPUs and "--steer" keeps the datagrams of a flow on the receiving CPU.
+ * "--log-level=L" keeps the messages up to level L (error, warn, info, debug, trace)
+ * and "--log-sample=N" logs 1 request in N; only trace echoes the requests on stdout.
+ * "--log-segments=N" keeps the log in N rotating segments of "--log-segment-size=M" MiB.
+ * "--precision=N" writes the results with N decimals (0 to NUMBER_MAXPRECISION),
+ * "--precision=shortest" with the fewest digits that read back to the same double.
+ * "--cache=N" keeps the replies to the last N distinct requests and answers the
+ * repeated ones without computing them. "--registers=N" keeps the results of up to
+ * N clients, which their requests can use as "$1" or "$last", and drops those of a
+ * client silent for "--register-ttl=S" seconds.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @param options The options to fill (a single socket by default).
+ */
+void parseOptions(int argc, char *argv[], struct ServerOptions *options) {
+    options->mode = MODE_SINGLE;
+    options->shards = 1;
+    options->pinThreads = 0;
+    options->steering = 0;
+    options->logLevel = LOG_LEVEL_DEBUG;
+    options->logSampling = 1;
+    options->precision = RESULT_PRECISION;
+    options->logSegments = 0;
+    options->logSegmentSize = LOG_SEGMENT_SIZE;
+    options->cacheEntries = 0;
+    options->registerClients = 0;
+    options->registerTtl = REGISTER_TTL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--log-level=", 12) == 0 && parseLogLevel(argv[i] + 12) >= 0) {
+            options->logLevel = parseLogLevel(argv[i] + 12);
+        } else if (strncmp(argv[i], "--log-sample=", 13) == 0) {
+            options->logSampling = atoi(argv[i] + 13);
+        } else if (strcmp(argv[i], "--precision=shortest") == 0) {
+            options->precision = NUMBER_SHORTEST;
+        } else if (strncmp(argv[i], "--precision=", 12) == 0) {
+            options->precision = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--cache=", 8) == 0) {
+            options->cacheEntries = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--registers=", 12) == 0) {
+            options->registerClients = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--register-ttl=", 15) == 0) {
+            options->registerTtl = atoi(argv[i] + 15);
+        } else
+#if defined __linux__
+        if (strcmp(argv[i], "--reuseport") == 0) {
+            options->mode = MODE_REUSEPORT;
+            options->shards = (int) sysconf(_SC_NPROCESSORS_ONLN);
+        } else if (strncmp(argv[i], "--reuseport=", 12) == 0) {
+            options->mode = MODE_REUSEPORT;
+            options->shards = atoi(argv[i] + 12);
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            options->pinThreads = 1;
+        } else if (strcmp(argv[i], "--steer") == 0) {
+            options->steering = 1;
+        } else if (strncmp(argv[i], "--log-segments=", 15) == 0) {
+            options->logSegments = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--log-segment-size=", 19) == 0) {
+            options->logSegmentSize = atoi(argv[i] + 19);
+        } else
+#endif
+        {
+            printf("Unknown or unsupported option: %s\n", argv[i]);
+        }
+    }
+
+    if (options->shards < 1) {
+        options->shards = 1;
+    }
+    if (options->precision < NUMBER_SHORTEST || options->precision > NUMBER_MAXPRECISION) {
+        options->precision = RESULT_PRECISION;
+    }
+}
+
+/**
+ * @brief Receives, processes and answers the datagrams arriving on a socket.
+ *
+ * The message buffers live on the stack of the calling thread, so several threads
+ * can serve different sockets at the same time.
+ *
+ * @param my_socket The bound datagram socket.
+ * @return The exit status when the socket can no longer be used.
+ */
+int serveDatagrams(int my_socket) {
+    char msg[BUFFERSIZE];      // Message Array
+    char msgLog[BUFFERSIZE + NI_MAXHOST + INET_ADDRSTRLEN + 64]; // Message Log: request, name and address of the client
+    char hostName[NI_MAXHOST]; // Name of the client
+    char hostAddress[INET_ADDRSTRLEN]; // IP address of the client
+    struct sockaddr_in cad;	// Structure for the client's address
 
     while(1) {
         // Receive and process data from the client until the client sends "="
         socklen_t client_len = sizeof(cad); // Set the client's size
         memset(msg, 0, BUFFERSIZE); // clean msg
         // 3) receive data
-        int bytes_received = recvfrom(my_socket, msg, BUFFERSIZE, 0, (struct sockaddr*) &cad, &client_len);
+        int bytes_received = recvfrom(my_socket, msg, BUFFERSIZE - 1, 0, (struct sockaddr*) &cad, &client_len);
 
         // check the received data length
         if (bytes_received <= 0) {
             if (bytes_received == 0) {
-                sprintf(msgLog,"Client has closed the connection.");
-                writeLog(msgLog);
+                LOG_MESSAGE(LOG_LEVEL_INFO, "Client has closed the connection.");
             } else {
                 errorhandler("recvfrom() failed or connection closed prematurely");
             }
         } else {
-            // 4) Convert the address to the associated DNS
-            struct hostent *he;
-            he = gethostbyaddr((char *)&(cad.sin_addr), sizeof(struct in_addr), AF_INET);
-            if (he == NULL) {
-                errorhandler("gethostbyaddr() failed");
-                closesocket(my_socket);
-                clearwinsock();
-                return -1;
+            // 4) Convert the address to the associated DNS (getnameinfo() is thread-safe),
+            // only for the requests that are logged
+            int logged = LOG_SAMPLED(LOG_LEVEL_DEBUG);
+            if (logged) {
+                if (getnameinfo((struct sockaddr*) &cad, client_len, hostName, sizeof(hostName), NULL, 0, NI_NAMEREQD) != 0) {
+                    errorhandler("getnameinfo() failed");
+                    closesocket(my_socket);
+                    clearwinsock();
+                    return -1;
+                }
+                inet_ntop(AF_INET, &cad.sin_addr, hostAddress, sizeof(hostAddress));
             }
 
-            sprintf(msgLog,"Request operation '%s' from client %s, IP %s", msg, he->h_name, inet_ntoa(cad.sin_addr));
-            writeLog(msgLog);
-            printf("%s\n",msgLog);
+            const unsigned char *header = (const unsigned char*) msg;
+            if (bytes_received >= FRAME_HEADERSIZE && header[0] == FRAME_MAGIC
+                && header[1] >= FRAME_BINARY && header[1] <= FRAME_LINEAR) {
+                serveBinary(my_socket, msg, bytes_received, &cad, client_len);
+                if (logged && header[1] == FRAME_BINARY) {
+                    snprintf(msgLog, sizeof(msgLog), "Request of %d binary operations from client %s, IP %s",
+                             (bytes_received - FRAME_HEADERSIZE) / BINARY_REQUESTSIZE, hostName, hostAddress);
+                    writeLog(msgLog);
+                }
+                continue;
+            }
+
+            if (logged) {
+                snprintf(msgLog, sizeof(msgLog), "Request operation '%s' from client %s, IP %s", msg, hostName, hostAddress);
+                writeLog(msgLog);
+                if (LOG_ENABLED(LOG_LEVEL_TRACE)) {
+                    printf("%s\n",msgLog);
+                }
+            }
 
             // 5) Process data according to the logic defined in the function
-            processData(msg);
+            struct Registers *registers = acquireRegisters(&cad);
+            processData(msg, bytes_received, registers);
+            if (registers != NULL) {
+                releaseRegisters(&cad);
+            }
 
             // 6) Send processed data back to the client
             if (sendto(my_socket, msg, sizeof(msg), 0, (struct sockaddr*) &cad, client_len) != sizeof(msg)) {
@@ -85,6 +238,56 @@ int main(int argc, char *argv[]) {
     }
 }
 
+/**
+ * @brief Answers a binary, stream or linear datagram with the results of its operations.
+ *
+ * Malformed datagrams are dropped, like the datagrams lost by the network.
+ *
+ * @param my_socket The socket descriptor.
+ * @param datagram The received datagram, header included.
+ * @param length The size of the datagram.
+ * @param cad The address of the client.
+ * @param client_len The size of the address of the client.
+ * @return 0 if the reply was sent, -1 otherwise.
+ */
+int serveBinary(int my_socket, const char *datagram, int length, struct sockaddr_in *cad, int client_len) {
+    char reply[BUFFERSIZE];
+    const unsigned char *header = (const unsigned char*) datagram;
+
+    int payload = (header[2] << 8) | header[3];
+    if (payload != length - FRAME_HEADERSIZE) {
+        errorhandler("Invalid binary datagram received.");
+        return -1;
+    }
+
+    int replyLength;
+    if (header[1] == FRAME_STREAM) {
+        struct Statistics stream;
+        initStatistics(&stream);
+        replyLength = processStream(&stream, datagram + FRAME_HEADERSIZE, payload, reply + FRAME_HEADERSIZE);
+    } else if (header[1] == FRAME_LINEAR) {
+        replyLength = processLinear(datagram + FRAME_HEADERSIZE, payload, reply + FRAME_HEADERSIZE);
+    } else {
+        replyLength = processBinary(datagram + FRAME_HEADERSIZE, payload, reply + FRAME_HEADERSIZE);
+    }
+    if (replyLength < 0) {
+        errorhandler("Invalid binary datagram received.");
+        return -1;
+    }
+
+    reply[0] = (char) FRAME_MAGIC;
+    reply[1] = (char) header[1];
+    reply[2] = (char) ((replyLength >> 8) & 0xFF);
+    reply[3] = (char) (replyLength & 0xFF);
+    replyLength += FRAME_HEADERSIZE;
+
+    if (sendto(my_socket, reply, replyLength, 0, (struct sockaddr*) cad, client_len) != replyLength) {
+        errorhandler("sendto() sent a different number of bytes than expected");
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Initializes the Windows Sockets API (WSA) if on a Windows platform.
  *
@@ -121,7 +324,7 @@ void closeConnection(int c_socket) {
     system("pause");
 #else
     // Unix-like systems command
-    system("clear")
+    system("clear");
     printf("Press any key to close the process...");
     getchar();
 #endif
@@ -177,6 +380,24 @@ struct sockaddr_in bindSocket(int my_socket, struct sockaddr_in sad, const char*
     return sad;
 }
 
+/**
+ * @brief Allows several sockets to bind the server address and port (SO_REUSEPORT).
+ *
+ * All the sockets of the group must set the option before bind(); the kernel then
+ * spreads the incoming datagrams among them by flow.
+ *
+ * @param my_socket The socket descriptor, not bound yet.
+ * @return 0 on success, -1 if the option is not supported.
+ */
+int enableReusePort(int my_socket) {
+#if defined SO_REUSEPORT
+    int on = 1;
+    return setsockopt(my_socket, SOL_SOCKET, SO_REUSEPORT, (const char*) &on, sizeof(on));
+#else
+    return -1;
+#endif
+}
+
 /**
  * @brief Cleanup the Windows Socket API (WSA) resources on Windows systems.
  *
@@ -203,7 +424,7 @@ void clearwinsock() {
  */
 void errorhandler(char *errorMessage) {
     printf("\n%s", errorMessage);
-    writeLog(errorMessage);
+    LOG_MESSAGE(LOG_LEVEL_ERROR, errorMessage);
 }
 
 /**
@@ -215,100 +436,290 @@ void errorhandler(char *errorMessage) {
  * an arithmetic operation encounters an error (e.g., division by zero),
  * appropriate error messages are returned.
  *
+ * With the result cache enabled a repeated request gets the reply stored the first
+ * time. The replies that quote the request are not stored, or are only looked up
+ * when the request has no whitespace the normalization would change.
+ *
+ * With the registers enabled the references to them are replaced first, so the
+ * reply echoes their values, and the result is kept in the next register. Those
+ * requests bypass the cache, whose replies are rounded to the precision of the results.
+ *
  * @param msg The input string containing the operator and operands.
  *            On success, it is updated with the result of the operation.
+ * @param length The number of characters of the message.
+ * @param registers The registers of the client, NULL when the registers are disabled.
  */
-void processData(char *msg) {
-    // Extract the operator and operands from the input string
-    char operator = msg[0];
+void processData(char *msg, int length, struct Registers *registers) {
+    char reply[BUFFERSIZE];
+    struct Scanner scanner;
+    struct Operation operation;
+    struct CacheKey key;
+
+    // Extract the operator and operands from the input string in a single pass
+    initScanner(&scanner, msg, length);
+    char operator = skipSpaces(&scanner);
 
     // Check if the operator is '=' to terminate communication
     if (operator == '=') {
-        char *byeString = "Bye";
-        snprintf(msg, strlen(byeString) + 1, "%s", byeString);
+        strcpy(msg, "Bye");
         return;
     }
 
-    int numOperands = 0;
-    double operands[MAXOPERANDS];
+    // An expression is echoed as it was written, so only its exact text can share a reply
+    int cacheable = registers == NULL && makeCacheKey(msg, length, &key) == 0 && (operator != EXPRESSION_OPERATOR || key.exact);
+    if (cacheable && lookupResult(&key, msg) >= 0) {
+        return;
+    }
 
-    // Tokenize the input string and collect operands
-    char *token = strtok(msg + 2, " ");
-    while (token != NULL && numOperands < MAXOPERANDS) {
-        if (sscanf(token, "%lf", &operands[numOperands]) != 1) {
-            // Error handling: Invalid operand format
-            snprintf(msg, strlen(msg), "Invalid operand format: %s", token);
-            return; // Or handle the error as needed
+    if (operator == BATCH_OPERATOR) {
+        processBatch(msg, length, registers);
+        if (cacheable) {
+            storeResult(&key, msg);
         }
-        numOperands++;
-        token = strtok(NULL, " ");
+        return;
     }
 
-    if (numOperands < 2) {
-        char *insufficientNumberError = "Insufficient number of operands";
-        writeLog(insufficientNumberError);
-        strcpy(msg, insufficientNumberError);
+    if (registers != NULL && memchr(msg, REGISTER_PREFIX, length) != NULL) {
+        int expandedLength, errorPosition;
+        int expanded = expandRegisters(registers, msg, length, reply, &expandedLength, &errorPosition);
+        if (expanded != CALC_OK) {
+            saveRegister(registers, NULL, NULL, expanded, 0);
+            snprintf(msg, BUFFERSIZE, "%s at position %d", expanded == CALC_INVALID_REGISTER
+                     ? "Invalid register" : "Too many operands", errorPosition + 1);
+            return;
+        }
+        memcpy(msg, reply, expandedLength + 1);
+        length = expandedLength;
+        initScanner(&scanner, msg, length);
+        skipSpaces(&scanner);
+    }
+
+    double result;
+    char exact[BUFFERSIZE];
+    int start = scanner.position;
+    int status = evaluateOperation(&scanner, &operation, &result);
+    if (status == CALC_OK && operation.wide) {
+        // Integers past 64 bits are calculated again exactly
+        status = calculateBig(&scanner, &operation, resultPrecision, exact, sizeof(exact));
+    }
+    saveRegister(registers, &scanner, &operation, status, result);
+    switch (status) {
+        case CALC_INVALID_OPERAND:
+            // Error handling: Invalid operand format, reported with its position (from 1)
+            snprintf(reply, sizeof(reply), "Invalid operand format at position %d: %.*s",
+                     operation.errorPosition + 1, operation.errorLength, msg + operation.errorPosition);
+            strcpy(msg, reply);
+            return;
+        case CALC_TOO_MANY_OPERANDS:
+            snprintf(msg, BUFFERSIZE, "Too many operands at position %d", operation.errorPosition + 1);
+            return;
+        case CALC_SYNTAX_ERROR:
+            snprintf(msg, BUFFERSIZE, "Syntax error at position %d", operation.errorPosition + 1);
+            return;
+        case CALC_MISSING_OPERANDS: {
+            char *insufficientNumberError = "Insufficient number of operands";
+            LOG_MESSAGE(LOG_LEVEL_DEBUG, insufficientNumberError);
+            strcpy(msg, insufficientNumberError);
+            break;
+        }
+        case CALC_DIVISION_BY_ZERO: {
+            // Error handling: Division by zero
+            char *divisionError = "|Error| -  Division by Zero";
+            strcpy(msg, divisionError);
+            break;
+        }
+        case CALC_UNKNOWN_OPERATOR:
+            // Error handling: Unknown operator
+            snprintf(msg, BUFFERSIZE, "Unknown operator: %c", operation.operator);
+            break;
+    }
+    if (status != CALC_OK) {
+        if (cacheable) {
+            storeResult(&key, msg);
+        }
         return;
     }
 
-    double result = operands[0];
+    // Echo the operation with its result: "1.00 + 2.00 + 3.00 = 6.00" or "(1 + 2) * 3 = 9.00"
+    char number[BUFFERSIZE];
+    int replyLength = 0;
+    if (operation.operator == EXPRESSION_OPERATOR) {
+        int end = scanner.position;
+        scanner.position = start + 1;
+        start = skipSpaces(&scanner) != '\0' ? scanner.position : end;
+        while (end > start && strchr(" \t\r\n\v\f", msg[end - 1]) != NULL) {
+            end--;
+        }
+        replyLength = appendReply(reply, replyLength, msg + start, end - start);
+    } else {
+        scanner.position = operation.operandsPosition;
+        for (int i = 0; i < operation.numOperands; i++) {
+            if (i > 0) {
+                char separator[] = { ' ', operation.operator, ' ' };
+                replyLength = appendReply(reply, replyLength, separator, sizeof(separator));
+            }
+            if (operation.wide) {
+                // The operands are echoed from their text, a double would round them
+                struct BigInt operand;
+                skipSpaces(&scanner);
+                scanner.position += parseBigInt(msg + scanner.position, length - scanner.position, &operand);
+                formatBigFraction(&operand, NULL, resultPrecision, number, BUFFERSIZE);
+            } else if (operation.integer) {
+                formatInteger(number, BUFFERSIZE, operation.integers[i], resultPrecision);
+            } else {
+                formatNumber(number, BUFFERSIZE, operation.operands[i], resultPrecision);
+            }
+            replyLength = appendReply(reply, replyLength, number, (int) strlen(number));
+        }
+    }
+    replyLength = appendReply(reply, replyLength, " = ", 3);
+    if (operation.wide) {
+        strcpy(number, exact);
+    } else if (operation.integer) {
+        formatInteger(number, BUFFERSIZE, operation.integerResult, resultPrecision);
+    } else {
+        formatNumber(number, BUFFERSIZE, result, resultPrecision);
+    }
+    appendReply(reply, replyLength, number, (int) strlen(number));
+    strcpy(msg, reply);
+    if (cacheable) {
+        storeResult(&key, msg);
+    }
+}
+
+/**
+ * @brief Appends text to a reply, truncating it to BUFFERSIZE - 1 characters.
+ *
+ * @param reply The reply, a buffer of BUFFERSIZE bytes.
+ * @param length The length of the reply.
+ * @param text The text to append.
+ * @param textLength The length of the text.
+ * @return The new length of the reply, which stays terminated.
+ */
+int appendReply(char *reply, int length, const char *text, int textLength) {
+    if (textLength > BUFFERSIZE - 1 - length) {
+        textLength = BUFFERSIZE - 1 - length;
+    }
+    memcpy(reply + length, text, textLength);
+    reply[length + textLength] = '\0';
+    return length + textLength;
+}
+
+/**
+ * @brief Applies an operator to the operands from left to right.
+ *
+ * @param operator The operator, one of + - * /.
+ * @param operands The operands.
+ * @param numOperands The number of operands.
+ * @param result Receives the result when the calculation succeeds.
+ * @return CALC_OK on success, otherwise the CALC_ error code.
+ */
+int calculate(char operator, const double *operands, int numOperands, double *result) {
+    if (numOperands < 2) {
+        return CALC_MISSING_OPERANDS;
+    }
+
+    double value = operands[0];
     for (int i = 1; i < numOperands; i++) {
         switch (operator) {
             case '+':
-                result = add(result, operands[i]);
+                value = add(value, operands[i]);
                 break;
             case '-':
-                result = sub(result, operands[i]);
+                value = sub(value, operands[i]);
                 break;
             case '*':
-                result = mult(result, operands[i]);
+                value = mult(value, operands[i]);
                 break;
             case '/':
-                if (operands[i] != 0) {
-                    result = division(result, operands[i]);
-                } else {
-                    // Error handling: Division by zero
-                    char *divisionError = "|Error| -  Division by Zero";
-                    strcpy(msg, divisionError);
-                    return;
+                if (operands[i] == 0) {
+                    return CALC_DIVISION_BY_ZERO;
                 }
+                value = division(value, operands[i]);
                 break;
             default:
-                // Error handling: Unknown operator
-                snprintf(msg, BUFFERSIZE, "Unknown operator: %c", operator);
-                return;
+                return CALC_UNKNOWN_OPERATOR;
         }
     }
 
-    // Convert the result to a string and update the input string
-    sprintf(msg, "%.2f %c %.2f = %.2f", operands[0], operator, operands[1], result);
+    *result = value;
+    return CALC_OK;
 }
 
 /**
- * @brief Write a log message to a file.
+ * @brief Evaluates a batch request and replaces it with the results of its operations.
+ *
+ * The operations are evaluated in order and written into the reply while it has
+ * room; once it is full the reply ends with the CALC_REPLY_FULL code, and the client
+ * resends the operations that were not answered.
  *
- * This function opens a log file ("Log.txt") and appends a log message
- * along with a timestamp to the file. If the file cannot be opened,
- * an error message is printed to the console.
+ * With the registers enabled every operation is numbered, and its references to the
+ * registers are replaced just before it is evaluated, so it can use the results of
+ * the operations before it in the same batch.
  *
- * @param message The log message to be written to the file.
+ * @param msg The batch request, starting with BATCH_OPERATOR.
+ * @param length The number of characters of the request.
+ * @param registers The registers of the client, NULL when the registers are disabled.
  */
-void writeLog(const char* message) {
-    FILE* file = fopen("Log.txt", "a");
+void processBatch(char *msg, int length, struct Registers *registers) {
+    char reply[BUFFERSIZE];
+    char item[BUFFERSIZE];
+    char expanded[BUFFERSIZE];
+    int replyLength = 0;
+    const char separators[] = { BATCH_SEPARATOR, '\0' };
+    struct Scanner scanner, expandedScanner;
+    char c;
 
-    if (file != NULL) {
-        time_t timestamp = time(NULL);
-        struct tm* timeInfo = localtime(&timestamp);
+    reply[0] = '\0';
+    initScanner(&scanner, msg, length);
+    skipSpaces(&scanner);
+    scanner.position++; // BATCH_OPERATOR
+    while ((c = skipSpaces(&scanner)) != '\0') {
+        if (c == BATCH_SEPARATOR) {
+            scanner.position++; // Empty operations are skipped
+            continue;
+        }
 
-        // Get current date and time
-        char dateAndTime[20];
-        strftime(dateAndTime, sizeof(dateAndTime), "%H:%M:%S %d/%m/%Y", timeInfo);
+        struct Operation operation;
+        struct Scanner *operationScanner = &scanner;
+        double result = 0;
+        int status = CALC_OK;
+        if (registers != NULL) {
+            int start = scanner.position;
+            int expandedLength, errorPosition;
+            skipOperation(&scanner);
+            status = expandRegisters(registers, msg + start, scanner.position - start, expanded,
+                                     &expandedLength, &errorPosition);
+            initScanner(&expandedScanner, expanded, status == CALC_OK ? expandedLength : 0);
+            operationScanner = &expandedScanner;
+        }
+        if (status == CALC_OK) {
+            status = evaluateOperation(operationScanner, &operation, &result);
+        }
+        if (status == CALC_OK && operation.wide) {
+            status = calculateBig(operationScanner, &operation, resultPrecision, item, sizeof(item));
+        } else if (status == CALC_OK && operation.integer) {
+            formatInteger(item, sizeof(item), operation.integerResult, resultPrecision);
+        } else if (status == CALC_OK) {
+            formatNumber(item, sizeof(item), result, resultPrecision);
+        }
+        if (registers == NULL) {
+            skipOperation(&scanner);
+        }
 
-        // Write the log message to the file
-        fprintf(file, "SERVER - [%s] - %s\n", dateAndTime, message);
+        int itemLength = status == CALC_OK ? (int) strlen(item) : snprintf(item, sizeof(item), "E%d", status);
 
-        fclose(file);
-    } else {
-        printf("Error opening the log file.\n");
+        // Keep room for the separator and the code that marks a full reply
+        if (replyLength + itemLength + 4 > BUFFERSIZE - 1) {
+            snprintf(reply + replyLength, sizeof(reply) - replyLength, "%sE%d",
+                     replyLength > 0 ? separators : "", CALC_REPLY_FULL);
+            break;
+        }
+        // An operation is numbered once it is answered: the client resends the skipped ones
+        saveRegister(registers, operationScanner, status == CALC_OK ? &operation : NULL, status, result);
+        replyLength += snprintf(reply + replyLength, sizeof(reply) - replyLength, "%s%s",
+                                replyLength > 0 ? separators : "", item);
     }
+
+    strcpy(msg, reply);
 }
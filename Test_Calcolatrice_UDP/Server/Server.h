@@ -12,10 +12,66 @@
 #define PROTO_ADDR "127.0.0.1"  // Default Server Address
 #define BUFFERSIZE 256          // Default Buffer Size
 
-#define MAXOPERANDS 2           // Maximum number of operands
+#define MAXOPERANDS 64          // Maximum number of operands, "+ 1 2 3" folds them from the left
+#define RESULT_PRECISION 2      // Decimals of the results in the text replies
 
-char msg[BUFFERSIZE];    // Message Array
-char msgLog[BUFFERSIZE]; // Message Log
+// Binary datagram: the same 4 byte header as the frames of the TCP server (magic,
+// type, 16 bit big-endian payload length) followed by binary operations (see Binary.h).
+// A stream datagram is a stream of its own: its operands are scanned or summarized
+// alone, since a lost datagram would silently change a stream kept across datagrams.
+// Any other datagram is a text request.
+#define FRAME_MAGIC 0xC5        // First byte of a binary datagram, never the first byte of a text request
+#define FRAME_BINARY 0x02       // Type of a binary datagram
+#define FRAME_STREAM 0x03       // Type of a stream datagram (see Binary.h)
+#define FRAME_LINEAR 0x04       // Type of a linear algebra datagram (see Binary.h)
+#define FRAME_HEADERSIZE 4      // Size of the datagram header
+
+// Batch request: "B + 1 2; / 4 0; * 3 5" evaluates every operation and answers with
+// one result per operation, separated by BATCH_SEPARATOR ("3.00;E1;15.00").
+// A failed operation is answered by 'E' followed by its error code.
+#define BATCH_OPERATOR 'B'      // First character of a batch request
+#define BATCH_SEPARATOR ';'     // Separates the operations of a batch and their results
+
+// Expression request: "X (1 + 2) * -3 / 4" evaluates an infix formula with the usual
+// precedence, parentheses and signs (see Expression.h); it may be an operation of a batch too.
+#define EXPRESSION_OPERATOR 'X' // First character of an expression request
+
+// Error codes of calculate(), reported per operation in the reply of a batch
+#define CALC_OK 0               // The result is valid
+#define CALC_DIVISION_BY_ZERO 1 // "|Error| -  Division by Zero"
+#define CALC_INVALID_OPERAND 2  // An operand is not a number
+#define CALC_UNKNOWN_OPERATOR 3 // The operator is not one of + - * /
+#define CALC_MISSING_OPERANDS 4 // Fewer than two operands
+#define CALC_REPLY_FULL 5       // The reply has no room left: this and the next operations were skipped
+#define CALC_TOO_MANY_OPERANDS 6 // More than MAXOPERANDS operands, or an expression too large
+#define CALC_SYNTAX_ERROR 7     // An expression is malformed
+#define CALC_INVALID_REGISTER 8 // A reference names no result kept by the session (see Registers.h)
+
+/**
+ * @brief Server execution modes selectable from the command line.
+ */
+enum ServerMode {
+    MODE_SINGLE,    // One datagram socket served by the main thread
+    MODE_REUSEPORT  // One thread per SO_REUSEPORT datagram socket (Linux only)
+};
+
+/**
+ * @brief Options read from the command line.
+ */
+struct ServerOptions {
+    enum ServerMode mode;   // Execution mode
+    int shards;             // Number of sockets and threads used by MODE_REUSEPORT
+    int pinThreads;         // 1 to pin every reuseport thread to its own CPU
+    int steering;           // 1 to steer datagrams to the socket of the receiving CPU
+    int logLevel;           // Highest LOG_LEVEL_ value written
+    int logSampling;        // Only 1 request in logSampling is logged
+    int precision;          // Decimals of the results, NUMBER_SHORTEST for the shortest exact digits
+    int logSegments;        // Number of rotating log segments, 0 for a single log file
+    int logSegmentSize;     // Size of a log segment in MiB
+    int cacheEntries;       // Replies kept by the result cache, 0 to disable it
+    int registerClients;    // Clients whose results are kept in registers, 0 to disable them
+    int registerTtl;        // Seconds after which the registers of a silent client are dropped
+};
 
 /**
  * @struct sockaddr_in
@@ -32,6 +88,14 @@ char msgLog[BUFFERSIZE]; // Message Log
  */
 struct sockaddr_in bindSocket(int my_socket, struct sockaddr_in sad, const char* server_addr, const int port_number);
 
+/**
+ * @brief Allows several sockets to bind the server address and port (SO_REUSEPORT).
+ *
+ * @param my_socket The socket descriptor, not bound yet.
+ * @return 0 on success, -1 if the option is not supported.
+ */
+int enableReusePort(int my_socket);
+
 /**
  * @brief Checks and initializes the Windows Socket API (WSA) for Windows systems.
  * This function is used for cross-platform compatibility.
@@ -59,12 +123,77 @@ int createSocket(int my_socket);
  */
 void errorhandler(char *errorMessage);
 
+/**
+ * @brief Parses the command line into the server options.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @param options The options to fill (a single socket by default).
+ */
+void parseOptions(int argc, char *argv[], struct ServerOptions *options);
+
+/**
+ * @brief Receives, processes and answers the datagrams arriving on a socket.
+ *
+ * @param my_socket The bound datagram socket.
+ * @return The exit status when the socket can no longer be used.
+ */
+int serveDatagrams(int my_socket);
+
+/**
+ * @brief Answers a binary, stream or linear datagram with the results of its operations.
+ *
+ * @param my_socket The socket descriptor.
+ * @param datagram The received datagram, header included.
+ * @param length The size of the datagram.
+ * @param cad The address of the client.
+ * @param client_len The size of the address of the client.
+ * @return 0 if the reply was sent, -1 otherwise.
+ */
+int serveBinary(int my_socket, const char *datagram, int length, struct sockaddr_in *cad, int client_len);
+
+/**
+ * @brief Applies an operator to the operands from left to right.
+ *
+ * @param operator The operator, one of + - * /.
+ * @param operands The operands.
+ * @param numOperands The number of operands.
+ * @param result Receives the result when the calculation succeeds.
+ * @return CALC_OK on success, otherwise the CALC_ error code.
+ */
+int calculate(char operator, const double *operands, int numOperands, double *result);
+
+struct Registers;
+
 /**
  * @brief Processes the input message, performs calculations, and updates the input string.
  *
- * @param msg The input message containing operator and operands.
+ * @param msg The input message containing operator and operands, in a buffer of
+ *            BUFFERSIZE bytes that receives the NUL-terminated reply.
+ * @param length The number of characters of the message.
+ * @param registers The registers of the client, NULL when the registers are disabled.
  */
-void processData(char *msg);
+void processData(char *msg, int length, struct Registers *registers);
+
+/**
+ * @brief Appends text to a reply, truncating it to BUFFERSIZE - 1 characters.
+ *
+ * @param reply The reply, a buffer of BUFFERSIZE bytes.
+ * @param length The length of the reply.
+ * @param text The text to append.
+ * @param textLength The length of the text.
+ * @return The new length of the reply, which stays terminated.
+ */
+int appendReply(char *reply, int length, const char *text, int textLength);
+
+/**
+ * @brief Evaluates a batch request and replaces it with the results of its operations.
+ *
+ * @param msg The batch request, starting with BATCH_OPERATOR.
+ * @param length The number of characters of the request.
+ * @param registers The registers of the client, NULL when the registers are disabled.
+ */
+void processBatch(char *msg, int length, struct Registers *registers);
 
 /**
  * @brief Closes the connection for the given socket.
@@ -74,7 +203,10 @@ void processData(char *msg);
 void closeConnection(int c_socket);
 
 /**
- * @brief Writes a log message to the log file.
+ * @brief Writes a log message to the log file (see Log.h).
+ *
+ * Safe to call from any thread; once openLog() has started the writer thread the
+ * message is queued and written in the background.
  *
  * @param message The log message to be written.
  */
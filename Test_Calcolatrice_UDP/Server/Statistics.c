@@ -0,0 +1,501 @@
+#include "Headers.h"
+#include "Server.h"
+#include "Vector.h"
+#include "Statistics.h"
+
+#include <math.h>       // INFINITY
+#if !defined WIN32
+#include <pthread.h>    // Threads of the large arrays
+#endif
+
+#if (defined __x86_64__ || defined __i386__) && defined __GNUC__
+#define STATISTICS_X86 1        // The SIMD kernels are compiled
+#include <immintrin.h>  // SSE2, AVX2 and AVX-512 intrinsics
+#endif
+
+/**
+ * @file Statistics.c
+ * @brief Implementation file for the reductions and the prefix sums of arrays of operands.
+ * @date October 16, 2026
+ * @author Francesco Conforti
+ *
+ * Every addition of a sum goes through the error-free transformation of Knuth's
+ * TwoSum, which needs no branch and so runs in every lane of a vector. A vector
+ * kernel keeps a summary per lane, two vectors of lanes to hide the latency of
+ * the additions, and merges them at the end with the formulas of Chan et al.
+ * A prefix sum is computed inside a vector with shifts and added to the running
+ * sum with TwoSum, so its error stays that of a few values.
+ */
+
+/**
+ * @brief The kernels of an instruction set.
+ */
+struct Kernels {
+    void (*reduce)(const double *values, int count, struct Statistics *result);
+    void (*scan)(const double *values, double *sums, int count, double *sum, double *error);
+};
+
+/**
+ * @brief The part of an array given to a thread.
+ */
+struct Part {
+    const double *values;           // First value of the part
+    double *sums;                   // Receives the prefix sums, NULL to summarize the part
+    int count;                      // Number of values of the part
+    double sum;                     // Sum of the values before the part, rounded
+    double error;                   // What the roundings of sum lost
+    struct Statistics statistics;   // Receives the summary of the part
+    const struct Kernels *kernel;   // Kernels of the instruction set in use
+};
+
+static int threadLimit = 0;     // Most threads, 0 for the processors up to STATISTICS_THREADS
+
+static const struct Kernels *getKernels(void);
+static int countParts(int count);
+static void runParts(struct Part *parts, int count);
+static void *runPart(void *argument);
+static void reduceScalar(const double *values, int count, struct Statistics *result);
+static void scanScalar(const double *values, double *sums, int count, double *sum, double *error);
+
+/**
+ * @brief Adds a value to a compensated sum.
+ *
+ * @param sum The sum, rounded.
+ * @param error What the roundings of the sum lost, receives what this addition loses too.
+ * @param value The value to add.
+ */
+static inline void addCompensated(double *sum, double *error, double value) {
+    double total = *sum + value;
+    double virtual = total - *sum;
+    *error += (*sum - (total - virtual)) + (value - virtual);
+    *sum = total;
+}
+
+#if defined STATISTICS_X86
+/**
+ * @brief Defines the reduction kernel of an instruction set.
+ *
+ * Every lane summarizes the values count / (2 * width) apart; the values left after
+ * the last pair of whole vectors are summarized one at a time.
+ */
+#define REDUCE_KERNEL(name, isa, width, type, set1, load, store, add, sub, mul, min, max) \
+    __attribute__((target(isa))) \
+    static void name(const double *values, int count, struct Statistics *result) { \
+        type sum[2], error[2], mean[2], squares[2], low[2], high[2]; \
+        int steps = count / (2 * (width)); \
+        for (int j = 0; j < 2; j++) { \
+            sum[j] = error[j] = mean[j] = squares[j] = set1(0.0); \
+            low[j] = set1(INFINITY); \
+            high[j] = set1(-INFINITY); \
+        } \
+        for (int k = 0; k < steps; k++) { \
+            type inverse = set1(1.0 / (double) (k + 1)); \
+            for (int j = 0; j < 2; j++) { \
+                type value = load(values + (2 * k + j) * (width)); \
+                type total = add(sum[j], value); \
+                type virtual = sub(total, sum[j]); \
+                error[j] = add(error[j], add(sub(sum[j], sub(total, virtual)), sub(value, virtual))); \
+                sum[j] = total; \
+                type delta = sub(value, mean[j]); \
+                mean[j] = add(mean[j], mul(delta, inverse)); \
+                squares[j] = add(squares[j], mul(delta, sub(value, mean[j]))); \
+                low[j] = min(value, low[j]); \
+                high[j] = max(value, high[j]); \
+            } \
+        } \
+        double lanes[6][2 * (width)]; \
+        for (int j = 0; j < 2; j++) { \
+            store(lanes[0] + j * (width), sum[j]); \
+            store(lanes[1] + j * (width), error[j]); \
+            store(lanes[2] + j * (width), mean[j]); \
+            store(lanes[3] + j * (width), squares[j]); \
+            store(lanes[4] + j * (width), low[j]); \
+            store(lanes[5] + j * (width), high[j]); \
+        } \
+        reduceScalar(values + steps * 2 * (width), count - steps * 2 * (width), result); \
+        for (int lane = 0; lane < 2 * (width) && steps > 0; lane++) { \
+            struct Statistics part = { steps, lanes[0][lane], lanes[1][lane], lanes[2][lane], \
+                                       lanes[3][lane], lanes[4][lane], lanes[5][lane] }; \
+            mergeStatistics(result, &part); \
+        } \
+    }
+
+/**
+ * @brief Defines the prefix sum kernel of an instruction set.
+ *
+ * prefix() sums every lane with the lanes before it, last() copies the last lane
+ * into every lane; the running sum and its error are kept in every lane.
+ */
+#define SCAN_KERNEL(name, isa, width, type, set1, load, store, add, sub, prefix, last) \
+    __attribute__((target(isa))) \
+    static void name(const double *values, double *sums, int count, double *sum, double *error) { \
+        type running = set1(*sum); \
+        type lost = set1(*error); \
+        int i = 0; \
+        for (; i + (width) <= count; i += (width)) { \
+            type local = prefix(load(values + i)); \
+            type total = add(running, local); \
+            type virtual = sub(total, running); \
+            type rounding = add(sub(running, sub(total, virtual)), sub(local, virtual)); \
+            store(sums + i, add(total, add(lost, rounding))); \
+            running = last(total); \
+            lost = add(lost, last(rounding)); \
+        } \
+        double lanes[width]; \
+        store(lanes, running); \
+        *sum = lanes[0]; \
+        store(lanes, lost); \
+        *error = lanes[0]; \
+        scanScalar(values + i, sums + i, count - i, sum, error); \
+    }
+
+/**
+ * @brief Sums the 2 lanes of an SSE2 vector with the lanes before them.
+ */
+__attribute__((target("sse2")))
+static inline __m128d prefixSse2(__m128d value) {
+    return _mm_add_pd(value, _mm_unpacklo_pd(_mm_setzero_pd(), value));
+}
+
+/**
+ * @brief Copies the last lane of an SSE2 vector into both lanes.
+ */
+__attribute__((target("sse2")))
+static inline __m128d lastSse2(__m128d value) {
+    return _mm_unpackhi_pd(value, value);
+}
+
+/**
+ * @brief Sums the 4 lanes of an AVX2 vector with the lanes before them.
+ */
+__attribute__((target("avx2")))
+static inline __m256d prefixAvx2(__m256d value) {
+    const __m256d zero = _mm256_setzero_pd();
+    value = _mm256_add_pd(value, _mm256_blend_pd(_mm256_permute4x64_pd(value, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+    return _mm256_add_pd(value, _mm256_blend_pd(_mm256_permute4x64_pd(value, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+}
+
+/**
+ * @brief Copies the last lane of an AVX2 vector into every lane.
+ */
+__attribute__((target("avx2")))
+static inline __m256d lastAvx2(__m256d value) {
+    return _mm256_permute4x64_pd(value, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/**
+ * @brief Shifts the lanes of an AVX-512 vector up, filling the first ones with zeros.
+ */
+#define SHIFT_AVX512(value, lanes) \
+    _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(value), _mm512_setzero_si512(), 8 - (lanes)))
+
+/**
+ * @brief Sums the 8 lanes of an AVX-512 vector with the lanes before them.
+ */
+__attribute__((target("avx512f")))
+static inline __m512d prefixAvx512(__m512d value) {
+    value = _mm512_add_pd(value, SHIFT_AVX512(value, 1));
+    value = _mm512_add_pd(value, SHIFT_AVX512(value, 2));
+    return _mm512_add_pd(value, SHIFT_AVX512(value, 4));
+}
+
+/**
+ * @brief Copies the last lane of an AVX-512 vector into every lane.
+ */
+__attribute__((target("avx512f")))
+static inline __m512d lastAvx512(__m512d value) {
+    return _mm512_permutexvar_pd(_mm512_set1_epi64(7), value);
+}
+
+REDUCE_KERNEL(reduceSse2, "sse2", 2, __m128d, _mm_set1_pd, _mm_loadu_pd, _mm_storeu_pd,
+              _mm_add_pd, _mm_sub_pd, _mm_mul_pd, _mm_min_pd, _mm_max_pd)
+REDUCE_KERNEL(reduceAvx2, "avx2", 4, __m256d, _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+              _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, _mm256_min_pd, _mm256_max_pd)
+REDUCE_KERNEL(reduceAvx512, "avx512f", 8, __m512d, _mm512_set1_pd, _mm512_loadu_pd, _mm512_storeu_pd,
+              _mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, _mm512_min_pd, _mm512_max_pd)
+SCAN_KERNEL(scanSse2, "sse2", 2, __m128d, _mm_set1_pd, _mm_loadu_pd, _mm_storeu_pd,
+            _mm_add_pd, _mm_sub_pd, prefixSse2, lastSse2)
+SCAN_KERNEL(scanAvx2, "avx2", 4, __m256d, _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+            _mm256_add_pd, _mm256_sub_pd, prefixAvx2, lastAvx2)
+SCAN_KERNEL(scanAvx512, "avx512f", 8, __m512d, _mm512_set1_pd, _mm512_loadu_pd, _mm512_storeu_pd,
+            _mm512_add_pd, _mm512_sub_pd, prefixAvx512, lastAvx512)
+#endif
+
+static const struct Kernels kernels[] = {
+    { reduceScalar, scanScalar },
+#if defined STATISTICS_X86
+    { reduceSse2, scanSse2 },
+    { reduceAvx2, scanAvx2 },
+    { reduceAvx512, scanAvx512 },
+#endif
+};
+
+/**
+ * @brief Empties a summary.
+ *
+ * @param statistics The summary.
+ */
+void initStatistics(struct Statistics *statistics) {
+    statistics->count = 0;
+    statistics->sum = 0;
+    statistics->error = 0;
+    statistics->mean = 0;
+    statistics->squares = 0;
+    statistics->min = INFINITY;
+    statistics->max = -INFINITY;
+}
+
+/**
+ * @brief Folds an array of values into a summary.
+ *
+ * @param statistics The summary.
+ * @param values The values.
+ * @param count The number of values.
+ */
+void foldStatistics(struct Statistics *statistics, const double *values, int count) {
+    struct Part parts[STATISTICS_THREADS];
+    int partCount = countParts(count);
+
+    for (int i = 0; i < partCount; i++) {
+        int first = (int) ((long long) count * i / partCount);
+        parts[i].values = values + first;
+        parts[i].sums = NULL;
+        parts[i].count = (int) ((long long) count * (i + 1) / partCount) - first;
+        parts[i].kernel = getKernels();
+    }
+    runParts(parts, partCount);
+    for (int i = 0; i < partCount; i++) {
+        mergeStatistics(statistics, &parts[i].statistics);
+    }
+}
+
+/**
+ * @brief Folds a summary into another one, as if its values were folded.
+ *
+ * The mean and the squares are combined with the formulas of Chan, Golub and
+ * LeVeque, which Welford's update is the case of a single value of.
+ *
+ * @param statistics The summary receiving the values.
+ * @param other The summary of the other values.
+ */
+void mergeStatistics(struct Statistics *statistics, const struct Statistics *other) {
+    if (other->count == 0) {
+        return;
+    }
+    if (statistics->count == 0) {
+        *statistics = *other;
+        return;
+    }
+
+    double count = (double) (statistics->count + other->count);
+    double delta = other->mean - statistics->mean;
+    statistics->mean += delta * ((double) other->count / count);
+    statistics->squares += other->squares
+                           + delta * delta * ((double) statistics->count * (double) other->count / count);
+    addCompensated(&statistics->sum, &statistics->error, other->sum);
+    statistics->error += other->error;
+    statistics->min = other->min < statistics->min ? other->min : statistics->min;
+    statistics->max = other->max > statistics->max ? other->max : statistics->max;
+    statistics->count += other->count;
+}
+
+/**
+ * @brief Folds an array of values into a summary, writing the sum after every value.
+ *
+ * A large array is scanned in two passes: the threads summarize their parts, then
+ * each one scans its part from the sum of the parts before it.
+ *
+ * @param statistics The summary.
+ * @param values The values.
+ * @param sums Receives the sum of all the values folded up to every value, may be values.
+ * @param count The number of values.
+ */
+void scanStatistics(struct Statistics *statistics, const double *values, double *sums, int count) {
+    struct Part parts[STATISTICS_THREADS];
+    int partCount = countParts(count);
+
+    for (int i = 0; i < partCount; i++) {
+        int first = (int) ((long long) count * i / partCount);
+        parts[i].values = values + first;
+        parts[i].sums = NULL;
+        parts[i].count = (int) ((long long) count * (i + 1) / partCount) - first;
+        parts[i].kernel = getKernels();
+    }
+    runParts(parts, partCount);
+
+    for (int i = 0; i < partCount; i++) {
+        parts[i].sums = sums + (parts[i].values - values);
+        parts[i].sum = statistics->sum;
+        parts[i].error = statistics->error;
+        mergeStatistics(statistics, &parts[i].statistics);
+    }
+    runParts(parts, partCount);
+}
+
+/**
+ * @brief Returns the compensated sum of a summary.
+ *
+ * @param statistics The summary.
+ * @return The sum of the values.
+ */
+double getStatisticsSum(const struct Statistics *statistics) {
+    return statistics->sum + statistics->error;
+}
+
+/**
+ * @brief Returns the mean of a summary.
+ *
+ * The running mean of Welford's update drifts by a rounding of the mean at every
+ * value, the compensated sum only by a few in all.
+ *
+ * @param statistics The summary.
+ * @return The compensated sum divided by the count, 0 without values.
+ */
+double getStatisticsMean(const struct Statistics *statistics) {
+    return statistics->count > 0 ? getStatisticsSum(statistics) / (double) statistics->count : 0;
+}
+
+/**
+ * @brief Returns the population variance of a summary.
+ *
+ * @param statistics The summary.
+ * @return The mean of the squared distances of the values from their mean, 0 without values.
+ */
+double getStatisticsVariance(const struct Statistics *statistics) {
+    return statistics->count > 0 ? statistics->squares / (double) statistics->count : 0;
+}
+
+/**
+ * @brief Limits the threads the kernels split an array among, to compare them.
+ *
+ * @param threads The most threads, 1 to fold every array in the calling thread,
+ *                0 for the processors of the machine up to STATISTICS_THREADS.
+ * @return The previous limit.
+ */
+int setStatisticsThreads(int threads) {
+    int previous = threadLimit;
+    threadLimit = threads < 0 ? 0 : threads > STATISTICS_THREADS ? STATISTICS_THREADS : threads;
+    return previous;
+}
+
+/**
+ * @brief Returns the kernels of the instruction set in use.
+ *
+ * @return The kernels.
+ */
+static const struct Kernels *getKernels(void) {
+    return &kernels[getVectorLevel()];
+}
+
+/**
+ * @brief Decides among how many threads an array is split.
+ *
+ * @param count The number of values of the array.
+ * @return The number of parts, 1 for the calling thread alone.
+ */
+static int countParts(int count) {
+    int threads = threadLimit;
+    if (threads == 0) {
+#if defined __linux__
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#elif defined WIN32
+        threads = 1; // The parts would all run in the calling thread
+#else
+        threads = STATISTICS_THREADS;
+#endif
+    }
+    if (threads > STATISTICS_THREADS) {
+        threads = STATISTICS_THREADS;
+    }
+    if (threads > count / STATISTICS_PARALLEL) {
+        threads = count / STATISTICS_PARALLEL;
+    }
+    return threads > 1 ? threads : 1;
+}
+
+/**
+ * @brief Runs every part, the first in the calling thread and the others in threads of their own.
+ *
+ * A part whose thread cannot be created is run by the calling thread; without
+ * POSIX threads (Windows) every part is.
+ *
+ * @param parts The parts.
+ * @param count The number of parts.
+ */
+static void runParts(struct Part *parts, int count) {
+#if defined WIN32
+    for (int i = 0; i < count; i++) {
+        runPart(&parts[i]);
+    }
+#else
+    pthread_t threads[STATISTICS_THREADS];
+    int started[STATISTICS_THREADS];
+
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, runPart, &parts[i]) == 0;
+    }
+    runPart(&parts[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            runPart(&parts[i]);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Summarizes or scans a part of an array.
+ *
+ * @param argument The struct Part.
+ * @return NULL.
+ */
+static void *runPart(void *argument) {
+    struct Part *part = argument;
+
+    if (part->sums == NULL) {
+        initStatistics(&part->statistics);
+        part->kernel->reduce(part->values, part->count, &part->statistics);
+    } else {
+        part->kernel->scan(part->values, part->sums, part->count, &part->sum, &part->error);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Summarizes an array one value at a time with Welford's update.
+ *
+ * @param values The values.
+ * @param count The number of values.
+ * @param result Receives the summary.
+ */
+static void reduceScalar(const double *values, int count, struct Statistics *result) {
+    initStatistics(result);
+    for (int i = 0; i < count; i++) {
+        double value = values[i];
+        addCompensated(&result->sum, &result->error, value);
+        double delta = value - result->mean;
+        result->mean += delta / (double) (i + 1);
+        result->squares += delta * (value - result->mean);
+        result->min = value < result->min ? value : result->min;
+        result->max = value > result->max ? value : result->max;
+    }
+    result->count = count;
+}
+
+/**
+ * @brief Writes the prefix sums of an array one value at a time.
+ *
+ * @param values The values.
+ * @param sums Receives the prefix sums.
+ * @param count The number of values.
+ * @param sum The sum before the first value, receives the sum after the last one.
+ * @param error What the roundings of the sum lost, updated like the sum.
+ */
+static void scanScalar(const double *values, double *sums, int count, double *sum, double *error) {
+    for (int i = 0; i < count; i++) {
+        addCompensated(sum, error, values[i]);
+        sums[i] = *sum + *error;
+    }
+}